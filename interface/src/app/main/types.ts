@@ -2,6 +2,7 @@ export interface Settings {
   locale: string;
   tx_mode: number;
   ems_bus_id: number;
+  fetch_budget: number;
   syslog_enabled: boolean;
   syslog_level: number;
   syslog_mark_interval: number;
@@ -42,6 +43,7 @@ export interface Settings {
   modbus_port: number;
   modbus_max_clients: number;
   modbus_timeout: number;
+  modbus_strict: boolean;
 }
 
 export enum busConnectionStatus {
@@ -115,6 +115,10 @@ export const GPIO_VALIDATORS3 = {
 
 export const createSettingsValidator = (settings: Settings) =>
   new Schema({
+    fetch_budget: [
+      { required: true, message: 'Fetches per minute is required' },
+      { type: 'number', min: 0, max: 120, message: 'Must be between 0 and 120' }
+    ],
     ...(settings.board_profile === 'CUSTOM' &&
       settings.platform === 'ESP32' && {
         led_gpio: [
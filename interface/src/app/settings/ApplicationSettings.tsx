@@ -252,6 +252,18 @@ const ApplicationSettings = () => {
             </Grid>
           </Grid>
         )}
+        {data.modbus_enabled && (
+          <BlockFormControlLabel
+            control={
+              <Checkbox
+                checked={data.modbus_strict}
+                onChange={updateFormValue}
+                name="modbus_strict"
+              />
+            }
+            label={LL.MODBUS_STRICT()}
+          />
+        )}
         <Typography color="secondary">Syslog</Typography>
         <BlockFormControlLabel
           control={
@@ -649,6 +661,18 @@ const ApplicationSettings = () => {
               <MenuItem value={0x4d}>Gateway 7 (0x4D)</MenuItem>
             </TextField>
           </Grid>
+          <Grid>
+            <ValidatedTextField
+              fieldErrors={fieldErrors}
+              name="fetch_budget"
+              label={LL.FETCH_BUDGET()}
+              variant="outlined"
+              value={numberValue(data.fetch_budget)}
+              type="number"
+              onChange={updateFormValue}
+              margin="normal"
+            />
+          </Grid>
         </Grid>
         <BlockFormControlLabel
           control={
@@ -282,6 +282,20 @@ const MqttSettings = () => {
                 />
               </Grid>
             )}
+            {!data.publish_single && (
+              <Grid>
+                <BlockFormControlLabel
+                  control={
+                    <Checkbox
+                      name="publish_changes"
+                      checked={data.publish_changes}
+                      onChange={updateFormValue}
+                    />
+                  }
+                  label={LL.MQTT_PUBLISH_TEXT_6()}
+                />
+              </Grid>
+            )}
           </Grid>
         )}
         {!data.publish_single && (
@@ -325,6 +339,18 @@ const MqttSettings = () => {
                     margin="normal"
                   />
                 </Grid>
+                <Grid>
+                  <ValidatedTextField
+                    fieldErrors={fieldErrors}
+                    name="discovery_budget"
+                    label={LL.MQTT_PUBLISH_TEXT_7()}
+                    variant="outlined"
+                    value={numberValue(data.discovery_budget)}
+                    type="number"
+                    onChange={updateFormValue}
+                    margin="normal"
+                  />
+                </Grid>
                 <Grid>
                   <TextField
                     name="entity_format"
@@ -220,6 +220,8 @@ const cz: Translation = {
   MQTT_PUBLISH_TEXT_3: 'Povolit MQTT Discovery',
   MQTT_PUBLISH_TEXT_4: 'Prefix pro Discovery témata',
   MQTT_PUBLISH_TEXT_5: 'Typ Discovery',
+  MQTT_PUBLISH_TEXT_6: 'Publish only changed values', // TODO translate
+  MQTT_PUBLISH_TEXT_7: 'Discovery configs per loop', // TODO translate
   MQTT_PUBLISH_INTERVALS: 'Intervaly publikování',
   MQTT_INT_BOILER: 'Kotly a tepelná čerpadla',
   MQTT_INT_THERMOSTATS: 'Termostaty',
@@ -327,6 +329,8 @@ const cz: Translation = {
   MODULES_NONE: 'Nenalezeny žádné externí moduly',
   RENAME: 'Přejmenovat',
   ENABLE_MODBUS: 'Povolit Modbus',
+  MODBUS_STRICT: 'Reject register reads with unmapped or unreadable registers', // TODO translate
+  FETCH_BUDGET: 'Max. fetches per minute', // TODO translate
   VIEW_LOG: 'Zobrazit záznam pro diagnostiku problémů',
   UPLOAD_DRAG: 'přetáhněte soubor sem nebo klikněte pro výběr',
   SERVICES: 'Služby',
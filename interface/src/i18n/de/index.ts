@@ -220,6 +220,8 @@ const de: Translation = {
   MQTT_PUBLISH_TEXT_3: 'Aktiviere `MQTT Discovery`',
   MQTT_PUBLISH_TEXT_4: 'Prefix für die `Discovery`-Topics',
   MQTT_PUBLISH_TEXT_5: 'Discovery Typ',
+  MQTT_PUBLISH_TEXT_6: 'Publish only changed values', // TODO translate
+  MQTT_PUBLISH_TEXT_7: 'Discovery configs per loop', // TODO translate
   MQTT_PUBLISH_INTERVALS: 'Veröffentlichungs-Intervalle',
   MQTT_INT_BOILER: 'Boiler und Wärmepumpen',
   MQTT_INT_THERMOSTATS: 'Thermostate',
@@ -327,6 +329,8 @@ const de: Translation = {
   MODULES_NONE: 'Keine externen Module erkannt',
   RENAME: 'Umbenennen',
   ENABLE_MODBUS: 'Modbus aktivieren',
+  MODBUS_STRICT: 'Reject register reads with unmapped or unreadable registers', // TODO translate
+  FETCH_BUDGET: 'Max. fetches per minute', // TODO translate
   VIEW_LOG: 'Sehen Sie sich das Protokoll an, um Probleme zu diagnostizieren.',
   UPLOAD_DRAG: 'Ziehen Sie eine Datei hierher oder klicken Sie, um eine auszuwählen.',
   SERVICES: 'Dienste',
@@ -220,6 +220,8 @@ const en: Translation = {
   MQTT_PUBLISH_TEXT_3: 'Enable MQTT Discovery',
   MQTT_PUBLISH_TEXT_4: 'Prefix for the Discovery topics',
   MQTT_PUBLISH_TEXT_5: 'Discovery type',
+  MQTT_PUBLISH_TEXT_6: 'Publish only changed values',
+  MQTT_PUBLISH_TEXT_7: 'Discovery configs per loop',
   MQTT_PUBLISH_INTERVALS: 'Publish Intervals',
   MQTT_INT_BOILER: 'Boilers and Heat Pumps',
   MQTT_INT_THERMOSTATS: 'Thermostats',
@@ -327,6 +329,8 @@ const en: Translation = {
   MODULES_NONE: 'No external modules detected',
   RENAME: 'Rename',
   ENABLE_MODBUS: 'Enable Modbus',
+  MODBUS_STRICT: 'Reject register reads with unmapped or unreadable registers',
+  FETCH_BUDGET: 'Max. fetches per minute',
   VIEW_LOG: 'View log to diagnose issues',
   UPLOAD_DRAG: 'drag and drop a file here or click to select one',
   SERVICES: 'Services',
@@ -220,6 +220,8 @@ const fr: Translation = {
   MQTT_PUBLISH_TEXT_3: 'Activer la découverte MQTT',
   MQTT_PUBLISH_TEXT_4: 'Préfixe pour les topics découverte',
   MQTT_PUBLISH_TEXT_5: 'Discovery type', // TODO translate
+  MQTT_PUBLISH_TEXT_6: 'Publish only changed values', // TODO translate
+  MQTT_PUBLISH_TEXT_7: 'Discovery configs per loop', // TODO translate
   MQTT_PUBLISH_INTERVALS: 'Intervalles de publication',
   MQTT_INT_BOILER: 'Chaudières et pompes à chaleur',
   MQTT_INT_THERMOSTATS: 'Thermostats',
@@ -327,6 +329,8 @@ const fr: Translation = {
   MODULES_NONE: 'No external modules detected', // TODO translate
   RENAME: 'Rename', // TODO translate
   ENABLE_MODBUS: 'Activer Modbus',
+  MODBUS_STRICT: 'Reject register reads with unmapped or unreadable registers', // TODO translate
+  FETCH_BUDGET: 'Max. fetches per minute', // TODO translate
   VIEW_LOG: 'View log to diagnose issues', // TODO translate
   UPLOAD_DRAG: 'drag and drop a file here or click to select one', // TODO translate
   SERVICES: 'Services', // TODO translate
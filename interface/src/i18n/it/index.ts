@@ -220,6 +220,8 @@ const it: Translation = {
   MQTT_PUBLISH_TEXT_3: 'Abilita rilevamento MQTT (Home Assistant, Domoticz)',
   MQTT_PUBLISH_TEXT_4: 'Prefisso per gli argomenti di scoperta',
   MQTT_PUBLISH_TEXT_5: 'Discovery type',
+  MQTT_PUBLISH_TEXT_6: 'Publish only changed values', // TODO translate
+  MQTT_PUBLISH_TEXT_7: 'Discovery configs per loop', // TODO translate
   MQTT_PUBLISH_INTERVALS: 'Pubblica intervalli',
   MQTT_INT_BOILER: 'Caldaie e Pompe di Calore',
   MQTT_INT_THERMOSTATS: 'Termostati',
@@ -327,6 +329,8 @@ const it: Translation = {
   MODULES_NONE: 'No external modules detected', // TODO translate
   RENAME: 'Rename', // TODO translate  
   ENABLE_MODBUS: 'Abilita Modbus',
+  MODBUS_STRICT: 'Reject register reads with unmapped or unreadable registers', // TODO translate
+  FETCH_BUDGET: 'Max. fetches per minute', // TODO translate
   VIEW_LOG: 'View log to diagnose issues', // TODO translate
   UPLOAD_DRAG: 'drag and drop a file here or click to select one', // TODO translate
   SERVICES: 'Services', // TODO translate
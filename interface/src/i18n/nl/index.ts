@@ -220,6 +220,8 @@ const nl: Translation = {
   MQTT_PUBLISH_TEXT_3: 'Activeer MQTT Discovery',
   MQTT_PUBLISH_TEXT_4: 'Prefix voor de Discovery topics',
   MQTT_PUBLISH_TEXT_5: 'Discovery type',
+  MQTT_PUBLISH_TEXT_6: 'Publish only changed values', // TODO translate
+  MQTT_PUBLISH_TEXT_7: 'Discovery configs per loop', // TODO translate
   MQTT_PUBLISH_INTERVALS: 'Publicatie intervallen',
   MQTT_INT_BOILER: 'CV ketels en warmtepompen',
   MQTT_INT_THERMOSTATS: 'Thermostaten',
@@ -327,6 +329,8 @@ const nl: Translation = {
   MODULES_NONE: 'Geen externe modules gedetecteerd',
   RENAME: 'Hernoemen',
   ENABLE_MODBUS: 'Activeer Modbus',
+  MODBUS_STRICT: 'Reject register reads with unmapped or unreadable registers', // TODO translate
+  FETCH_BUDGET: 'Max. fetches per minute', // TODO translate
   VIEW_LOG: 'View log to diagnose issues', // TODO translate
   UPLOAD_DRAG: 'drag and drop a file here or click to select one', // TODO translate
   SERVICES: 'Services', // TODO translate
@@ -220,6 +220,8 @@ const sk: Translation = {
   MQTT_PUBLISH_TEXT_3: 'Povolenie zisťovania MQTT',
   MQTT_PUBLISH_TEXT_4: 'Predpona tém Discovery',
   MQTT_PUBLISH_TEXT_5: 'Typ zistenia',
+  MQTT_PUBLISH_TEXT_6: 'Publish only changed values', // TODO translate
+  MQTT_PUBLISH_TEXT_7: 'Discovery configs per loop', // TODO translate
   MQTT_PUBLISH_INTERVALS: 'Intervaly zverejňovania',
   MQTT_INT_BOILER: 'Kotly a tepelné čerpadlá',
   MQTT_INT_THERMOSTATS: 'Termostaty',
@@ -327,6 +329,8 @@ const sk: Translation = {
   MODULES_NONE: 'Neboli zistené žiadne externé moduly',
   RENAME: 'Premenovať', 
   ENABLE_MODBUS: 'Povoliť Modbus',
+  MODBUS_STRICT: 'Reject register reads with unmapped or unreadable registers', // TODO translate
+  FETCH_BUDGET: 'Max. fetches per minute', // TODO translate
   VIEW_LOG: 'Zobrazte log na diagnostiku problémov',
   UPLOAD_DRAG: 'presuňte sem súbor alebo ho kliknutím vyberte',
   SERVICES: 'Služby',
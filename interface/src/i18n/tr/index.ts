@@ -220,6 +220,8 @@ const tr: Translation = {
   MQTT_PUBLISH_TEXT_3: 'MQTT keşfi etkinleştir (Home Assistant, Domoticz)',
   MQTT_PUBLISH_TEXT_4: 'Keşif konuları için ön ek',
   MQTT_PUBLISH_TEXT_5: 'Domoticz Format',
+  MQTT_PUBLISH_TEXT_6: 'Publish only changed values', // TODO translate
+  MQTT_PUBLISH_TEXT_7: 'Discovery configs per loop', // TODO translate
   MQTT_PUBLISH_INTERVALS: 'Yayınlama aralıkları',
   MQTT_INT_BOILER: 'Kazanlar ve Isı Pompaları',
   MQTT_INT_THERMOSTATS: 'Termostatlar',
@@ -327,6 +329,8 @@ const tr: Translation = {
   MODULES_NONE: 'No external modules detected', // TODO translate
   RENAME: 'Rename', // TODO translate 
   ENABLE_MODBUS: 'Enable Modbus', // TODO translate
+  MODBUS_STRICT: 'Reject register reads with unmapped or unreadable registers', // TODO translate
+  FETCH_BUDGET: 'Max. fetches per minute', // TODO translate
   VIEW_LOG: 'View log to diagnose issues', // TODO translate
   UPLOAD_DRAG: 'drag and drop a file here or click to select one', // TODO translate
   SERVICES: 'Services', // TODO translate
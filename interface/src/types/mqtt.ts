@@ -47,6 +47,8 @@ export interface MqttSettingsType {
   send_response: boolean;
   publish_single: boolean;
   publish_single2cmd: boolean;
+  publish_changes: boolean;
   discovery_prefix: string;
   discovery_type: number;
+  discovery_budget: number;
 }
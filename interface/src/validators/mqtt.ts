@@ -33,5 +33,17 @@ export const createMqttSettingsValidator = (mqttSettings: MqttSettingsType) =>
           message: 'Heartbeat must be between 10 and 86400'
         }
       ]
-    })
+    }),
+    ...(mqttSettings.enabled &&
+      mqttSettings.ha_enabled && {
+        discovery_budget: [
+          { required: true, message: 'Discovery configs per loop is required' },
+          {
+            type: 'number',
+            min: 1,
+            max: 100,
+            message: 'Discovery configs per loop must be between 1 and 100'
+          }
+        ]
+      })
   });
@@ -124,6 +124,7 @@ class AsyncEventSource: public AsyncWebHandler {
     void send(const char *message, const char *event=NULL, uint32_t id=0, uint32_t reconnect=0);
     size_t count() const; //number clinets connected
     size_t  avgPacketsWaiting() const;
+    const LinkedList<AsyncEventSourceClient *> & clients() const { return _clients; } // added for EMS-ESP
 
     //system callbacks (do not call)
     void _addClient(AsyncEventSourceClient * client);
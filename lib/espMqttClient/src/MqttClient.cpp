@@ -48,6 +48,7 @@ MqttClient::MqttClient(espMqttClientTypes::UseInternalTask useInternalTask, uint
 , _rxBuffer{0}
 , _outbox()
 , _bytesSent(0)
+, _queueLimit(0)
 , _parser()
 , _lastClientActivity(0)
 , _lastServerActivity(0)
@@ -149,6 +150,10 @@ uint16_t MqttClient::publish(const char* topic, uint8_t qos, bool retain, const
     return 0;
   }
   EMC_SEMAPHORE_TAKE();
+  if (!_queueHasSpace(topic, length)) {
+    EMC_SEMAPHORE_GIVE();
+    return 0;
+  }
   uint16_t packetId = (qos > 0) ? _getNextPacketId() : 1;
   if (!_addPacket(packetId, topic, payload, length, qos, retain)) {
     emc_log_e("Could not create PUBLISH packet");
@@ -175,6 +180,10 @@ uint16_t MqttClient::publish(const char* topic, uint8_t qos, bool retain, espMqt
     return 0;
   }
   EMC_SEMAPHORE_TAKE();
+  if (!_queueHasSpace(topic, length)) {
+    EMC_SEMAPHORE_GIVE();
+    return 0;
+  }
   uint16_t packetId = (qos > 0) ? _getNextPacketId() : 1;
   if (!_addPacket(packetId, topic, callback, length, qos, retain)) {
     emc_log_e("Could not create PUBLISH packet");
@@ -187,6 +196,31 @@ uint16_t MqttClient::publish(const char* topic, uint8_t qos, bool retain, espMqt
   return packetId;
 }
 
+uint16_t MqttClient::publish(const char* topic, uint8_t qos, bool retain, espMqttClientTypes::PayloadWriter writer, size_t length) {
+  #if !EMC_ALLOW_NOT_CONNECTED_PUBLISH
+  if (_state != State::connected) {
+  #else
+  if (_state > State::connected) {
+  #endif
+    return 0;
+  }
+  EMC_SEMAPHORE_TAKE();
+  if (!_queueHasSpace(topic, length)) {
+    EMC_SEMAPHORE_GIVE();
+    return 0;
+  }
+  uint16_t packetId = (qos > 0) ? _getNextPacketId() : 1;
+  if (!_addPacket(packetId, topic, writer, length, qos, retain)) {
+    emc_log_e("Could not create PUBLISH packet");
+    EMC_SEMAPHORE_GIVE();
+    _onError(packetId, Error::OUT_OF_MEMORY);
+    EMC_SEMAPHORE_TAKE();
+    packetId = 0;
+  }
+  EMC_SEMAPHORE_GIVE();
+  return packetId;
+}
+
 void MqttClient::clearQueue(bool deleteSessionData) {
   EMC_SEMAPHORE_TAKE();
   _clearQueue(deleteSessionData ? 2 : 0);
@@ -205,6 +239,45 @@ size_t MqttClient::queueSize() {
   return ret;
 }
 
+size_t MqttClient::queueBytes() {
+  size_t ret = 0;
+  EMC_SEMAPHORE_TAKE();
+  ret = _outbox.bytes();
+  EMC_SEMAPHORE_GIVE();
+  return ret;
+}
+
+void MqttClient::setQueueLimit(size_t bytes) {
+  _queueLimit = bytes;
+}
+
+size_t MqttClient::queueLimit() const {
+  return _queueLimit;
+}
+
+void MqttClient::forEachQueuedPublish(std::function<void(const char* topic, size_t topicLength, size_t size)> cb) {
+  EMC_SEMAPHORE_TAKE();
+  espMqttClientInternals::Outbox<OutgoingPacket>::Iterator it = _outbox.front();
+  while (it) {
+    size_t topicLength = 0;
+    const char* topic = it.get()->packet.topic(topicLength);
+    if (topic) cb(topic, topicLength, it.get()->packet.size());
+    ++it;
+  }
+  EMC_SEMAPHORE_GIVE();
+}
+
+// a publish with the topic and payload length must fit in the queue limit, the control packets are never limited
+bool MqttClient::_queueHasSpace(const char* topic, size_t length) {
+  if (!_queueLimit) return true;
+  size_t packetSize = 1 + 4 + 2 + strlen(topic) + 2 + length;  // max size of the header and remaining length, topic, packet ID
+  if (_outbox.bytes() + packetSize > _queueLimit) {
+    emc_log_w("Queue limit reached (%zu + %zu bytes)", _outbox.bytes(), packetSize);
+    return false;
+  }
+  return true;
+}
+
 void MqttClient::loop() {
   switch (_state) {
     case State::disconnected:
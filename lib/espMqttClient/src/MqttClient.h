@@ -65,9 +65,16 @@ class MqttClient {
   uint16_t publish(const char* topic, uint8_t qos, bool retain, const uint8_t* payload, size_t length);
   uint16_t publish(const char* topic, uint8_t qos, bool retain, const char* payload);
   uint16_t publish(const char* topic, uint8_t qos, bool retain, espMqttClientTypes::PayloadCallback callback, size_t length);
+  uint16_t publish(const char* topic, uint8_t qos, bool retain, espMqttClientTypes::PayloadWriter writer, size_t length);
   void clearQueue(bool deleteSessionData = false);  // Not MQTT compliant and may cause unpredictable results when `deleteSessionData` = true!
   const char* getClientId() const;
   size_t queueSize();  // No const because of mutex
+  size_t queueBytes();  // No const because of mutex
+  // limit the bytes in the outbox, a publish that doesn't fit is refused. 0 is no limit
+  void setQueueLimit(size_t bytes);
+  size_t queueLimit() const;
+  // call cb with the topic (not terminated) and the size of each publish in the outbox
+  void forEachQueuedPublish(std::function<void(const char* topic, size_t topicLength, size_t size)> cb);
   void loop();
 
  protected:
@@ -137,9 +144,13 @@ class MqttClient {
     OutgoingPacket(uint32_t t, espMqttClientTypes::Error& error, Args&&... args) :  // NOLINT(runtime/references)
       timeSent(t),
       packet(error, std::forward<Args>(args) ...) {}
+    size_t size() const {
+      return packet.size();
+    }
   };
   espMqttClientInternals::Outbox<OutgoingPacket> _outbox;
   size_t _bytesSent;
+  size_t _queueLimit;
   espMqttClientInternals::Parser _parser;
   uint32_t _lastClientActivity;
   uint32_t _lastServerActivity;
@@ -147,6 +158,7 @@ class MqttClient {
   espMqttClientTypes::DisconnectReason _disconnectReason;
 
   uint16_t _getNextPacketId();
+  bool _queueHasSpace(const char* topic, size_t length);
 
   template <typename... Args>
   bool _addPacket(Args&&... args) {
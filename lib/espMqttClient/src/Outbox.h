@@ -24,6 +24,7 @@ namespace espMqttClientInternals {
  * 
  * Queue items can only be emplaced, at front and back of the queue.
  * Remove items using an iterator or the builtin iterator.
+ * The number of items and the sum of their size() are kept up to date.
  */
 
 template <typename T>
@@ -34,6 +35,8 @@ class Outbox {
   , _last(nullptr)
   , _current(nullptr)
   , _prev(nullptr)
+  , _count(0)
+  , _bytes(0)
   #if EMC_USE_MEMPOOL
   , _memPool()
   #endif
@@ -103,6 +106,8 @@ class Outbox {
     Node* node = new(std::nothrow) Node(std::forward<Args>(args) ...);
     #endif
     if (node != nullptr) {
+      _count++;
+      _bytes += node->data.size();
       if (!_first) {
         // queue is empty
         _first = _current = node;
@@ -135,6 +140,8 @@ class Outbox {
     Node* node = new(std::nothrow) Node(std::forward<Args>(args) ...);
     #endif
     if (node != nullptr) {
+      _count++;
+      _bytes += node->data.size();
       if (!_first) {
         // queue is empty
         _last = node;
@@ -194,13 +201,12 @@ class Outbox {
   }
 
   size_t size() const {
-    Node* n = _first;
-    size_t count = 0;
-    while (n) {
-      n = n->next;
-      ++count;
-    }
-    return count;
+    return _count;
+  }
+
+  // sum of the size() of all items
+  size_t bytes() const {
+    return _bytes;
   }
 
  private:
@@ -208,6 +214,8 @@ class Outbox {
   Node* _last;
   Node* _current;
   Node* _prev;  // element just before _current
+  size_t _count;
+  size_t _bytes;
   #if EMC_USE_MEMPOOL
   MemoryPool::Fixed<EMC_NUM_POOL_ELEMENTS, sizeof(Node)> _memPool;
   #endif
@@ -242,6 +250,9 @@ class Outbox {
       prev->next = node->next;
     }
 
+    _count--;
+    _bytes -= node->data.size();
+
     // finally, delete the node
       #if EMC_USE_MEMPOOL
       node->~Node();
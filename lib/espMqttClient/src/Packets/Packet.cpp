@@ -57,6 +57,16 @@ MQTTPacketType Packet::packetType() const {
   return static_cast<MQTTPacketType>(0);
 }
 
+// topic of a PUBLISH packet, not terminated, nullptr for other packets
+const char* Packet::topic(size_t& length) const {
+  if (packetType() != PacketType.PUBLISH) return nullptr;
+  size_t index = 1;
+  while (index < 5 && (_data[index] & 0x80)) ++index;  // skip the remaining length
+  ++index;
+  length = (_data[index] << 8) | _data[index + 1];
+  return reinterpret_cast<const char*>(&_data[index + 2]);
+}
+
 bool Packet::removable() const {
   if (_packetId == 0) return true;
   if ((packetType() == PacketType.PUBACK) || (packetType() == PacketType.PUBCOMP)) return true;
@@ -239,6 +249,43 @@ Packet::Packet(espMqttClientTypes::Error& error,
   error = espMqttClientTypes::Error::SUCCESS;
 }
 
+Packet::Packet(espMqttClientTypes::Error& error,
+               uint16_t packetId,
+               const char* topic,
+               espMqttClientTypes::PayloadWriter payloadWriter,
+               size_t payloadLength,
+               uint8_t qos,
+               bool retain)
+: _packetId(packetId)
+, _data(nullptr)
+, _size(0)
+, _payloadIndex(0)
+, _payloadStartIndex(0)
+, _payloadEndIndex(0)
+, _getPayload(nullptr) {
+  size_t remainingLength =
+    2 + strlen(topic) +  // topic length + topic
+    2 +                  // packet ID
+    payloadLength;
+
+  if (qos == 0) {
+    remainingLength -= 2;
+    _packetId = 0;
+  }
+
+  if (!_allocate(remainingLength, true)) {
+    error = espMqttClientTypes::Error::OUT_OF_MEMORY;
+    return;
+  }
+
+  size_t pos = _fillPublishHeader(packetId, topic, remainingLength, qos, retain);
+
+  // PAYLOAD, written straight into the packet buffer
+  payloadWriter(&_data[pos], payloadLength);
+
+  error = espMqttClientTypes::Error::SUCCESS;
+}
+
 Packet::Packet(espMqttClientTypes::Error& error, uint16_t packetId, const char* topic, uint8_t qos)
 : _packetId(packetId)
 , _data(nullptr)
@@ -35,6 +35,7 @@ class Packet {
   void setDup();
   uint16_t packetId() const;
   MQTTPacketType packetType() const;
+  const char* topic(size_t& length) const;  // NOLINT(runtime/references)
   bool removable() const;
 
  protected:
@@ -81,6 +82,13 @@ class Packet {
          size_t payloadLength,
          uint8_t qos,
          bool retain);
+  Packet(espMqttClientTypes::Error& error,  // NOLINT(runtime/references)
+         uint16_t packetId,
+         const char* topic,
+         espMqttClientTypes::PayloadWriter payloadWriter,
+         size_t payloadLength,
+         uint8_t qos,
+         bool retain);
   // SUBSCRIBE
   Packet(espMqttClientTypes::Error& error,  // NOLINT(runtime/references)
          uint16_t packetId,
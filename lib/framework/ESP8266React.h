@@ -61,6 +61,14 @@ class ESP8266React {
         _mqttSettingsService.setWill(will_topic);
     }
 
+    // statistics of the verified-JWT cache
+    uint32_t jwtCacheHits() const {
+        return _securitySettingsService.jwtCacheHits();
+    }
+    uint32_t jwtCacheMisses() const {
+        return _securitySettingsService.jwtCacheMisses();
+    }
+
     // true if AP is active
     bool apStatus() {
         return _apSettingsService.getAPNetworkStatus() == APNetworkStatus::ACTIVE;
@@ -0,0 +1,83 @@
+#ifndef JWTCache_h
+#define JWTCache_h
+
+#include <Arduino.h>
+
+#include <mutex>
+
+#define JWT_CACHE_SIZE 4
+
+// the last successfully verified tokens, so a client polling with the same token skips the JWT verification
+// a token is found by its hash and compared in full, the caller hashes it once for find() and add()
+// requests are authenticated on the async_tcp task, so all access is locked
+class JWTCache {
+  public:
+    // true and the index of the user if the token is cached and that user still has the same name
+    // on a miss generation is set for the add() after the verification
+    template <typename Users>
+    bool find(const uint32_t hash, const String & jwt, const Users & users, size_t & user, uint32_t & generation) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (auto & entry : _entries) {
+            if (entry.used && entry.hash == hash && entry.jwt == jwt.c_str() && entry.user < users.size() && users[entry.user].username == entry.username.c_str()) {
+                entry.used = ++_used;
+                user       = entry.user;
+                _hits++;
+                return true;
+            }
+        }
+        generation = _generation;
+        _misses++;
+        return false;
+    }
+
+    // replaces the least recently used entry, unless the cache was cleared since find() as the verification may be stale
+    void add(const uint32_t hash, const String & jwt, const size_t user, const String & username, const uint32_t generation) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (generation != _generation) {
+            return;
+        }
+        Entry * oldest = &_entries[0];
+        for (auto & entry : _entries) {
+            if (entry.used < oldest->used) {
+                oldest = &entry;
+            }
+        }
+        *oldest = {hash, jwt, user, username, ++_used};
+    }
+
+    // on every change of the secret or the users
+    void clear() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (auto & entry : _entries) {
+            entry.jwt      = String();
+            entry.username = String();
+            entry.used     = 0;
+        }
+        _generation++;
+    }
+
+    uint32_t hits() const {
+        return _hits;
+    }
+    uint32_t misses() const {
+        return _misses;
+    }
+
+  private:
+    struct Entry {
+        uint32_t hash = 0;
+        String   jwt;
+        size_t   user = 0; // index in the users
+        String   username; // of the user, checked on a hit in case the users changed
+        uint32_t used = 0; // for replacing the least recently used entry, 0 if empty
+    };
+
+    Entry      _entries[JWT_CACHE_SIZE];
+    uint32_t   _used       = 0;
+    uint32_t   _generation = 0; // changed by clear()
+    uint32_t   _hits       = 0;
+    uint32_t   _misses     = 0;
+    std::mutex _mutex;
+};
+
+#endif
@@ -243,8 +243,10 @@ void MqttSettings::read(MqttSettings & settings, JsonObject root) {
     root["nested_format"]           = settings.nested_format;
     root["discovery_prefix"]        = settings.discovery_prefix;
     root["discovery_type"]          = settings.discovery_type;
+    root["discovery_budget"]        = settings.discovery_budget;
     root["publish_single"]          = settings.publish_single;
     root["publish_single2cmd"]      = settings.publish_single2cmd;
+    root["publish_changes"]         = settings.publish_changes;
     root["send_response"]           = settings.send_response;
 }
 
@@ -283,8 +285,10 @@ StateUpdateResult MqttSettings::update(JsonObject root, MqttSettings & settings)
     newSettings.nested_format      = static_cast<uint8_t>(root["nested_format"] | EMSESP_DEFAULT_NESTED_FORMAT);
     newSettings.discovery_prefix   = root["discovery_prefix"] | EMSESP_DEFAULT_DISCOVERY_PREFIX;
     newSettings.discovery_type     = static_cast<uint8_t>(root["discovery_type"] | EMSESP_DEFAULT_DISCOVERY_TYPE);
+    newSettings.discovery_budget   = static_cast<uint8_t>(root["discovery_budget"] | EMSESP_DEFAULT_DISCOVERY_BUDGET);
     newSettings.publish_single     = root["publish_single"] | EMSESP_DEFAULT_PUBLISH_SINGLE;
     newSettings.publish_single2cmd = root["publish_single2cmd"] | EMSESP_DEFAULT_PUBLISH_SINGLE2CMD;
+    newSettings.publish_changes    = root["publish_changes"] | EMSESP_DEFAULT_PUBLISH_CHANGES;
     newSettings.send_response      = root["send_response"] | EMSESP_DEFAULT_SEND_RESPONSE;
     newSettings.entity_format      = static_cast<uint8_t>(root["entity_format"] | EMSESP_DEFAULT_ENTITY_FORMAT);
 
@@ -309,6 +313,10 @@ StateUpdateResult MqttSettings::update(JsonObject root, MqttSettings & settings)
         changed = true;
     }
 
+    if (newSettings.discovery_budget != settings.discovery_budget) {
+        changed = true;
+    }
+
     if (newSettings.entity_format != settings.entity_format) {
         changed = true;
     }
@@ -329,6 +337,10 @@ StateUpdateResult MqttSettings::update(JsonObject root, MqttSettings & settings)
         changed = true;
     }
 
+    if (newSettings.publish_changes != settings.publish_changes) {
+        changed = true;
+    }
+
     if (newSettings.send_response != settings.send_response) {
         changed = true;
     }
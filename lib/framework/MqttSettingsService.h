@@ -79,8 +79,10 @@ class MqttSettings {
     uint8_t  nested_format;
     String   discovery_prefix;
     uint8_t  discovery_type;
+    uint8_t  discovery_budget;
     bool     publish_single;
     bool     publish_single2cmd;
+    bool     publish_changes;
     bool     send_response;
     uint8_t  entity_format;
 
@@ -1,5 +1,7 @@
 #include "SecuritySettingsService.h"
 
+#include "../../src/emsesp_stub.hpp"
+
 SecuritySettingsService::SecuritySettingsService(AsyncWebServer * server, FS * fs)
     : _httpEndpoint(SecuritySettings::read, SecuritySettings::update, this, server, SECURITY_SETTINGS_PATH, this)
     , _fsPersistence(SecuritySettings::read, SecuritySettings::update, this, fs, SECURITY_SETTINGS_FILE)
@@ -31,17 +33,36 @@ Authentication SecuritySettingsService::authenticateRequest(AsyncWebServerReques
     return {};
 }
 
+// called on every change of the secret or the users
 void SecuritySettingsService::configureJWTHandler() {
     _jwtHandler.setSecret(_state.jwtSecret);
+    _jwtCache.clear();
 }
 
+// only successful verifications are cached
 Authentication SecuritySettingsService::authenticateJWT(String & jwt) {
+    uint32_t hash = emsesp::Helpers::hash32(jwt.c_str(), jwt.length());
+    size_t   user;
+    uint32_t generation;
+    if (_jwtCache.find(hash, jwt, _state.users, user, generation)) {
+        return Authentication(_state.users[user]);
+    }
+
+    Authentication authentication = verifyJWT(jwt, user);
+    if (authentication.authenticated) {
+        _jwtCache.add(hash, jwt, user, authentication.user->username, generation);
+    }
+    return authentication;
+}
+
+Authentication SecuritySettingsService::verifyJWT(String & jwt, size_t & user) {
     JsonDocument payloadDocument;
     _jwtHandler.parseJWT(jwt, payloadDocument);
     if (payloadDocument.is<JsonObject>()) {
         JsonObject parsedPayload = payloadDocument.as<JsonObject>();
         String     username      = parsedPayload["username"];
-        for (const User & _user : _state.users) {
+        for (user = 0; user < _state.users.size(); user++) {
+            const User & _user = _state.users[user];
             if (_user.username == username && validatePayload(parsedPayload, &_user)) {
                 return Authentication(_user);
             }
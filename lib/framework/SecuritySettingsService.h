@@ -5,6 +5,7 @@
 #include "SecurityManager.h"
 #include "HttpEndpoint.h"
 #include "FSPersistence.h"
+#include "JWTCache.h"
 
 #ifndef FACTORY_ADMIN_USERNAME
 #define FACTORY_ADMIN_USERNAME "admin"
@@ -78,16 +79,25 @@ class SecuritySettingsService final : public StatefulService<SecuritySettings>,
     ArRequestHandlerFunction     wrapRequest(ArRequestHandlerFunction onRequest, AuthenticationPredicate predicate) override;
     ArJsonRequestHandlerFunction wrapCallback(ArJsonRequestHandlerFunction callback, AuthenticationPredicate predicate) override;
 
+    uint32_t jwtCacheHits() const {
+        return _jwtCache.hits();
+    }
+    uint32_t jwtCacheMisses() const {
+        return _jwtCache.misses();
+    }
+
   private:
     HttpEndpoint<SecuritySettings>  _httpEndpoint;
     FSPersistence<SecuritySettings> _fsPersistence;
     ArduinoJsonJWT                  _jwtHandler;
+    JWTCache                        _jwtCache;
 
     void generateToken(AsyncWebServerRequest * request);
 
     void configureJWTHandler();
 
     Authentication authenticateJWT(String & jwt); // Lookup the user by JWT
+    Authentication verifyJWT(String & jwt, size_t & user);
 
     boolean validatePayload(JsonObject parsedPayload, const User * user); // Verify the payload is correct
 };
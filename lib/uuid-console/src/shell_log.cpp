@@ -41,22 +41,6 @@ const uuid::log::Logger & Shell::logger() {
     return logger_instance;
 }
 
-Shell::QueuedLogMessage::QueuedLogMessage(unsigned long id, std::shared_ptr<uuid::log::Message> && content)
-    : id_(id)
-    , content_(std::move(content)) {
-}
-
-void Shell::operator<<(std::shared_ptr<uuid::log::Message> message) {
-#if UUID_CONSOLE_THREAD_SAFE
-    std::lock_guard<std::mutex> lock{mutex_};
-#endif
-    if (log_messages_.size() >= maximum_log_messages_) {
-        log_messages_.pop_front();
-    }
-
-    log_messages_.emplace_back(log_message_id_++, std::move(message));
-}
-
 uuid::log::Level Shell::log_level() const {
     return uuid::log::Logger::get_log_level(this);
 }
@@ -79,74 +63,58 @@ void Shell::maximum_log_messages(size_t count) {
 #endif
 
     maximum_log_messages_ = std::max((size_t)1, count);
-    while (log_messages_.size() > maximum_log_messages_) {
-        log_messages_.pop_front();
-    }
 }
 
 void Shell::output_logs() {
+    if (!unread()) {
+        return;
+    }
+
 #if UUID_CONSOLE_THREAD_SAFE
     std::unique_lock<std::mutex> lock{mutex_};
 #endif
-
-    if (log_messages_.empty())
-        return;
-
-    size_t count   = std::max((size_t)1, MAX_LOG_MESSAGES);
-    auto   message = log_messages_.front();
-
-    log_messages_.pop_front();
+    discard(maximum_log_messages_);
 #if UUID_CONSOLE_THREAD_SAFE
     lock.unlock();
 #endif
 
+    if (!fetch(log_message_)) {
+        return;
+    }
+
+    size_t count = std::max((size_t)1, MAX_LOG_MESSAGES);
+
     if (mode_ != Mode::DELAY) {
         erase_current_line();
         prompt_displayed_ = false;
     }
 
     while (1) {
-        print(uuid::log::format_timestamp_ms(message.content_->uptime_ms, 3));
-        printf(" %c %lu: [%s] ", uuid::log::format_level_char(message.content_->level), message.id_, message.content_->name);
+        print(uuid::log::format_timestamp_ms(log_message_.uptime_ms, 3));
+        printf(" %c %lu: [%s] ", uuid::log::format_level_char(log_message_.level), log_message_.id, log_message_.name);
 
-        if ((message.content_->level == uuid::log::Level::ERR) || (message.content_->level == uuid::log::Level::WARNING)) {
+        if ((log_message_.level == uuid::log::Level::ERR) || (log_message_.level == uuid::log::Level::WARNING)) {
             print(COLOR_RED);
-            println(message.content_->text);
+            println(log_message_.text);
             print(COLOR_RESET);
-        } else if (message.content_->level == uuid::log::Level::INFO) {
+        } else if (log_message_.level == uuid::log::Level::INFO) {
             print(COLOR_YELLOW);
-            println(message.content_->text);
+            println(log_message_.text);
             print(COLOR_RESET);
-        } else if (message.content_->level == uuid::log::Level::DEBUG) {
+        } else if (log_message_.level == uuid::log::Level::DEBUG) {
             print(COLOR_CYAN);
-            println(message.content_->text);
+            println(log_message_.text);
             print(COLOR_RESET);
         } else {
-            println(message.content_->text);
+            println(log_message_.text);
         }
 
         ::yield();
 
         count--;
-        if (count == 0) {
+        if (count == 0 || !fetch(log_message_)) {
             break;
         }
-
-#if UUID_CONSOLE_THREAD_SAFE
-        lock.lock();
-#endif
-        if (log_messages_.empty()) {
-#if UUID_CONSOLE_THREAD_SAFE
-            lock.unlock();
-#endif
-            break;
-        }
-
-        message = log_messages_.front();
-        log_messages_.pop_front();
-#if UUID_CONSOLE_THREAD_SAFE
-        lock.unlock();
-#endif
     }
 
     display_prompt();
@@ -18,6 +18,8 @@
 
 #include <uuid/log.h>
 
+#include <atomic>
+
 namespace uuid {
 
 namespace log {
@@ -26,6 +28,142 @@ Handler::~Handler() {
     Logger::unregister_handler(this);
 }
 
+bool Handler::fetch(Message & message) {
+    if (Ring::size() == 0) {
+        return false;
+    }
+
+    if (level_ == Level::OFF) {
+        ring_cursor_ = Ring::head();
+        return false;
+    }
+
+    while (Ring::head() != ring_cursor_) {
+        Ring::Header header;
+
+        if (!Ring::valid(ring_cursor_)) {
+            resync();
+            continue;
+        }
+
+        if (!Ring::read_header(ring_cursor_, header)) {
+            if (Ring::valid(ring_cursor_)) {
+                // still being written, try again on the next loop
+                return false;
+            }
+            resync();
+            continue;
+        }
+
+        const bool wanted = header.level <= level_at(ring_cursor_);
+        if (wanted) {
+            Ring::read_text(ring_cursor_, header, message);
+        }
+
+        // the record may have been overwritten while it was copied
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (!Ring::valid(ring_cursor_)) {
+            resync();
+            continue;
+        }
+
+        if (last_id_ != 0 && (long)(header.id - last_id_) > 1) {
+            dropped_ += header.id - last_id_ - 1;
+        }
+        last_id_ = header.id;
+        ring_cursor_ += header.length;
+
+        if (wanted) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+size_t Handler::pending(size_t count) const {
+    const unsigned long head     = Ring::head();
+    unsigned long       position = ring_cursor_;
+    size_t              found    = 0;
+    Ring::Header        header;
+
+    while (found < count && position != head && Ring::valid(position) && Ring::read_header(position, header)) {
+        if (header.level <= level_at(position)) {
+            found++;
+        }
+        position += header.length;
+    }
+
+    return found;
+}
+
+size_t Handler::discard(size_t keep) {
+    if (pending(keep + 1) <= keep) {
+        return 0;
+    }
+
+    size_t              found    = keep;
+    const unsigned long start    = find_backlog(found);
+    unsigned long       position = ring_cursor_;
+    size_t              skipped  = 0;
+    Ring::Header        header;
+
+    while (position != start && Ring::valid(position) && Ring::read_header(position, header)) {
+        if (header.level <= level_at(position)) {
+            skipped++;
+        }
+        position += header.length;
+    }
+
+    ring_cursor_ = start;
+    return skipped;
+}
+
+void Handler::rewind(size_t count) {
+    ring_cursor_ = find_backlog(count);
+    last_id_     = 0;
+}
+
+size_t Handler::backlog(size_t count) const {
+    find_backlog(count);
+    return count;
+}
+
+unsigned long Handler::find_backlog(size_t & count) const {
+    unsigned long position = Ring::head();
+    size_t        found    = 0;
+    Ring::Header  header;
+
+    while (found < count && Ring::size() != 0) {
+        const unsigned long start = Ring::previous(position, header);
+        if (start == position) {
+            break;
+        }
+        if (header.level <= level_at(start)) {
+            found++;
+        }
+        position = start;
+    }
+
+    count = found;
+    return position;
+}
+
+void Handler::resync() {
+    unsigned long position = Ring::head();
+    Ring::Header  header;
+
+    while (true) {
+        const unsigned long start = Ring::previous(position, header);
+        if (start == position) {
+            break;
+        }
+        position = start;
+    }
+
+    ring_cursor_ = position;
+}
+
 } // namespace log
 
 } // namespace uuid
@@ -20,6 +20,7 @@
 
 #include <Arduino.h>
 
+#include <algorithm>
 #include <atomic>
 #include <cstdarg>
 #include <cstdint>
@@ -53,12 +54,12 @@ static Level constrain_level(Level level) {
 }
 //! @endcond
 
-Message::Message(uint64_t uptime_ms, Level level, Facility facility, const char * name, const std::string && text)
+Message::Message(uint64_t uptime_ms, Level level, Facility facility, const char * name, const char * text)
     : uptime_ms(uptime_ms)
     , level(level)
     , facility(facility)
-    , name(name)
-    , text(std::move(text)) {
+    , name(name) {
+    strlcpy(this->text, text, sizeof(this->text));
 }
 
 Logger::Logger(const char * name, Facility facility)
@@ -79,7 +80,17 @@ void Logger::register_handler(Handler * handler, Level level) {
 #endif
     auto & handlers = registered_handlers();
 
+    // a new level only applies to messages logged from now on
+    if (handlers->find(handler) == handlers->end()) {
+        handler->ring_cursor_    = Ring::head();
+        handler->previous_level_ = level;
+    } else {
+        handler->previous_level_ = handler->level_;
+    }
+    handler->level_since_ = Ring::head();
+
     handler->handlers_   = handlers;
+    handler->level_      = level;
     (*handlers)[handler] = level;
     refresh_log_level();
 };
@@ -92,6 +103,8 @@ void Logger::unregister_handler(Handler * handler) {
         std::lock_guard<std::mutex> lock{mutex_};
 #endif
 
+        handler->level_ = Level::OFF;
+
         if (handlers->erase(handler)) {
             refresh_log_level();
         }
@@ -232,31 +245,16 @@ void Logger::vlog(Level level, const char * format, va_list ap) const {
 }
 
 void Logger::vlog(Level level, Facility facility, const char * format, va_list ap) const {
-    std::vector<char> text(MAX_LOG_LENGTH + 1);
+    char text[MAX_LOG_LENGTH + 1];
+    int  length = vsnprintf(text, sizeof(text), format, ap);
 
-    if (vsnprintf(text.data(), text.size(), format, ap) <= 0) {
+    if (length <= 0) {
         return;
     }
 
-    dispatch(level, facility, text);
-}
-
-void Logger::dispatch(Level level, Facility facility, std::vector<char> & text) const {
-    std::shared_ptr<Message> message = std::make_shared<Message>(get_uptime_ms(), level, facility, name_, text.data());
-    text.resize(0);
-
-#if UUID_LOG_THREAD_SAFE
-    std::lock_guard<std::mutex> lock{mutex_};
-#endif
-
-    for (auto & handler : *registered_handlers()) {
-        if (level <= handler.second) {
-            *handler.first << message;
-        }
-    }
+    Ring::write(level, facility, name_, text, std::min((size_t)length, sizeof(text) - 1));
 }
 
-/* Mutex already locked by caller. */
 void Logger::refresh_log_level() {
     Level level = Level::OFF;
 
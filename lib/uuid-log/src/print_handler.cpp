@@ -47,10 +47,6 @@ void PrintHandler::maximum_log_messages(size_t count) {
 #endif
 
     maximum_log_messages_ = std::max((size_t)1, count);
-
-    while (log_messages_.size() > maximum_log_messages_) {
-        log_messages_.pop_front();
-    }
 }
 
 void PrintHandler::loop(size_t count) {
@@ -59,22 +55,20 @@ void PrintHandler::loop(size_t count) {
 #endif
 
     count = std::max((size_t)1, count);
+    discard(maximum_log_messages_);
 
-    while (!log_messages_.empty()) {
-        auto message = log_messages_.front();
-
-        log_messages_.pop_front();
+    while (fetch(message_)) {
 #if UUID_LOG_THREAD_SAFE
         lock.unlock();
 #endif
 
-        print_.print(uuid::log::format_timestamp_ms(message->uptime_ms, 3).c_str());
+        print_.print(uuid::log::format_timestamp_ms(message_.uptime_ms, 3).c_str());
         print_.print(' ');
-        print_.print(uuid::log::format_level_char(message->level));
+        print_.print(uuid::log::format_level_char(message_.level));
         print_.print(" [");
-        print_.print(message->name);
+        print_.print(message_.name);
         print_.print("] ");
-        print_.println(message->text.c_str());
+        print_.println(message_.text);
 
         count--;
         if (count == 0) {
@@ -89,18 +83,6 @@ void PrintHandler::loop(size_t count) {
     }
 }
 
-void PrintHandler::operator<<(std::shared_ptr<Message> message) {
-#if UUID_LOG_THREAD_SAFE
-    std::lock_guard<std::mutex> lock{mutex_};
-#endif
-
-    if (log_messages_.size() >= maximum_log_messages_) {
-        log_messages_.pop_front();
-    }
-
-    log_messages_.emplace_back(std::move(message));
-}
-
 } // namespace log
 
 } // namespace uuid
\ No newline at end of file
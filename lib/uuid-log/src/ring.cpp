@@ -0,0 +1,157 @@
+/*
+ * uuid-log - Microcontroller logging framework
+ * Copyright 2021  Simon Arlott
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <uuid/log.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <new>
+
+namespace uuid {
+
+namespace log {
+
+std::unique_ptr<uint8_t[]> Ring::buffer_;
+size_t                     Ring::size_ = 0;
+std::atomic<unsigned long> Ring::head_{0};
+std::atomic<unsigned long> Ring::next_id_{1};
+
+constexpr size_t Ring::MIN_RECORD;
+constexpr size_t Ring::MAX_RECORD;
+
+//! @cond false
+static constexpr size_t align_record(size_t length) {
+    return (length + 3) & ~(size_t)3;
+}
+//! @endcond
+
+bool Ring::begin(size_t size) {
+    size_t rounded = 512;
+
+    while (rounded < size || rounded < MAX_RECORD * 2) {
+        rounded <<= 1;
+    }
+
+    if (buffer_) {
+        return rounded == size_;
+    }
+
+    buffer_.reset(new (std::nothrow) uint8_t[rounded]);
+    if (!buffer_) {
+        return false;
+    }
+
+    // positions are a multiple of 4, so this never matches a record tag
+    memset(buffer_.get(), 0xFF, rounded);
+    size_ = rounded;
+    return true;
+}
+
+void Ring::write(Level level, Facility facility, const char * name, const char * text, size_t length) {
+    static const uint8_t padding[4] = {0, 0, 0, 0};
+
+    if (!buffer_ && !begin(DEFAULT_SIZE)) {
+        return;
+    }
+
+    const size_t        text_length = align_record(length + 1);
+    const size_t        record      = sizeof(Header) + text_length + sizeof(uint32_t);
+    const unsigned long position    = head_.fetch_add(record, std::memory_order_relaxed);
+    const uint32_t      footer      = record;
+
+    // readers wait for the tag before they read the record
+    __atomic_store_n(tag(position), ~(uint32_t)position, __ATOMIC_RELAXED);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    Header header;
+    header.tag       = ~(uint32_t)position;
+    header.length    = record;
+    header.level     = level;
+    header.facility  = facility;
+    header.id        = next_id_.fetch_add(1, std::memory_order_relaxed);
+    header.name      = name;
+    header.uptime_ms = get_uptime_ms();
+
+    copy_in(position + sizeof(header.tag), reinterpret_cast<const uint8_t *>(&header) + sizeof(header.tag), sizeof(Header) - sizeof(header.tag));
+    copy_in(position + sizeof(Header), text, length);
+    copy_in(position + sizeof(Header) + length, padding, text_length - length);
+    copy_in(position + record - sizeof(footer), &footer, sizeof(footer));
+
+    __atomic_store_n(tag(position), (uint32_t)position, __ATOMIC_RELEASE);
+}
+
+bool Ring::read_header(unsigned long position, Header & header) {
+    if (__atomic_load_n(tag(position), __ATOMIC_ACQUIRE) != (uint32_t)position) {
+        return false;
+    }
+
+    copy_out(position, &header, sizeof(Header));
+
+    return header.length >= MIN_RECORD && header.length <= MAX_RECORD && (header.length & 3) == 0;
+}
+
+void Ring::read_text(unsigned long position, const Header & header, Message & message) {
+    const size_t length = std::min((size_t)header.length - sizeof(Header) - sizeof(uint32_t), sizeof(message.text));
+
+    copy_out(position + sizeof(Header), message.text, length);
+    message.text[sizeof(message.text) - 1] = '\0';
+
+    message.uptime_ms = header.uptime_ms;
+    message.level     = header.level;
+    message.facility  = header.facility;
+    message.name      = header.name;
+    message.id        = header.id;
+}
+
+unsigned long Ring::previous(unsigned long position, Header & header) {
+    uint32_t length;
+
+    copy_out(position - sizeof(length), &length, sizeof(length));
+    if (length < MIN_RECORD || length > MAX_RECORD || (length & 3) != 0) {
+        return position;
+    }
+
+    const unsigned long start = position - length;
+    if (!valid(start) || !read_header(start, header) || header.length != length) {
+        return position;
+    }
+
+    return start;
+}
+
+void Ring::copy_in(unsigned long position, const void * data, size_t length) {
+    const size_t offset = position & (size_ - 1);
+    const size_t first  = std::min(length, size_ - offset);
+
+    memcpy(&buffer_[offset], data, first);
+    memcpy(&buffer_[0], reinterpret_cast<const uint8_t *>(data) + first, length - first);
+}
+
+void Ring::copy_out(unsigned long position, void * data, size_t length) {
+    const size_t offset = position & (size_ - 1);
+    const size_t first  = std::min(length, size_ - offset);
+
+    memcpy(data, &buffer_[offset], first);
+    memcpy(reinterpret_cast<uint8_t *>(data) + first, &buffer_[0], length - first);
+}
+
+} // namespace log
+
+} // namespace uuid
@@ -246,12 +246,21 @@ bool parse_level_lowercase(const std::string & name, Level & level);
 /**
  * Log message text with timestamp and logger attributes.
  *
- * These will be created when a message is logged and then passed to
- * all registered handlers.
+ * These are written into the log message ring when a message is
+ * logged and then read from there by all registered handlers.
  *
  * @since 1.0.0
  */
 struct Message {
+    static constexpr size_t MAX_TEXT_LENGTH = 255; /*!< Maximum length of the message text. @since 3.1.0 */
+
+    /**
+	 * Create an empty log message.
+	 *
+	 * @since 3.1.0
+	 */
+    Message() = default;
+
     /**
 	 * Create a new log message (not directly useful).
 	 *
@@ -259,10 +268,10 @@ struct Message {
 	 * @param[in] level Severity level of the message.
 	 * @param[in] facility Facility type of the process logging the message.
 	 * @param[in] name Logger name
-	 * @param[in] text Log message text.
+	 * @param[in] text Log message text, truncated to MAX_TEXT_LENGTH.
 	 * @since 1.0.0
 	 */
-    Message(uint64_t uptime_ms, Level level, Facility facility, const char * name, const std::string && text);
+    Message(uint64_t uptime_ms, Level level, Facility facility, const char * name, const char * text);
     ~Message() = default;
 
     /**
@@ -271,28 +280,39 @@ struct Message {
 	 * @see uuid::get_uptime_ms()
 	 * @since 1.0.0
 	 */
-    const uint64_t uptime_ms;
+    uint64_t uptime_ms = 0;
 
     /**
 	 * Severity level of the message.
 	 *
 	 * @since 1.0.0
 	 */
-    const Level level;
+    Level level = Level::OFF;
 
     /**
 	 * Facility type of the process that logged the message.
 	 *
 	 * @since 1.0.0
 	 */
-    const Facility facility;
+    Facility facility = Facility::KERN;
 
     /**
 	 * Name of the logger used
 	 *
 	 * @since 1.0.0
 	 */
-    const char * name;
+    const char * name = "";
+
+    /**
+	 * Sequential identifier of the message in the log message ring.
+	 *
+	 * Shared by all handlers, so the same message has the same
+	 * identifier on every output. Zero for messages that were not
+	 * logged through the ring.
+	 *
+	 * @since 3.1.0
+	 */
+    unsigned long id = 0;
 
     /**
 	 * Formatted log message text.
@@ -302,14 +322,184 @@ struct Message {
 	 *
 	 * @since 1.0.0
 	 */
-    const std::string text;
+    char text[MAX_TEXT_LENGTH + 1] = {};
 };
 
 class Logger;
+class Handler;
+
+/**
+ * Fixed-size ring of log messages shared by all handlers.
+ *
+ * Loggers write each message as a variable length record into storage
+ * that is allocated once at startup, and handlers read the messages
+ * back through their own cursor. Logging therefore does not allocate
+ * memory and the memory used for buffered log messages is constant.
+ *
+ * Space for a record is claimed with an atomic counter so messages can
+ * be logged from any task without taking a lock. A handler that falls
+ * more than size() bytes behind loses the oldest messages.
+ *
+ * @since 3.1.0
+ */
+class Ring {
+  public:
+#ifdef UUID_LOG_RING_SIZE
+    static constexpr size_t DEFAULT_SIZE = UUID_LOG_RING_SIZE; /*!< Size of the ring in bytes if begin() is not called. @since 3.1.0 */
+#else
+    static constexpr size_t DEFAULT_SIZE = 8192; /*!< Size of the ring in bytes if begin() is not called. @since 3.1.0 */
+#endif
+
+    /**
+	 * Allocate the storage for the ring.
+	 *
+	 * Only has an effect before the first message is logged, after
+	 * that the size is fixed. It is not safe to call this while
+	 * another task may be logging.
+	 *
+	 * @param[in] size Size of the ring in bytes, rounded up to a power
+	 *                 of 2.
+	 * @return True if the ring has been allocated with this size.
+	 * @since 3.1.0
+	 */
+    static bool begin(size_t size);
+
+    /**
+	 * Get the size of the ring.
+	 *
+	 * @return The size of the ring in bytes, zero if it has not been
+	 *         allocated.
+	 * @since 3.1.0
+	 */
+    static size_t size() {
+        return size_;
+    }
+
+    /**
+	 * Get the position where the next message will be written.
+	 *
+	 * @return Position in bytes since the start of logging.
+	 * @since 3.1.0
+	 */
+    static unsigned long head() {
+        return head_.load(std::memory_order_acquire);
+    }
+
+  private:
+    friend Logger;
+    friend Handler;
+
+    /**
+	 * Start of a record in the ring, followed by the message text and
+	 * the length of the record so that the ring can be walked in both
+	 * directions.
+	 *
+	 * @since 3.1.0
+	 */
+    struct Header {
+        uint32_t      tag;       /*!< Position of the record once it has been written. @since 3.1.0 */
+        uint16_t      length;    /*!< Length of the record in bytes. @since 3.1.0 */
+        Level         level;     /*!< Severity level of the message. @since 3.1.0 */
+        Facility      facility;  /*!< Facility type of the message. @since 3.1.0 */
+        unsigned long id;        /*!< Identifier of the message. @since 3.1.0 */
+        const char *  name;      /*!< Logger name. @since 3.1.0 */
+        uint64_t      uptime_ms; /*!< System uptime when the message was logged. @since 3.1.0 */
+    };
+
+    // records are a multiple of 4 bytes, so that every record starts with an aligned tag
+    static constexpr size_t MIN_RECORD = sizeof(Header) + 4 + sizeof(uint32_t); /*!< Length of a record with empty text. @since 3.1.0 */
+    static constexpr size_t MAX_RECORD = sizeof(Header) + ((Message::MAX_TEXT_LENGTH + 1 + 3) & ~(size_t)3) + sizeof(uint32_t); /*!< Length of a record with the longest text. @since 3.1.0 */
+
+    /**
+	 * Write a message to the ring.
+	 *
+	 * @param[in] level Severity level of the message.
+	 * @param[in] facility Facility type of the message.
+	 * @param[in] name Logger name.
+	 * @param[in] text Message text.
+	 * @param[in] length Length of the message text.
+	 * @since 3.1.0
+	 */
+    static void write(Level level, Facility facility, const char * name, const char * text, size_t length);
+
+    /**
+	 * Read the header of a record.
+	 *
+	 * @param[in] position Position of the record.
+	 * @param[out] header Header of the record.
+	 * @return True if there is a complete record at this position.
+	 * @since 3.1.0
+	 */
+    static bool read_header(unsigned long position, Header & header);
+
+    /**
+	 * Read the text of a record.
+	 *
+	 * @param[in] position Position of the record.
+	 * @param[in] header Header of the record.
+	 * @param[out] message Message to copy the text into.
+	 * @since 3.1.0
+	 */
+    static void read_text(unsigned long position, const Header & header, Message & message);
+
+    /**
+	 * Find the start of the record that ends at a position.
+	 *
+	 * @param[in] position End of the record.
+	 * @param[out] header Header of the record.
+	 * @return Position of the record, or the end position if there is
+	 *         no complete record.
+	 * @since 3.1.0
+	 */
+    static unsigned long previous(unsigned long position, Header & header);
+
+    /**
+	 * Check that a record has not been overwritten.
+	 *
+	 * @param[in] position Position of the record.
+	 * @return True if the record is still in the ring.
+	 * @since 3.1.0
+	 */
+    static bool valid(unsigned long position) {
+        return head() - position <= size_;
+    }
+
+    /**
+	 * Copy data into the ring, wrapping around at the end.
+	 *
+	 * @since 3.1.0
+	 */
+    static void copy_in(unsigned long position, const void * data, size_t length);
+
+    /**
+	 * Copy data out of the ring, wrapping around at the end.
+	 *
+	 * @since 3.1.0
+	 */
+    static void copy_out(unsigned long position, void * data, size_t length);
+
+    /**
+	 * Get the commit tag of the record at a position.
+	 *
+	 * @since 3.1.0
+	 */
+    static uint32_t * tag(unsigned long position) {
+        return reinterpret_cast<uint32_t *>(&buffer_[position & (size_ - 1)]);
+    }
+
+    static std::unique_ptr<uint8_t[]> buffer_;  /*!< Message storage. @since 3.1.0 */
+    static size_t                     size_;    /*!< Size of the storage, a power of 2. @since 3.1.0 */
+    static std::atomic<unsigned long> head_;    /*!< Position of the next record. @since 3.1.0 */
+    static std::atomic<unsigned long> next_id_; /*!< Identifier of the next message. @since 3.1.0 */
+};
 
 /**
  * Logger handler used to process log messages.
  *
+ * Handlers do not receive or store messages themselves. Each one has a
+ * cursor into the log message ring and reads the messages at its log
+ * level with fetch() from its own loop.
+ *
  * @since 1.0.0
  */
 class Handler {
@@ -324,36 +514,115 @@ class Handler {
   public:
     virtual ~Handler();
 
+  protected:
+    Handler() = default;
+
     /**
-	 * Add a new log message.
+	 * Read the next unread message at or below the log level of this
+	 * handler.
 	 *
-	 * This should normally be put in a queue instead of being
-	 * processed immediately so that log messages have minimal impact
-	 * at the time of use.
+	 * The message is copied so that it can't be overwritten while it
+	 * is being processed.
 	 *
-	 * Handlers must avoid holding a lock on a mutex used for adding
-	 * messages while processing those messages. Release the lock while
-	 * performing the processing.
+	 * @param[out] message Next log message.
+	 * @return True if a message was read, false if there are no more.
+	 * @since 3.1.0
+	 */
+    bool fetch(Message & message);
+
+    /**
+	 * Check if there are messages in the ring that have not been read,
+	 * of any log level.
+	 *
+	 * @return True if there are unread messages.
+	 * @since 3.1.0
+	 */
+    bool unread() const {
+        return Ring::head() != ring_cursor_;
+    }
+
+    /**
+	 * Get the number of unread messages at or below the log level of
+	 * this handler.
 	 *
-	 * Queues should have a maximum size and discard the oldest message
-	 * when full.
+	 * @param[in] count Maximum number of messages to count.
+	 * @return The number of unread messages, up to count.
+	 * @since 3.1.0
+	 */
+    size_t pending(size_t count = SIZE_MAX) const;
+
+    /**
+	 * Skip unread messages so that at most the most recent ones remain.
 	 *
-	 * It is not safe for the handler to directly or indirectly do any
-	 * of the following while this function is being called:
-	 * - Log a message.
-	 * - Read the log level of any handler.
-	 * - Modify the log level of any handler.
-	 * - Unregister any handler.
+	 * @param[in] keep Number of unread messages at or below the log
+	 *                 level of this handler to keep.
+	 * @return The number of skipped messages.
+	 * @since 3.1.0
+	 */
+    size_t discard(size_t keep);
+
+    /**
+	 * Move the cursor back so that the most recent messages at or below
+	 * the log level of this handler will be read again, as far as they
+	 * are still in the ring.
 	 *
-	 * @param[in] message New log message, shared by all handlers.
-	 * @since 1.0.0
+	 * @param[in] count Number of messages to read again.
+	 * @since 3.1.0
 	 */
-    virtual void operator<<(std::shared_ptr<Message> message) = 0;
+    void rewind(size_t count);
 
-  protected:
-    Handler() = default;
+    /**
+	 * Get the number of recent messages at or below the log level of
+	 * this handler that are still in the ring.
+	 *
+	 * @param[in] count Maximum number of messages to count.
+	 * @return The number of messages that rewind() would read again.
+	 * @since 3.1.0
+	 */
+    size_t backlog(size_t count) const;
+
+    /**
+	 * Get the number of messages that were overwritten before this
+	 * handler could read them.
+	 *
+	 * @return The number of lost messages.
+	 * @since 3.1.0
+	 */
+    unsigned long dropped() const {
+        return dropped_;
+    }
 
   private:
+    /**
+	 * Get the log level of this handler for a message.
+	 *
+	 * @param[in] position Position of the message in the ring.
+	 * @return Log level that applied when the message was logged.
+	 * @since 3.1.0
+	 */
+    Level level_at(unsigned long position) const {
+        return (long)(position - level_since_) >= 0 ? level_ : previous_level_;
+    }
+
+    /**
+	 * Find the start of the most recent messages at or below the log
+	 * level of this handler.
+	 *
+	 * @param[in,out] count Number of messages to find, set to the
+	 *                      number of messages found.
+	 * @return Position of the oldest message found.
+	 * @since 3.1.0
+	 */
+    unsigned long find_backlog(size_t & count) const;
+
+    /**
+	 * Move the cursor to the oldest message still in the ring after
+	 * it has been overwritten.
+	 *
+	 * @since 3.1.0
+	 */
+    void resync();
+
     /**
 	 * Reference to registered log handlers.
 	 *
@@ -363,6 +632,13 @@ class Handler {
 	 * @since 2.1.2
 	 */
     std::weak_ptr<std::map<Handler *, Level>> handlers_;
+
+    Level         level_          = Level::OFF; /*!< Log level of this handler. @since 3.1.0 */
+    Level         previous_level_ = Level::OFF; /*!< Log level of this handler for messages logged before level_since_. @since 3.1.0 */
+    unsigned long level_since_    = 0;          /*!< Position of the first message that level_ applies to. @since 3.1.0 */
+    unsigned long ring_cursor_    = 0;          /*!< Position of the next message to read. @since 3.1.0 */
+    unsigned long last_id_        = 0;          /*!< Identifier of the last message read. @since 3.1.0 */
+    unsigned long dropped_        = 0;          /*!< Number of messages lost because they were overwritten. @since 3.1.0 */
 };
 
 /**
@@ -375,12 +651,12 @@ class Logger {
     /**
 	 * This is the maximum length of any log message.
 	 *
-	 * Determines the size of the buffer used for format string
-	 * printing.
+	 * Determines the size of the message text in the log message
+	 * ring.
 	 *
 	 * @since 1.0.0
 	 */
-    static constexpr size_t MAX_LOG_LENGTH = 255;
+    static constexpr size_t MAX_LOG_LENGTH = Message::MAX_TEXT_LENGTH;
 
     /**
 	 * Create a new logger with the given name and logging facility.
@@ -633,20 +909,6 @@ class Logger {
 	 */
     void vlog(Level level, Facility facility, const char * format, va_list ap) const;
 
-    /**
-	 * Dispatch a log message to all handlers that are registered to
-	 * handle messages of the specified level.
-	 *
-	 * Automatically sets the timestamp of the message to the current
-	 * system uptime.
-	 *
-	 * @param[in] level Severity level of the message.
-	 * @param[in] facility Facility type of the process logging the message.
-	 * @param[in] text Log message text.
-	 * @since 1.0.0
-	 */
-    void dispatch(Level level, Facility facility, std::vector<char> & text) const;
-
     static std::atomic<Level> global_level_; /*!< Minimum global log level across all handlers. @since 3.0.0 */
 #if UUID_LOG_THREAD_SAFE
     static std::mutex mutex_; /*!< Mutex for handlers. @since 2.3.0 */
@@ -704,30 +966,38 @@ class PrintHandler : public uuid::log::Handler {
 	 */
     void loop(size_t count = SIZE_MAX);
 
-    /**
-	 * Add a new log message.
-	 *
-	 * This will be put in a queue for output at the next loop()
-	 * process. The queue has a maximum size of
-	 * get_maximum_log_messages() and will discard the oldest message
-	 * first.
-	 *
-	 * @param[in] message New log message, shared by all handlers.
-	 * @since 2.2.0
-	 */
-    virtual void operator<<(std::shared_ptr<Message> message);
-
   private:
     Print & print_; /*!< Destination for output of log messages. @since 2.2.0 */
 #if UUID_LOG_THREAD_SAFE
     mutable std::mutex mutex_; /*!< Mutex for configuration, state and queued log messages. @since 2.3.0 */
 #endif
-    size_t maximum_log_messages_ = MAX_LOG_MESSAGES;   /*!< Maximum number of log messages to buffer before they are output. @since 2.2.0 */
-    std::list<std::shared_ptr<Message>> log_messages_; /*!< Queued log messages, in the order they were received. @since 2.2.0 */
+    size_t  maximum_log_messages_ = MAX_LOG_MESSAGES; /*!< Maximum number of log messages to buffer before they are output. @since 2.2.0 */
+    Message message_;                                 /*!< Log message being output. @since 3.1.0 */
 };
 
 } // namespace log
 
 } // namespace uuid
 
+/**
+ * Log a message with a Logger function if its level is enabled.
+ *
+ * The Logger functions check the level themselves, but only after the
+ * format string arguments have been evaluated. This checks it first,
+ * so the arguments are not evaluated when nobody listens and can be
+ * expensive to build.
+ *
+ * @param[in] logger Logger object.
+ * @param[in] level Log level of the function.
+ * @param[in] function Logger function for the level, e.g. trace.
+ * @param[in] ... Format string and arguments.
+ * @since 3.1.0
+ */
+#define UUID_LOG_LAZY(logger, level, function, ...) \
+    do {                                            \
+        if ((logger).enabled(level)) {              \
+            (logger).function(__VA_ARGS__);         \
+        }                                           \
+    } while (0)
+
 #endif
\ No newline at end of file
@@ -68,7 +68,6 @@
 #endif
 
 #include <algorithm>
-#include <list>
 #include <memory>
 #if UUID_SYSLOG_THREAD_SAFE
 #include <mutex>
@@ -111,20 +110,12 @@ void SyslogService::remove_queued_messages(uuid::log::Level level) {
 #if UUID_SYSLOG_THREAD_SAFE
     std::lock_guard<std::mutex> lock{mutex_};
 #endif
-    unsigned long offset = 0;
-
-    for (auto it = log_messages_.begin(); it != log_messages_.end();) {
-        if (it->content_->level > level) {
-            offset++;
-            it = log_messages_.erase(it);
-        } else {
-            it->id_ -= offset;
-            it++;
-        }
+    // messages still in the ring are filtered by the level when they are read
+    if (log_message_pending_ && log_message_.content_.level > level) {
+        log_message_pending_ = false;
+        log_message_id_--;
+        log_message_fails_++;
     }
-
-    log_message_id_ -= offset;
-    log_message_fails_ += offset;
 }
 
 void SyslogService::log_level(uuid::log::Level level) {
@@ -159,10 +150,6 @@ void SyslogService::maximum_log_messages(size_t count) {
     std::lock_guard<std::mutex> lock{mutex_};
 #endif
     maximum_log_messages_ = std::max((size_t)1, count);
-
-    while (log_messages_.size() > maximum_log_messages_) {
-        log_messages_.pop_front();
-    }
 }
 
 size_t SyslogService::current_log_messages() const {
@@ -170,7 +157,7 @@ size_t SyslogService::current_log_messages() const {
     std::lock_guard<std::mutex> lock{mutex_};
 #endif
 
-    return log_messages_.size();
+    return pending(maximum_log_messages_) + (log_message_pending_ ? 1 : 0);
 }
 
 std::pair<IPAddress, uint16_t> SyslogService::destination() const {
@@ -229,9 +216,9 @@ void SyslogService::mark_interval(unsigned long interval) {
     mark_interval_ = (uint64_t)interval * 1000;
 }
 
-SyslogService::QueuedLogMessage::QueuedLogMessage(unsigned long id, std::shared_ptr<uuid::log::Message> && content)
-    : id_(id)
-    , content_(std::move(content)) {
+void SyslogService::QueuedLogMessage::stamp(unsigned long id) {
+    id_ = id;
+
     // Added for EMS-ESP
     // check for Ethernet too. This assumes the network has already started.
     if (time_good_ || emsesp::EMSESP::system_.network_connected()) {
@@ -249,81 +236,51 @@ SyslogService::QueuedLogMessage::QueuedLogMessage(unsigned long id, std::shared_
 
         if (time_.tv_sec != (time_t)-1) {
             time_good_ = true;
+
+            // the message may have been waiting in the ring, go back to when it was logged
+            uint64_t age_us = (uuid::get_uptime_ms() - content_.uptime_ms) * 1000ULL;
+            uint64_t now_us = (uint64_t)time_.tv_sec * 1000000ULL + time_.tv_usec;
+            if (age_us < now_us) {
+                now_us -= age_us;
+                time_.tv_sec  = now_us / 1000000ULL;
+                time_.tv_usec = now_us % 1000000ULL;
+            }
         }
     } else {
         time_.tv_sec = (time_t)-1;
     }
 }
 
-/* Mutex already locked by caller. */
-void SyslogService::add_message(std::shared_ptr<uuid::log::Message> & message) {
-    if (log_messages_.size() >= maximum_log_messages_) {
-        log_messages_.pop_front();
-        log_message_fails_++;
-    }
-
-    log_messages_.emplace_back(log_message_id_++, std::move(message));
-}
-
-void SyslogService::operator<<(std::shared_ptr<uuid::log::Message> message) {
-#if UUID_SYSLOG_THREAD_SAFE
-    std::lock_guard<std::mutex> lock{mutex_};
-#endif
-
-    add_message(message);
-}
-
 void SyslogService::loop() {
+    size_t count = std::max((size_t)1, MAX_LOG_MESSAGES);
+
 #if UUID_SYSLOG_THREAD_SAFE
     std::unique_lock<std::mutex> lock{mutex_};
 #endif
-    size_t count = std::max((size_t)1, MAX_LOG_MESSAGES);
-
-    while (!log_messages_.empty()) {
+    log_message_fails_ += discard(maximum_log_messages_);
 #if UUID_SYSLOG_THREAD_SAFE
-        lock.unlock();
+    lock.unlock();
 #endif
 
+    while (log_message_pending_ || fetch(log_message_.content_)) {
+        if (!log_message_pending_) {
+            log_message_.stamp(log_message_id_++);
+            log_message_pending_ = true;
+        }
+
         if (!can_transmit())
             return;
 
-#if UUID_SYSLOG_THREAD_SAFE
-        lock.lock();
-
-        if (log_messages_.empty())
-            break;
-#endif
-
-        auto message = log_messages_.front();
-
         started_ = true;
 
-#if UUID_SYSLOG_THREAD_SAFE
-        lock.unlock();
-#endif
-
-        auto ok = transmit(message);
+        auto ok = transmit(log_message_);
         if (ok) {
-#if UUID_SYSLOG_THREAD_SAFE
-            lock.lock();
-#endif
-
-            last_message_ = last_transmit_;
-            if (!log_messages_.empty() && log_messages_.front().content_ == message.content_) {
-                log_messages_.pop_front();
-            }
-
-#if UUID_SYSLOG_THREAD_SAFE
-            lock.unlock();
-#endif
+            last_message_        = last_transmit_;
+            log_message_pending_ = false;
         }
 
         ::yield();
 
-#if UUID_SYSLOG_THREAD_SAFE
-        lock.lock();
-#endif
-
         if (!ok) {
             break;
         }
@@ -334,16 +291,17 @@ void SyslogService::loop() {
         }
     }
 
-    if (started_ && mark_interval_ != 0 && log_messages_.empty()) {
+    if (started_ && mark_interval_ != 0 && !log_message_pending_ && !unread()) {
         if (uuid::get_uptime_ms() - last_message_ >= mark_interval_) {
             // This is generated manually because the log level may not
             // be high enough to receive INFO messages.
-            auto message = std::make_shared<uuid::log::Message>(uuid::get_uptime_ms(),
-                                                                uuid::log::Level::INFO,
-                                                                uuid::log::Facility::SYSLOG,
-                                                                (__pstr__logger_name),
-                                                                "-- MARK --");
-            add_message(message);
+            log_message_.content_ = uuid::log::Message(uuid::get_uptime_ms(),
+                                                       uuid::log::Level::INFO,
+                                                       uuid::log::Facility::SYSLOG,
+                                                       (__pstr__logger_name),
+                                                       "-- MARK --");
+            log_message_.stamp(log_message_id_++);
+            log_message_pending_ = true;
         }
     }
 }
@@ -513,7 +471,7 @@ bool SyslogService::transmit(const QueuedLogMessage & message) {
 	 * The maximum possible priority value does not exceed the requirement that
 	 * the PRI part MUST be 3-5 characters.
 	 */
-    udp_.printf("<%u>1 ", (uint8_t)(message.content_->facility * 8U) + std::min(7U, (unsigned int)message.content_->level));
+    udp_.printf("<%u>1 ", (uint8_t)(message.content_.facility * 8U) + std::min(7U, (unsigned int)message.content_.level));
 
     if (tm.tm_year != 0) {
         // udp_.printf_P("%04u-%02u-%02uT%02u:%02u:%02u.%06luZ",
@@ -540,12 +498,12 @@ bool SyslogService::transmit(const QueuedLogMessage & message) {
         udp_.print('-');
     }
 
-    udp_.printf(" %s %s - - - ", hostname_.c_str(), message.content_->name);
+    udp_.printf(" %s %s - - - ", hostname_.c_str(), message.content_.name);
 
     char id_c_str[15];
     snprintf(id_c_str, sizeof(id_c_str), " %lu: ", message.id_);
-    std::string msgstr = uuid::log::format_timestamp_ms(message.content_->uptime_ms, 3) + ' ' + uuid::log::format_level_char(message.content_->level) + id_c_str
-                         + message.content_->text;
+    std::string msgstr = uuid::log::format_timestamp_ms(message.content_.uptime_ms, 3) + ' ' + uuid::log::format_level_char(message.content_.level) + id_c_str
+                         + message.content_.text;
     for (uint16_t i = 0; i < msgstr.length(); i++) {
         if (msgstr.at(i) & 0x80) {
             udp_.print("\xEF\xBB\xBF");
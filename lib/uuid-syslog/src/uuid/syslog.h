@@ -24,7 +24,6 @@
 #include <WiFiUdp.h>
 #include <time.h>
 
-#include <list>
 #include <memory>
 #include <string>
 
@@ -204,25 +203,12 @@ class SyslogService : public uuid::log::Handler {
 	 */
     void loop();
 
-    /**
-	 * Add a new log message.
-	 *
-	 * This will be put in a queue for output at the next loop()
-	 * process. The queue has a maximum size of
-	 * get_maximum_log_messages() and will discard the oldest message
-	 * first.
-	 *
-	 * @param[in] message New log message, shared by all handlers.
-	 * @since 1.0.0
-	 */
-    virtual void operator<<(std::shared_ptr<uuid::log::Message> message);
-
     /**
 	* added for EMS-ESP
 	* query status variables
     */
     size_t queued() {
-        return log_messages_.size();
+        return current_log_messages();
     }
     bool started() {
         return started_;
@@ -240,7 +226,7 @@ class SyslogService : public uuid::log::Handler {
 
   private:
     /**
-	 * Log message that has been queued.
+	 * Log message that is being transmitted.
 	 *
 	 * Contains an identifier sequence to indicate when log messages
 	 * could not be output because the queue discarded one or more
@@ -251,36 +237,21 @@ class SyslogService : public uuid::log::Handler {
     class QueuedLogMessage {
       public:
         /**
-		 * Create a queued log message.
+		 * Set the identifier and the time the message was logged.
 		 *
-		 * @param[in] id Identifier to use for the log message on the queue.
-		 * @param[in] content Log message content.
-		 * @since 1.0.0
+		 * @param[in] id Identifier to use for the log message.
+		 * @since 3.1.0
 		 */
-        QueuedLogMessage(unsigned long id, std::shared_ptr<uuid::log::Message> && content);
-        ~QueuedLogMessage() = default;
+        void stamp(unsigned long id);
 
-        unsigned long                             id_;      /*!< Sequential identifier for this log message. @since 1.0.0 */
-        struct timeval                            time_;    /*!< Time message was received. @since 1.0.0 */
-        std::shared_ptr<const uuid::log::Message> content_; /*!< Log message content. @since 1.0.0 */
+        unsigned long      id_;      /*!< Sequential identifier for this log message. @since 1.0.0 */
+        struct timeval     time_;    /*!< Time message was logged. @since 1.0.0 */
+        uuid::log::Message content_; /*!< Log message content. @since 1.0.0 */
 
       private:
         static bool time_good_; /*!< System time appears to be valid. @since 1.0.0 */
     };
 
-    /**
-	 * Add a new log message.
-	 *
-	 * This will be put in a queue for output at the next loop()
-	 * process. The queue has a maximum size of
-	 * get_maximum_log_messages() and will discard the oldest message
-	 * first.
-	 *
-	 * @param[in] message New log message, shared by all handlers.
-	 * @since 2.2.0
-	 */
-    void add_message(std::shared_ptr<uuid::log::Message> & message);
-
     /**
 	 * Remove messages that were queued before the log level was set.
 	 *
@@ -319,11 +290,12 @@ class SyslogService : public uuid::log::Handler {
 #if UUID_SYSLOG_THREAD_SAFE
     mutable std::mutex mutex_; /*!< Mutex for queued log messages. @since 2.2.0 */
 #endif
-    size_t                      maximum_log_messages_ = MAX_LOG_MESSAGES; /*!< Maximum number of log messages to buffer before they are output. @since 1.0.0 */
-    unsigned long               log_message_id_       = 0;                /*!< The next identifier to use for queued log messages. @since 1.0.0 */
-    std::list<QueuedLogMessage> log_messages_;                            /*!< Queued log messages, in the order they were received. @since 1.0.0 */
-    uint64_t                    mark_interval_ = 0;                       /*!< Mark interval in milliseconds. @since 2.0.0 */
-    uint64_t                    last_message_  = 0;                       /*!< Last message/mark time. @since 2.0.0 */
+    size_t           maximum_log_messages_ = MAX_LOG_MESSAGES; /*!< Maximum number of log messages to buffer before they are output. @since 1.0.0 */
+    unsigned long    log_message_id_       = 0;                /*!< The next identifier to use for queued log messages. @since 1.0.0 */
+    QueuedLogMessage log_message_;                             /*!< Log message read from the ring that has not been transmitted yet. @since 3.1.0 */
+    bool             log_message_pending_ = false;             /*!< There is a log message waiting to be transmitted. @since 3.1.0 */
+    uint64_t         mark_interval_       = 0;                 /*!< Mark interval in milliseconds. @since 2.0.0 */
+    uint64_t         last_message_        = 0;                 /*!< Last message/mark time. @since 2.0.0 */
 
     // added by MichaelDvP for EMS-ESP
     IPAddress     ip_;   /*!< Host to send messages to. @since 1.0.0 */
@@ -35,10 +35,12 @@ class DummySettings {
     uint8_t  nested_format      = 1; // 1=nested 2=single
     String   discovery_prefix   = "homeassistant";
     uint8_t  discovery_type     = 0; // HA
+    uint8_t  discovery_budget   = 10;
     bool     ha_enabled         = true;
     String   base               = "ems-esp";
     bool     publish_single     = false;
     bool     publish_single2cmd = false;
+    bool     publish_changes    = false;
     bool     send_response      = false; // don't send response
     String   host               = "192.168.1.4";
     uint16_t port               = 1883;
@@ -5,6 +5,7 @@
 #include "AsyncTCP.h"
 
 #include <functional>
+#include <vector>
 #include <ArduinoJson.h>
 
 class AsyncWebServer;
@@ -59,8 +60,9 @@ typedef enum {
     HTTP_ANY     = 0b01111111,
 } WebRequestMethod;
 
-typedef uint8_t                   WebRequestMethodComposite;
-typedef std::function<void(void)> ArDisconnectHandler;
+typedef uint8_t                                           WebRequestMethodComposite;
+typedef std::function<void(void)>                         ArDisconnectHandler;
+typedef std::function<size_t(uint8_t *, size_t, size_t)> AwsResponseFiller;
 
 class AsyncWebServerRequest {
     friend class AsyncWebServer;
@@ -73,6 +75,8 @@ class AsyncWebServerRequest {
 
     String _url;
 
+    std::string _chunkedContent;
+
   public:
     void * _tempObject;
 
@@ -107,6 +111,22 @@ class AsyncWebServerRequest {
     void send(int code, const String & contentType = String(), const String & content = String()) {};
     void send(int code, const String & contentType, const __FlashStringHelper *) {};
 
+    // reads the whole chunked response right away, in small pieces like the async server does
+    void sendChunked(const String & contentType, AwsResponseFiller callback) {
+        uint8_t buffer[256];
+        size_t  index = 0;
+        size_t  len;
+        _chunkedContent.clear();
+        while ((len = callback(buffer, sizeof(buffer), index)) > 0) {
+            _chunkedContent.append((const char *)buffer, len);
+            index += len;
+        }
+    }
+
+    const std::string & chunkedContent() const {
+        return _chunkedContent;
+    }
+
     const String & url() const {
         return _url;
     }
@@ -250,9 +270,32 @@ class AsyncWebServer {
 };
 
 
+// a single client that is always connected and keeps the last data written to it
+class AsyncEventSourceClient {
+  public:
+    void write(const char * message, size_t len) {
+        data_ = message;
+        len_  = len;
+        writes_++;
+    };
+
+    bool connected() const {
+        return true;
+    }
+
+    size_t packetsWaiting() const {
+        return 0;
+    }
+
+    const char * data_   = nullptr;
+    size_t       len_    = 0;
+    size_t       writes_ = 0;
+};
+
 class AsyncEventSource : public AsyncWebHandler {
   public:
-    AsyncEventSource(const String & url) {};
+    AsyncEventSource(const String & url)
+        : clients_{&client_} {};
     ~AsyncEventSource() {};
 
     size_t count() const {
@@ -260,6 +303,14 @@ class AsyncEventSource : public AsyncWebHandler {
     }
 
     void send(const char * message, const char * event = NULL, uint32_t id = 0, uint32_t reconnect = 0) {};
+
+    const std::vector<AsyncEventSourceClient *> & clients() const {
+        return clients_;
+    }
+
+  private:
+    AsyncEventSourceClient                client_;
+    std::vector<AsyncEventSourceClient *> clients_;
 };
 
 
@@ -21,6 +21,8 @@
 
 #include "Arduino.h"
 
+#define EMS_MAXBUFFERSIZE 33 // max size of the buffer. EMS packets are max 32 bytes, plus extra for BRK
+
 namespace emsesp {
 
 #define EMS_TX_STATUS_ERR 0
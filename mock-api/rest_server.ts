@@ -380,9 +380,11 @@ let mqtt_settings = {
   ha_enabled: true,
   nested_format: 1,
   discovery_type: 0,
+  discovery_budget: 10,
   discovery_prefix: 'homeassistant',
   send_response: true,
-  publish_single: false
+  publish_single: false,
+  publish_changes: false
 };
 const mqtt_status = {
   enabled: true,
@@ -710,7 +712,9 @@ let settings = {
   modbus_enabled: false,
   modbus_port: 502,
   modbus_max_clients: 10,
-  modbus_timeout: 10000
+  modbus_timeout: 10000,
+  modbus_strict: false,
+  fetch_budget: 0
 };
 
 const emsesp_coredata = {
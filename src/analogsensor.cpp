@@ -663,6 +663,33 @@ bool AnalogSensor::get_value_info(JsonObject output, const char * cmd, const int
     return false; // not found
 }
 
+// the value of a sensor, matched by name or GPIO, as get_value_info() returns <name>/value, without building the json
+// the double is written like ArduinoJson does, with up to 9 decimals
+// index is where it was found the last time and is updated, nullptr if it's not found
+const char * AnalogSensor::get_value_string(const char * name, int16_t & index, char * result, const size_t len) const {
+    auto match = [name](const Sensor & sensor) { return !strcasecmp(sensor.name().c_str(), name) || Helpers::atoint(name) == sensor.gpio(); };
+    if (index < 0 || index >= (int16_t)sensors_.size() || !match(sensors_[index])) {
+        auto sensor = std::find_if(sensors_.begin(), sensors_.end(), match);
+        if (sensor == sensors_.end()) {
+            index = -1;
+            return nullptr;
+        }
+        index = sensor - sensors_.begin();
+    }
+
+    auto l = snprintf(result, len, "%.9f", sensors_[index].value());
+    if (l < 0 || (size_t)l >= len) {
+        return nullptr;
+    }
+    while (result[l - 1] == '0') {
+        result[--l] = '\0';
+    }
+    if (result[l - 1] == '.') {
+        result[--l] = '\0';
+    }
+    return result;
+}
+
 void AnalogSensor::get_value_json(JsonObject output, const Sensor & sensor) {
     output["name"]      = sensor.name();
     output["fullname"]  = sensor.name();
@@ -41,7 +41,7 @@ class AnalogSensor {
             offset_ = offset;
         }
 
-        std::string name() const {
+        const std::string & name() const {
             return name_;
         }
 
@@ -161,9 +161,10 @@ class AnalogSensor {
         return sensors_.size();
     }
 
-    bool update(uint8_t gpio, std::string & name, double offset, double factor, uint8_t uom, int8_t type, bool deleted = false);
-    bool get_value_info(JsonObject output, const char * cmd, const int8_t id = -1);
-    void store_counters();
+    bool         update(uint8_t gpio, std::string & name, double offset, double factor, uint8_t uom, int8_t type, bool deleted = false);
+    bool         get_value_info(JsonObject output, const char * cmd, const int8_t id = -1);
+    const char * get_value_string(const char * name, int16_t & index, char * result, const size_t len) const;
+    void         store_counters();
 
   private:
     static constexpr uint8_t  MAX_SENSORS             = 20;
@@ -25,6 +25,7 @@ namespace emsesp {
 uuid::log::Logger Command::logger_{F_(command), uuid::log::Facility::DAEMON};
 
 std::vector<Command::CmdFunction> Command::cmdfunctions_;
+HashIndex                         Command::cmd_index_;
 
 // takes a URI path and a json body, parses the data and calls the command
 // the path is leading so if duplicate keys are in the input JSON it will be ignored
@@ -446,6 +447,7 @@ void Command::add(const uint8_t device_type, const uint8_t device_id, const char
     }
 
     cmdfunctions_.emplace_back(device_type, device_id, flags, cmd, cb, nullptr, description); // callback for json is nullptr
+    cmd_index_add();
 }
 
 // add a command with no json output
@@ -462,23 +464,44 @@ void Command::add(const uint8_t device_type, const char * cmd, const cmd_json_fu
     }
 
     cmdfunctions_.emplace_back(device_type, 0, flags, cmd, nullptr, cb, description); // callback for json is included
+    cmd_index_add();
+}
+
+// compare two commands, not case sensitive
+static bool cmd_equals(const char * a, const char * b) {
+    while (*a && (tolower(*a) == tolower(*b))) {
+        a++;
+        b++;
+    }
+    return tolower(*a) == tolower(*b);
+}
+
+// hash of the lowercase command, seeded with the device type
+uint32_t Command::cmd_hash(const uint8_t device_type, const char * cmd) {
+    return Helpers::hash32(cmd, cmd ? strlen(cmd) : 0, device_type, true);
+}
+
+// add the last command in cmdfunctions_ to the hash index
+void Command::cmd_index_add() {
+    cmd_index_.add(cmdfunctions_.size() - 1, cmdfunctions_.size(), [](uint16_t i) { return cmdfunctions_[i].hash_; });
 }
 
 // see if a command exists for that device type
 // is not case sensitive
+// the same command can be registered for several device ids and tags, so return the first registered one that matches
 Command::CmdFunction * Command::find_command(const uint8_t device_type, const uint8_t device_id, const char * cmd, const uint8_t flag) {
     if ((cmd == nullptr) || (strlen(cmd) == 0) || (cmdfunctions_.empty())) {
         return nullptr;
     }
 
-    for (auto & cf : cmdfunctions_) {
-        if (Helpers::toLower(cmd) == Helpers::toLower(cf.cmd_) && (cf.device_type_ == device_type) && (!device_id || cf.device_id_ == device_id)
-            && (flag == CommandFlag::CMD_FLAG_DEFAULT || (flag & 0x3F) == (cf.flags_ & 0x3F))) {
-            return &cf;
-        }
-    }
+    uint32_t hash  = cmd_hash(device_type, cmd);
+    int32_t  index = cmd_index_.find(hash, [&](uint16_t i) {
+        const auto & cf = cmdfunctions_[i];
+        return (cf.hash_ == hash) && (cf.device_type_ == device_type) && (!device_id || cf.device_id_ == device_id)
+               && (flag == CommandFlag::CMD_FLAG_DEFAULT || (flag & 0x3F) == (cf.flags_ & 0x3F)) && cmd_equals(cmd, cf.cmd_);
+    });
 
-    return nullptr; // command not found
+    return index < 0 ? nullptr : &cmdfunctions_[index]; // nullptr if command not found
 }
 
 void Command::erase_device_commands(const uint8_t device_type) {
@@ -492,6 +515,7 @@ void Command::erase_device_commands(const uint8_t device_type) {
             cmdfunctions_.erase(it);
         }
     } while (it-- > cmdfunctions_.begin());
+    cmd_index_.rebuild(cmdfunctions_.size(), [](uint16_t i) { return cmdfunctions_[i].hash_; });
 }
 
 void Command::erase_command(const uint8_t device_type, const char * cmd, uint8_t flag) {
@@ -500,8 +524,9 @@ void Command::erase_command(const uint8_t device_type, const char * cmd, uint8_t
     }
     auto it = cmdfunctions_.begin();
     for (auto const & cf : cmdfunctions_) {
-        if (Helpers::toLower(cmd) == Helpers::toLower(cf.cmd_) && (cf.device_type_ == device_type) && ((flag & 0x3F) == (cf.flags_ & 0x3F))) {
+        if (cmd_equals(cmd, cf.cmd_) && (cf.device_type_ == device_type) && ((flag & 0x3F) == (cf.flags_ & 0x3F))) {
             cmdfunctions_.erase(it);
+            cmd_index_.rebuild(cmdfunctions_.size(), [](uint16_t i) { return cmdfunctions_[i].hash_; });
             return;
         }
         it++;
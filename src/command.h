@@ -64,6 +64,7 @@ class Command {
         cmd_function_p       cmdfunction_;
         cmd_json_function_p  cmdfunction_json_;
         const char * const * description_;
+        uint32_t             hash_; // of device_type_ and the lowercase cmd_, see cmd_hash()
 
         CmdFunction(const uint8_t             device_type,
                     const uint8_t             device_id,
@@ -78,7 +79,8 @@ class Command {
             , cmd_(cmd)
             , cmdfunction_(cmdfunction)
             , cmdfunction_json_(cmdfunction_json)
-            , description_(description) {
+            , description_(description)
+            , hash_(cmd_hash(device_type, cmd)) {
         }
 
         inline void add_flags(uint8_t flags) {
@@ -95,10 +97,12 @@ class Command {
         }
     };
 
-    static std::vector<CmdFunction> commands() {
+    static const std::vector<CmdFunction> & commands() {
         return cmdfunctions_;
     }
 
+    static uint32_t cmd_hash(const uint8_t device_type, const char * cmd);
+
     static uint8_t call(const uint8_t device_type, const char * cmd, const char * value, const bool is_admin, const int8_t id, JsonObject output);
     static uint8_t call(const uint8_t device_type, const char * cmd, const char * value, const int8_t id = -1);
 
@@ -145,6 +149,10 @@ class Command {
 
     static std::vector<CmdFunction> cmdfunctions_; // the list of commands
 
+    static HashIndex cmd_index_; // on (device_type, lowercase cmd) to the position in cmdfunctions_
+
+    static void cmd_index_add();
+
     static uint8_t json_message(uint8_t error_code, const char * message, JsonObject output, const char * object = nullptr);
 };
 
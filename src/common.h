@@ -23,17 +23,18 @@
 
 using uuid::log::Level;
 
+// the arguments are only evaluated when the level is enabled, e.g. pretty_telegram() for every telegram at TRACE
 #if defined(EMSESP_DEBUG)
-#define LOG_DEBUG(...) logger_.debug(__VA_ARGS__)
+#define LOG_DEBUG(...) UUID_LOG_LAZY(logger_, Level::DEBUG, debug, __VA_ARGS__)
 #else
 #define LOG_DEBUG(...)
 #endif
 
-#define LOG_INFO(...) logger_.info(__VA_ARGS__)
-#define LOG_TRACE(...) logger_.trace(__VA_ARGS__)
-#define LOG_NOTICE(...) logger_.notice(__VA_ARGS__)
-#define LOG_WARNING(...) logger_.warning(__VA_ARGS__)
-#define LOG_ERROR(...) logger_.err(__VA_ARGS__)
+#define LOG_INFO(...) UUID_LOG_LAZY(logger_, Level::INFO, info, __VA_ARGS__)
+#define LOG_TRACE(...) UUID_LOG_LAZY(logger_, Level::TRACE, trace, __VA_ARGS__)
+#define LOG_NOTICE(...) UUID_LOG_LAZY(logger_, Level::NOTICE, notice, __VA_ARGS__)
+#define LOG_WARNING(...) UUID_LOG_LAZY(logger_, Level::WARNING, warning, __VA_ARGS__)
+#define LOG_ERROR(...) UUID_LOG_LAZY(logger_, Level::ERR, err, __VA_ARGS__)
 
 // flash strings
 using uuid::string_vector;
@@ -37,6 +37,10 @@
 #define EMSESP_DEFAULT_EMS_BUS_ID 0x0B // service key
 #endif
 
+#ifndef EMSESP_DEFAULT_FETCH_BUDGET
+#define EMSESP_DEFAULT_FETCH_BUDGET 0 // max. automatic read requests per minute, 0 fetches everything every minute
+#endif
+
 #ifndef EMSESP_DEFAULT_SYSLOG_ENABLED
 #define EMSESP_DEFAULT_SYSLOG_ENABLED false
 #endif
@@ -137,6 +141,10 @@
 #define EMSESP_DEFAULT_MODBUS_TIMEOUT 10000
 #endif
 
+#ifndef EMSESP_DEFAULT_MODBUS_STRICT
+#define EMSESP_DEFAULT_MODBUS_STRICT false
+#endif
+
 #ifndef EMSESP_DEFAULT_BOARD_PROFILE
 #define EMSESP_DEFAULT_BOARD_PROFILE "default"
 #endif
@@ -210,6 +218,10 @@
 #define EMSESP_DEFAULT_DISCOVERY_TYPE 0 // HA
 #endif
 
+#ifndef EMSESP_DEFAULT_DISCOVERY_BUDGET
+#define EMSESP_DEFAULT_DISCOVERY_BUDGET 10 // discovery configs per loop
+#endif
+
 #ifndef EMSESP_DEFAULT_PUBLISH_SINGLE
 #define EMSESP_DEFAULT_PUBLISH_SINGLE false
 #endif
@@ -218,6 +230,10 @@
 #define EMSESP_DEFAULT_PUBLISH_SINGLE2CMD false
 #endif
 
+#ifndef EMSESP_DEFAULT_PUBLISH_CHANGES
+#define EMSESP_DEFAULT_PUBLISH_CHANGES false
+#endif
+
 #ifndef EMSESP_DEFAULT_SEND_RESPONSE
 #define EMSESP_DEFAULT_SEND_RESPONSE false
 #endif
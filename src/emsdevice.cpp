@@ -339,13 +339,41 @@ void EMSdevice::fetch_values() {
     EMSESP::logger().debug("Fetching values for deviceID 0x%02X", device_id());
 #endif
 
-    for (const auto & tf : telegram_functions_) {
+    for (auto & tf : telegram_functions_) {
         if (tf.fetch_) {
+            tf.last_fetch_ = uuid::get_uptime_sec();
             read_command(tf.telegram_type_id_);
         }
     }
 }
 
+// request the telegrams that are due for an automatic fetch, at most max of them, returns the number requested
+// a telegram that arrived within its interval, like the ones the master broadcasts, doesn't need to be fetched.
+// the interval is halved if the values changed since the last fetch and doubled if not, between FETCH_INTERVAL_MIN and _MAX
+uint8_t EMSdevice::fetch_due(const uint32_t now, const uint8_t max) {
+    if (!active_) {
+        return 0;
+    }
+
+    uint8_t count = 0;
+    for (auto & tf : telegram_functions_) {
+        if (count >= max) {
+            break;
+        }
+        if (!tf.fetch_ || now - std::max(tf.last_received_, tf.last_fetch_) < tf.interval_) {
+            continue;
+        }
+        if (tf.last_fetch_) {
+            tf.interval_ = tf.changed_ ? std::max<uint16_t>(tf.interval_ / 2, FETCH_INTERVAL_MIN) : std::min<uint16_t>(tf.interval_ * 2, FETCH_INTERVAL_MAX);
+        }
+        tf.changed_    = false;
+        tf.last_fetch_ = now;
+        read_command(tf.telegram_type_id_);
+        count++;
+    }
+    return count;
+}
+
 // toggle on/off automatic fetch for a telegramID
 void EMSdevice::toggle_fetch(uint16_t telegram_id, bool toggle) {
 #if defined(EMSESP_DEBUG)
@@ -381,8 +409,18 @@ bool EMSdevice::is_received(uint16_t telegram_id) const {
 
 // check for a tag to create a nest
 bool EMSdevice::has_tags(const int8_t tag) const {
+    if (tag < DeviceValueTAG::TAG_HC1 || tag > DeviceValueTAG::TAG_HS16) {
+        return false;
+    }
+    return dv_tag_start_[tag + 2] > dv_tag_start_[tag + 1];
+}
+
+// true if the nested export_values() has a value of this device
+// same checks as generate_values(), without updating the active states
+bool EMSdevice::has_export_values() const {
     for (const auto & dv : devicevalues_) {
-        if (dv.tag == tag && tag >= DeviceValueTAG::TAG_HC1) {
+        if (dv.hasValue() && dv.tag >= DeviceValueTAG::TAG_DEVICE_DATA && dv.tag <= DeviceValueTAG::TAG_HS16
+            && !dv.has_state(DeviceValueState::DV_API_MQTT_EXCLUDE) && dv.has_fullname()) {
             return true;
         }
     }
@@ -475,6 +513,32 @@ void EMSdevice::show_telegram_handlers(uuid::console::Shell & shell) const {
         shell.printf("0x%02X ", handlers);
     }
     shell.println();
+    char intervals[500];
+    shell.printfln(" Fetch intervals (seconds): %s", show_fetch_intervals(intervals, sizeof(intervals)));
+}
+
+// list the fetched telegram type IDs with their current fetch interval in seconds, or bc if the telegram is broadcasted
+char * EMSdevice::show_fetch_intervals(char * result, const size_t len) const {
+    strlcpy(result, "", len);
+
+    auto now = uuid::get_uptime_sec();
+    for (const auto & tf : telegram_functions_) {
+        if (tf.fetch_) {
+            char interval[16];
+            if (tf.unsolicited_ && now - tf.last_received_ < tf.interval_) {
+                strlcpy(interval, ":bc", sizeof(interval));
+            } else {
+                snprintf(interval, sizeof(interval), ":%d", tf.interval_);
+            }
+            if (result[0] != '\0') {
+                strlcat(result, " ", len);
+            }
+            strlcat(result, Helpers::hextoa(tf.telegram_type_id_, true).c_str(), len);
+            strlcat(result, interval, len);
+        }
+    }
+
+    return result;
 }
 
 // list all the telegram type IDs for this device, outputting to a string (max size 200)
@@ -522,6 +586,156 @@ void EMSdevice::show_mqtt_handlers(uuid::console::Shell & shell) const {
 // register a callback function for a specific telegram type
 void EMSdevice::register_telegram_type(const uint16_t telegram_type_id, const char * telegram_type_name, bool fetch, const process_function_p f) {
     telegram_functions_.emplace_back(telegram_type_id, telegram_type_name, fetch, false, f);
+    EMSESP::invalidate_telegram_routes();
+}
+
+#if defined(EMSESP_STANDALONE)
+EMSdevice::DeviceValueIndexStats EMSdevice::dv_index_stats_ = {0, 0, 0, 0};
+#endif
+
+// hash of a value pointer, for dv_index_
+static inline uint32_t dv_value_hash(const void * value_p) {
+    return Helpers::hash32((uint32_t)(uintptr_t)value_p);
+}
+
+// hash of a shortname seeded with the tag, for dv_name_index_ and customization_index_
+static inline uint32_t dv_name_hash(uint8_t tag, const char * shortname) {
+    return Helpers::hash32(shortname, strlen(shortname), tag);
+}
+
+// call f(index) for every device value that points to value_p
+// multiple entities can share the same value pointer, so continue until an empty slot
+template <typename F>
+void EMSdevice::dv_index_find(const void * value_p, F f) const {
+#if defined(EMSESP_STANDALONE)
+    dv_index_stats_.lookups++;
+    dv_index_stats_.linear_compares += devicevalues_.size();
+#endif
+
+    dv_index_.find(dv_value_hash(value_p), [&](uint16_t index) {
+#if defined(EMSESP_STANDALONE)
+        dv_index_stats_.probes++;
+#endif
+        if (devicevalues_[index].value_p == value_p) {
+#if defined(EMSESP_STANDALONE)
+            dv_index_stats_.matches++;
+#endif
+            f(index);
+        }
+        return false;
+    });
+}
+
+// returns the position in devicevalues_ of the first entity registered with value_p, or -1 if not found
+int16_t EMSdevice::dv_index_first(const void * value_p) const {
+    int16_t found = -1;
+    dv_index_find(value_p, [&](uint16_t index) {
+        if (found < 0) {
+            found = index;
+        }
+    });
+    return found;
+}
+
+// returns the position in devicevalues_ of the first entity with this tag and shortname, or -1 if not found
+// the index is built on the first lookup
+int16_t EMSdevice::dv_name_index_find(uint8_t tag, const char * shortname) {
+    if (dv_name_index_.empty()) {
+        dv_name_index_.rebuild(devicevalues_.size(), [&](uint16_t i) { return dv_name_hash(devicevalues_[i].tag, devicevalues_[i].short_name); });
+    }
+
+    return dv_name_index_.find(dv_name_hash(tag, shortname), [&](uint16_t index) {
+        return devicevalues_[index].tag == tag && !strcmp(devicevalues_[index].short_name, shortname);
+    });
+}
+
+// split an entity customization "<mask in hex>[tag/]shortname[|custom fullname]"
+// returns false if it's too short or the tag is unknown
+bool EMSdevice::parse_customization(const std::string & entity_id, CustomizationEntity & entity) {
+    if (entity_id.size() < 3) {
+        return false;
+    }
+    auto   custom_name_pos = entity_id.find('|');
+    size_t end             = (custom_name_pos == std::string::npos) ? entity_id.size() : custom_name_pos;
+    size_t start           = 2;
+    auto   slash           = entity_id.find('/', start);
+
+    entity.tag = DeviceValueTAG::TAG_DEVICE_DATA;
+    if (slash < end) {
+        entity.tag = DeviceValueTAG::TAG_NONE;
+        for (uint8_t tag = DeviceValueTAG::TAG_HC1; tag < DeviceValue::NUM_TAGS; tag++) {
+            const char * tag_s = tag_to_mqtt(tag);
+            if (strlen(tag_s) == slash - start && !entity_id.compare(start, slash - start, tag_s)) {
+                entity.tag = tag;
+                break;
+            }
+        }
+        if (entity.tag == DeviceValueTAG::TAG_NONE) {
+            return false;
+        }
+        start = slash + 1;
+    }
+
+    char mask[3] = {entity_id[0], entity_id[1], '\0'}; // first 2 characters are the mask flags in hex
+    entity.mask  = Helpers::hextoint(mask);
+    entity.shortname.assign(entity_id, start, end - start);
+    entity.has_custom_name = (custom_name_pos != std::string::npos);
+    if (entity.has_custom_name) {
+        entity.custom_fullname.assign(entity_id, custom_name_pos + 1, std::string::npos);
+    } else {
+        entity.custom_fullname.clear();
+    }
+    return true;
+}
+
+// returns the customization of the entity with this tag and shortname, or nullptr if it has none
+// the customizations of this device are parsed once and only again after they have been changed
+const EMSdevice::CustomizationEntity * EMSdevice::customization_find(int8_t tag, const char * shortname) {
+    if (customization_version_ != WebCustomizationService::version()) {
+        customization_version_ = WebCustomizationService::version();
+        customizations_.clear();
+        EMSESP::webCustomizationService.read([&](WebCustomization & settings) {
+            for (const auto & entityCustomization : settings.entityCustomizations) {
+                if ((entityCustomization.product_id == product_id()) && (entityCustomization.device_id == device_id())) {
+                    CustomizationEntity entity;
+                    for (const std::string & entity_id : entityCustomization.entity_ids) {
+                        if (parse_customization(entity_id, entity)) {
+                            customizations_.push_back(entity);
+                        }
+                    }
+                }
+            }
+        });
+        customizations_.shrink_to_fit();
+
+        customization_index_.clear();
+        if (!customizations_.empty()) {
+            customization_index_.rebuild(customizations_.size(),
+                                         [&](uint16_t i) { return dv_name_hash(customizations_[i].tag, customizations_[i].shortname.c_str()); });
+        }
+    }
+
+    if (customization_index_.empty()) {
+        return nullptr;
+    }
+
+    // all tags below hc1 are written without a tag
+    if (tag < DeviceValueTAG::TAG_HC1) {
+        tag = DeviceValueTAG::TAG_DEVICE_DATA;
+    }
+    auto index = customization_index_.find(dv_name_hash(tag, shortname), [&](uint16_t i) {
+        return customizations_[i].tag == tag && customizations_[i].shortname == shortname;
+    });
+    return index < 0 ? nullptr : &customizations_[index];
+}
+
+// add the device value at position index in devicevalues_ to the end of its tag bucket
+void EMSdevice::dv_tag_add(uint16_t index) {
+    uint8_t bucket = devicevalues_[index].tag + 1;
+    dv_tag_order_.insert(dv_tag_order_.begin() + dv_tag_start_[bucket + 1], index);
+    for (uint8_t b = bucket + 1; b < sizeof(dv_tag_start_) / sizeof(dv_tag_start_[0]); b++) {
+        dv_tag_start_[b]++;
+    }
 }
 
 // add to device value library, also know now as a "device entity"
@@ -580,40 +794,13 @@ void EMSdevice::add_device_value(int8_t                tag,              // to b
         fullname = &name[1]; // translations start at index 1
     }
 
-    // scan through customizations to see if it's on the exclusion list by matching the productID and deviceID
-    EMSESP::webCustomizationService.read([&](WebCustomization & settings) {
-        for (EntityCustomization entityCustomization : settings.entityCustomizations) {
-            if ((entityCustomization.product_id == product_id()) && (entityCustomization.device_id == device_id())) {
-                char entity[70];
-                if (tag < DeviceValueTAG::TAG_HC1) {
-                    strncpy(entity, short_name, sizeof(entity));
-                } else {
-                    snprintf(entity, sizeof(entity), "%s/%s", tag_to_mqtt(tag), short_name);
-                }
-
-                for (const std::string & entity_id : entityCustomization.entity_ids) {
-                    // if there is an appended custom name, strip it to get the true entity name
-                    // and extract the new custom name
-                    auto        custom_name_pos = entity_id.find('|');
-                    bool        has_custom_name = (custom_name_pos != std::string::npos);
-                    std::string shortname       = has_custom_name ? entity_id.substr(2, custom_name_pos - 2) : entity_id.substr(2);
-
-                    // we found the device entity
-                    if (shortname == entity) {
-                        // get Mask
-                        uint8_t mask = Helpers::hextoint(entity_id.substr(0, 2).c_str());
-                        state        = mask << 4;             // set state high bits to flag, turn off active and ha flags
-                        ignore       = (mask & 0x80) == 0x80; // do not register
-                        // see if there is a custom name in the entity string
-                        if (has_custom_name) {
-                            custom_fullname = entity_id.substr(custom_name_pos + 1);
-                        }
-                        break;
-                    }
-                }
-            }
-        }
-    });
+    // see if it's on the exclusion list or has a mask or custom name in the customizations of this device
+    auto customization = customization_find(tag, short_name);
+    if (customization) {
+        state           = customization->mask << 4;             // set state high bits to flag, turn off active and ha flags
+        ignore          = (customization->mask & 0x80) == 0x80; // do not register
+        custom_fullname = customization->custom_fullname;
+    }
 
     if (ignore) {
         return;
@@ -622,6 +809,14 @@ void EMSdevice::add_device_value(int8_t                tag,              // to b
     // add the device entity
     devicevalues_.emplace_back(
         device_type_, tag, value_p, type, options, options_single, numeric_operator, short_name, fullname, custom_fullname, uom, has_cmd, min, max, state);
+    dv_index_.add(devicevalues_.size() - 1, devicevalues_.size(), [&](uint16_t i) { return dv_value_hash(devicevalues_[i].value_p); });
+    dv_tag_add(devicevalues_.size() - 1);
+    if (!dv_name_index_.empty()) {
+        dv_name_index_.add(devicevalues_.size() - 1, devicevalues_.size(), [&](uint16_t i) {
+            return dv_name_hash(devicevalues_[i].tag, devicevalues_[i].short_name);
+        });
+    }
+    dv_changed_.resize((devicevalues_.size() + 31) / 32, 0);
 
     // add a new command if it has a function attached
     if (has_cmd) {
@@ -740,12 +935,8 @@ void EMSdevice::register_device_value(int8_t tag, void * value_p, uint8_t type,
 
 // check if value is readable via mqtt/api
 bool EMSdevice::is_readable(const void * value_p) const {
-    for (const auto & dv : devicevalues_) {
-        if (dv.value_p == value_p) {
-            return !dv.has_state(DeviceValueState::DV_API_MQTT_EXCLUDE);
-        }
-    }
-    return false;
+    int16_t found = dv_index_first(value_p);
+    return (found >= 0) && !devicevalues_[found].has_state(DeviceValueState::DV_API_MQTT_EXCLUDE);
 }
 
 // check if value/command is readonly
@@ -762,47 +953,79 @@ bool EMSdevice::is_readonly(const std::string & cmd, const int8_t id) const {
 
 // check if value has a registered command
 bool EMSdevice::has_command(const void * value_p) const {
-    for (const auto & dv : devicevalues_) {
-        if (dv.value_p == value_p) {
-            return dv.has_cmd && !dv.has_state(DeviceValueState::DV_READONLY);
-        }
-    }
-    return false;
+    int16_t found = dv_index_first(value_p);
+    return (found >= 0) && devicevalues_[found].has_cmd && !devicevalues_[found].has_state(DeviceValueState::DV_READONLY);
 }
 
 // set min and max
 void EMSdevice::set_minmax(const void * value_p, int16_t min, uint32_t max) {
-    for (auto & dv : devicevalues_) {
-        if (dv.value_p == value_p) {
-            dv.min = min;
-            dv.max = max;
-            dv.set_custom_minmax(); // custom priority
-            return;
+    int16_t found = dv_index_first(value_p);
+    if (found >= 0) {
+        auto & dv = devicevalues_[found];
+        dv.min    = min;
+        dv.max    = max;
+        dv.set_custom_minmax(); // custom priority
+    }
+}
+
+// copies a cached topic prefix followed by the shortname into buf
+static void join_topic(char * buf, size_t size, const std::string & prefix, const char * shortname) {
+    size_t len = std::min(prefix.size(), size - 1);
+    memcpy(buf, prefix.data(), len);
+    strlcpy(buf + len, shortname, size - len);
+}
+
+// returns the cached topic prefixes for a tag, all tags below HC1 share the same ones
+const EMSdevice::TopicPrefix & EMSdevice::topic_prefix(int8_t tag) {
+    if (tag < DeviceValueTAG::TAG_HC1) {
+        tag = DeviceValueTAG::TAG_DEVICE_DATA;
+    }
+
+    if (topic_prefixes_version_ != Mqtt::topics_version()) {
+        topic_prefixes_.clear();
+        topic_prefixes_version_ = Mqtt::topics_version();
+    }
+
+    for (const auto & prefix : topic_prefixes_) {
+        if (prefix.tag == tag) {
+            return prefix;
         }
     }
+
+    TopicPrefix prefix;
+    prefix.tag = tag;
+    prefix.cmd = std::string(device_type_2_device_name(device_type_)) + "/";
+    if (tag >= DeviceValueTAG::TAG_HC1) {
+        prefix.cmd += std::string(tag_to_mqtt(tag)) + "/";
+    }
+
+    prefix.state = Mqtt::base() + "/";
+    if (Mqtt::publish_single2cmd()) {
+        prefix.state += prefix.cmd;
+    } else if (Mqtt::is_nested() && tag >= DeviceValueTAG::TAG_HC1) {
+        prefix.state += Mqtt::tag_to_topic(device_type_, tag) + "/" + tag_to_mqtt(tag) + "/";
+    } else {
+        prefix.state += Mqtt::tag_to_topic(device_type_, tag) + "/";
+    }
+
+    topic_prefixes_.push_back(std::move(prefix));
+    return topic_prefixes_.back();
 }
 
 // publish a single value on change
-void EMSdevice::publish_value(void * value_p) const {
+// the device values are looked up by their value pointer through the index, not by scanning devicevalues_
+void EMSdevice::publish_value(void * value_p) {
     // if (!Mqtt::publish_single() || value_p == nullptr) {
     if (value_p == nullptr) {
         return;
     }
 
-    for (const auto & dv : devicevalues_) {
-        if (dv.value_p == value_p && !dv.has_state(DeviceValueState::DV_API_MQTT_EXCLUDE)) {
-            char topic[Mqtt::MQTT_TOPIC_MAX_SIZE];
-            if (Mqtt::publish_single2cmd()) {
-                if (dv.tag >= DeviceValueTAG::TAG_HC1) {
-                    snprintf(topic, sizeof(topic), "%s/%s/%s", device_type_2_device_name(device_type_), tag_to_mqtt(dv.tag), dv.short_name);
-                } else {
-                    snprintf(topic, sizeof(topic), "%s/%s", device_type_2_device_name(device_type_), (dv.short_name));
-                }
-            } else if (Mqtt::is_nested() && dv.tag >= DeviceValueTAG::TAG_HC1) {
-                snprintf(topic, sizeof(topic), "%s/%s/%s", Mqtt::tag_to_topic(device_type_, dv.tag).c_str(), tag_to_mqtt(dv.tag), dv.short_name);
-            } else {
-                snprintf(topic, sizeof(topic), "%s/%s", Mqtt::tag_to_topic(device_type_, dv.tag).c_str(), dv.short_name);
-            }
+    dv_index_find(value_p, [&](uint16_t index) {
+        dv_changed_[index >> 5] |= (1UL << (index & 31)); // for the next publish of changes
+
+        const auto & dv = devicevalues_[index];
+        if (!dv.has_state(DeviceValueState::DV_API_MQTT_EXCLUDE)) {
+            const auto & prefix = topic_prefix(dv.tag);
 
             int8_t num_op = dv.numeric_operator;
 
@@ -854,20 +1077,26 @@ void EMSdevice::publish_value(void * value_p) const {
             }
 
             if (Mqtt::publish_single() && payload[0] != '\0') {
-                Mqtt::queue_publish(topic, payload);
+                char topic[Mqtt::MQTT_TOPIC_MAX_SIZE];
+                join_topic(topic, sizeof(topic), prefix.state, dv.short_name);
+                Mqtt::queue_publish_value(topic, payload);
             }
             // check scheduler for on change
             char cmd[COMMAND_MAX_LENGTH];
-            if (dv.tag >= DeviceValueTAG::TAG_HC1) {
-                snprintf(cmd, sizeof(cmd), "%s/%s/%s", device_type_2_device_name(device_type_), tag_to_mqtt(dv.tag), dv.short_name);
-            } else {
-                snprintf(cmd, sizeof(cmd), "%s/%s", device_type_2_device_name(device_type_), (dv.short_name));
-            }
+            join_topic(cmd, sizeof(cmd), prefix.cmd, dv.short_name);
             EMSESP::webSchedulerService.onChange(cmd);
         }
-    }
+    });
 }
 
+#if defined(EMSESP_STANDALONE)
+void EMSdevice::publish_value_topics(const int8_t tag, const char * shortname, std::string & topic, std::string & cmd) {
+    const auto & prefix = topic_prefix(tag);
+    topic               = prefix.state + shortname;
+    cmd                 = prefix.cmd + shortname;
+}
+#endif
+
 // looks up the UOM for a given key from the device value table
 std::string EMSdevice::get_value_uom(const std::string & shortname) const {
     for (const auto & dv : devicevalues_) {
@@ -897,16 +1126,24 @@ bool EMSdevice::export_values(uint8_t device_type, JsonObject output, const int8
 
     // for nested output add for each tag
     for (int8_t tag = DeviceValueTAG::TAG_DEVICE_DATA; tag <= DeviceValueTAG::TAG_HS16; tag++) {
-        JsonObject output_hc    = output;
-        bool       nest_created = false;
-        for (const auto & emsdevice : EMSESP::emsdevices) {
-            if (emsdevice && (emsdevice->device_type() == device_type)) {
-                if (!nest_created && emsdevice->has_tags(tag)) {
-                    output_hc    = output[EMSdevice::tag_to_mqtt(tag)].to<JsonObject>();
-                    nest_created = true;
-                }
-                has_value |= emsdevice->generate_values(output_hc, tag, true, output_target); // use nested for id -1 and 0
+        has_value |= export_values_tag(device_type, output, tag, output_target);
+    }
+    return has_value;
+}
+
+// nested output of one tag, for all devices of the type. The values of hc, dhw, etc. go in a nested object
+// called for each tag by export_values() and by the streamed API responses
+bool EMSdevice::export_values_tag(uint8_t device_type, JsonObject output, const int8_t tag, const uint8_t output_target) {
+    bool       has_value    = false;
+    JsonObject output_hc    = output;
+    bool       nest_created = false;
+    for (const auto & emsdevice : EMSESP::emsdevices) {
+        if (emsdevice && (emsdevice->device_type() == device_type)) {
+            if (!nest_created && emsdevice->has_tags(tag)) {
+                output_hc    = output[EMSdevice::tag_to_mqtt(tag)].to<JsonObject>();
+                nest_created = true;
             }
+            has_value |= emsdevice->generate_values(output_hc, tag, true, output_target); // use nested for id -1 and 0
         }
     }
     return has_value;
@@ -1183,61 +1420,64 @@ void EMSdevice::set_climate_minmax(int8_t tag, int16_t min, uint32_t max) {
 }
 
 // set mask per device entity based on the id which is prefixed with the 2 char hex mask value
-// returns true if the entity has a mask set (not 0 the default)
+// the entity is looked up by tag and shortname, so applying a list of customizations doesn't scan all entities for each
 void EMSdevice::setCustomizationEntity(const std::string & entity_id) {
-    for (auto & dv : devicevalues_) {
-        char entity_name[70];
-        if (dv.tag < DeviceValueTAG::TAG_HC1) {
-            strncpy(entity_name, dv.short_name, sizeof(entity_name));
-        } else {
-            snprintf(entity_name, sizeof(entity_name), "%s/%s", tag_to_mqtt(dv.tag), dv.short_name);
-        }
-
-        // extra shortname
-        auto        custom_name_pos = entity_id.find('|');
-        bool        has_custom_name = (custom_name_pos != std::string::npos);
-        std::string shortname       = has_custom_name ? entity_id.substr(2, custom_name_pos - 2) : entity_id.substr(2);
-
-        if (entity_name == shortname) {
-            // check the masks
-            uint8_t current_mask = dv.state >> 4;
-            uint8_t new_mask     = Helpers::hextoint(entity_id.substr(0, 2).c_str()); // first character contains mask flags
+    CustomizationEntity entity;
+    if (!parse_customization(entity_id, entity)) {
+        return;
+    }
+    auto index = dv_name_index_find(entity.tag, entity.shortname.c_str());
+    if (index >= 0) {
+        apply_customization(devicevalues_[index], entity);
+    }
+}
 
-            // if it's a new mask, reconfigure HA
-            if (Mqtt::ha_enabled() && (has_custom_name || ((current_mask ^ new_mask) & (DeviceValueState::DV_READONLY >> 4)))) {
-                // remove ha config on change of dv_readonly flag
-                dv.remove_state(DeviceValueState::DV_HA_CONFIG_CREATED);
-                Mqtt::publish_ha_sensor_config(dv, "", "", true); // delete topic (remove = true)
-            }
+// set the mask and custom name of a device entity
+void EMSdevice::apply_customization(DeviceValue & dv, const CustomizationEntity & entity) {
+    // check the masks
+    uint8_t current_mask = dv.state >> 4;
+    uint8_t new_mask     = entity.mask;
 
-            // always write the mask
-            dv.state = ((dv.state & 0x0F) | (new_mask << 4)); // set state high bits to flag
+    // if it's a new mask, reconfigure HA
+    if (Mqtt::ha_enabled() && (entity.has_custom_name || ((current_mask ^ new_mask) & (DeviceValueState::DV_READONLY >> 4)))) {
+        // remove ha config on change of dv_readonly flag
+        dv.remove_state(DeviceValueState::DV_HA_CONFIG_CREATED);
+        Mqtt::publish_ha_sensor_config(dv, nullptr, true); // delete topic (remove = true)
+    }
 
-            // set the custom name if it has one, or clear it
-            if (has_custom_name) {
-                dv.custom_fullname = entity_id.substr(custom_name_pos + 1);
-            } else {
-                dv.custom_fullname = "";
-            }
+    // always write the mask
+    dv.state = ((dv.state & 0x0F) | (new_mask << 4)); // set state high bits to flag
 
-            auto min = dv.min;
-            auto max = dv.max;
+    // set the custom name if it has one, or clear it
+    dv.custom_fullname = entity.custom_fullname;
 
-            // set the min / max
-            dv.set_custom_minmax();
+    auto min = dv.min;
+    auto max = dv.max;
 
-            if (Mqtt::ha_enabled() && dv.short_name == FL_(seltemp)[0] && (min != dv.min || max != dv.max)) {
-                set_climate_minmax(dv.tag, dv.min, dv.max);
-            }
+    // set the min / max
+    dv.set_custom_minmax();
 
-            return;
-        }
+    if (Mqtt::ha_enabled() && dv.short_name == FL_(seltemp)[0] && (min != dv.min || max != dv.max)) {
+        set_climate_minmax(dv.tag, dv.min, dv.max);
     }
 }
 
 // populate a string vector with entities that have masks set or have a custom entity name
 void EMSdevice::getCustomizationEntities(std::vector<std::string> & entity_ids) {
+    // the names already in the list, sorted to look them up
+    std::vector<std::string> names;
+    names.reserve(entity_ids.size());
+    for (const auto & eid : entity_ids) {
+        names.push_back(DeviceValue::get_name(eid));
+    }
+    std::sort(names.begin(), names.end());
+
     for (const auto & dv : devicevalues_) {
+        uint8_t mask = dv.state >> 4;
+        if (!mask && dv.custom_fullname.empty()) {
+            continue;
+        }
+
         char name[100];
         name[0] = '\0';
         if (dv.tag >= DeviceValueTAG::TAG_HC1) {
@@ -1248,15 +1488,7 @@ void EMSdevice::getCustomizationEntities(std::vector<std::string> & entity_ids)
         strcat(name, dv.short_name);
         std::string entity_name = name;
 
-        uint8_t mask   = dv.state >> 4;
-        bool    is_set = false;
-        for (auto & eid : entity_ids) {
-            if (DeviceValue::get_name(eid) == entity_name) {
-                is_set = true;
-                break;
-            }
-        }
-        if (!is_set && (mask || !dv.custom_fullname.empty())) {
+        if (!std::binary_search(names.begin(), names.end(), entity_name)) {
             if (dv.custom_fullname.empty()) {
                 entity_ids.push_back(Helpers::hextoa(mask, false) + entity_name);
             } else {
@@ -1513,6 +1745,71 @@ bool EMSdevice::get_value_info(JsonObject output, const char * cmd, const int8_t
     return false; // not found, but don't return a message error yet
 }
 
+// returns the position in devicevalues_ of the entity get_value_info() would return for this shortname and tag, or -1
+int16_t EMSdevice::find_device_value(const char * shortname, const int8_t tag) const {
+    for (uint16_t i = 0; i < devicevalues_.size(); i++) {
+        const auto & dv = devicevalues_[i];
+        if (!strcasecmp(shortname, dv.short_name) && (tag <= 0 || tag == dv.tag)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// render the value of the entity at position index as text, the same as the "value" attribute from get_value_json()
+// returns a pointer to buf or to a constant string, or nullptr if the entity has no value
+const char * EMSdevice::get_value_string(const int16_t index, char * buf, const size_t len) const {
+    const auto & dv         = devicevalues_[index];
+    uint8_t      fahrenheit = !EMSESP::system_.fahrenheit() ? 0 : (dv.uom == DeviceValueUOM::DEGREES) ? 2 : (dv.uom == DeviceValueUOM::DEGREES_R) ? 1 : 0;
+
+    switch (dv.type) {
+    case DeviceValueType::ENUM:
+        if (*(uint8_t *)(dv.value_p) >= dv.options_size) {
+            return nullptr;
+        }
+        if (EMSESP::system_.enum_format() == ENUM_FORMAT_INDEX) {
+            return Helpers::smallitoa(buf, *(uint8_t *)(dv.value_p));
+        }
+        return Helpers::translated_word(dv.options[*(uint8_t *)(dv.value_p)]);
+
+    case DeviceValueType::UINT16:
+        return Helpers::hasValue(*(uint16_t *)(dv.value_p)) ? Helpers::render_value(buf, *(uint16_t *)(dv.value_p), dv.numeric_operator, fahrenheit) : nullptr;
+
+    case DeviceValueType::UINT8:
+        return Helpers::hasValue(*(uint8_t *)(dv.value_p)) ? Helpers::render_value(buf, *(uint8_t *)(dv.value_p), dv.numeric_operator, fahrenheit) : nullptr;
+
+    case DeviceValueType::INT16:
+        return Helpers::hasValue(*(int16_t *)(dv.value_p)) ? Helpers::render_value(buf, *(int16_t *)(dv.value_p), dv.numeric_operator, fahrenheit) : nullptr;
+
+    case DeviceValueType::INT8:
+        return Helpers::hasValue(*(int8_t *)(dv.value_p)) ? Helpers::render_value(buf, *(int8_t *)(dv.value_p), dv.numeric_operator, fahrenheit) : nullptr;
+
+    case DeviceValueType::UINT24:
+    case DeviceValueType::UINT32:
+    case DeviceValueType::TIME:
+        return Helpers::hasValue(*(uint32_t *)(dv.value_p)) ? Helpers::render_value(buf, *(uint32_t *)(dv.value_p), dv.numeric_operator) : nullptr;
+
+    case DeviceValueType::BOOL: {
+        if (!Helpers::hasValue(*(uint8_t *)(dv.value_p), EMS_VALUE_BOOL)) {
+            return nullptr;
+        }
+        auto value_b = (bool)*(uint8_t *)(dv.value_p);
+        if (EMSESP::system_.bool_format() == BOOL_FORMAT_TRUEFALSE) {
+            return value_b ? "true" : "false";
+        } else if (EMSESP::system_.bool_format() == BOOL_FORMAT_10) {
+            return value_b ? "1" : "0";
+        }
+        return len >= 12 ? Helpers::render_boolean(buf, value_b) : nullptr;
+    }
+
+    case DeviceValueType::STRING:
+        return Helpers::hasValue((char *)(dv.value_p)) ? (const char *)(dv.value_p) : nullptr;
+
+    default:
+        return nullptr;
+    }
+}
+
 // build the json for a specific entity
 void EMSdevice::get_value_json(JsonObject json, DeviceValue & dv) {
     uint8_t fahrenheit = !EMSESP::system_.fahrenheit() ? 0 : (dv.uom == DeviceValueUOM::DEGREES) ? 2 : (dv.uom == DeviceValueUOM::DEGREES_R) ? 1 : 0;
@@ -1670,25 +1967,36 @@ void EMSdevice::publish_all_values() {
 // For each value in the device create the json object pair and add it to given json
 // return false if empty
 // this is used to create the MQTT payloads, Console messages and Web API call responses
-bool EMSdevice::generate_values(JsonObject output, const int8_t tag_filter, const bool nested, const uint8_t output_target) {
+// with changed_only set, only entities changed since the last clear_changes() are added
+bool EMSdevice::generate_values(JsonObject output, const int8_t tag_filter, const bool nested, const uint8_t output_target, const bool changed_only) {
     bool       has_values = false; // to see if we've added a value. it's faster than doing a json.size() at the end
     uint8_t    old_tag    = 255;   // NAN
     JsonObject json       = output;
 
-    for (auto & dv : devicevalues_) {
+    // with a tag filter only walk that tag's bucket. Callers loop over all tags, so the active states of all entities still get updated
+    bool     bucketed = (tag_filter > DeviceValueTAG::TAG_NONE && tag_filter <= DeviceValueTAG::TAG_HS16);
+    uint16_t begin    = bucketed ? dv_tag_start_[tag_filter + 1] : 0;
+    uint16_t end      = bucketed ? dv_tag_start_[tag_filter + 2] : devicevalues_.size();
+
+    for (uint16_t i = begin; i < end; i++) {
+        uint16_t index = bucketed ? dv_tag_order_[i] : i;
+        auto &   dv    = devicevalues_[index];
+
         // check if it exists, there is a value for the entity. Set the flag to ACTIVE
         // not that this will override any previously removed states
         (dv.hasValue()) ? dv.add_state(DeviceValueState::DV_ACTIVE) : dv.remove_state(DeviceValueState::DV_ACTIVE);
 
-        auto fullname = dv.get_fullname();
+        if (changed_only && !dv_changed(index)) {
+            continue;
+        }
 
         // check conditions:
         //  1. it must have a valid value (state is active)
         //  2. it must have a visible flag
         //  3. it must match the given tag filter or have an empty tag
         //  4. it must not have the exclude flag set or outputs to console
-        if (dv.has_state(DeviceValueState::DV_ACTIVE) && !fullname.empty() && (tag_filter == DeviceValueTAG::TAG_NONE || tag_filter == dv.tag)
-            && (output_target == OUTPUT_TARGET::CONSOLE || !dv.has_state(DeviceValueState::DV_API_MQTT_EXCLUDE))) {
+        if (dv.has_state(DeviceValueState::DV_ACTIVE) && (tag_filter == DeviceValueTAG::TAG_NONE || tag_filter == dv.tag)
+            && (output_target == OUTPUT_TARGET::CONSOLE || !dv.has_state(DeviceValueState::DV_API_MQTT_EXCLUDE)) && dv.has_fullname()) {
             has_values = true; // flagged if we actually have data
 
             // we have a tag if it matches the filter given, and that the tag name is not empty/""
@@ -1698,6 +2006,7 @@ bool EMSdevice::generate_values(JsonObject output, const int8_t tag_filter, cons
             char name[80];
 
             if (output_target == OUTPUT_TARGET::API_VERBOSE || output_target == OUTPUT_TARGET::CONSOLE) {
+                auto fullname = dv.get_fullname();
                 // char short_name[20];
                 // if (output_target == OUTPUT_TARGET::CONSOLE) {
                 //     snprintf(short_name, sizeof(short_name), "(%s)", dv.short_name);
@@ -1838,14 +2147,28 @@ bool EMSdevice::generate_values(JsonObject output, const int8_t tag_filter, cons
 
 // create the Home Assistant configs for each device value / entity
 // this is called when an MQTT publish is done via an EMS Device in emsesp.cpp::publish_device_values()
+// and from EMSESP::ha_discovery_loop() for the configs that didn't fit in the budget of that publish
 void EMSdevice::mqtt_ha_entity_config_create() {
     bool     create_device_config = !ha_config_done(); // do we need to create the main Discovery device config with this entity?
     uint16_t count                = 0;
+    bool     complete             = true;
+
+    // the "dev" section is the same for all entities of this device, render it once
+    if (ha_dev_json_version_ != Mqtt::topics_version()) {
+        ha_dev_json_         = Mqtt::ha_device_json(device_type_);
+        ha_dev_json_version_ = Mqtt::topics_version();
+    }
 
     // check the state of each of the device values
     // create climate if roomtemp is visible
     // create the discovery topic if if hasn't already been created, not a command (like reset) and is active and visible
     for (auto & dv : devicevalues_) {
+        // the budget is used up by the configs queued, also failed ones, and allows at least one per loop
+        if (!Mqtt::ha_budget_left()) {
+            complete = false;
+            break;
+        }
+
         if (!strcmp(dv.short_name, FL_(haclimate)[0]) && !dv.has_state(DeviceValueState::DV_API_MQTT_EXCLUDE) && dv.has_state(DeviceValueState::DV_ACTIVE)) {
             if (*(int8_t *)(dv.value_p) == 1 && (!dv.has_state(DeviceValueState::DV_HA_CONFIG_CREATED) || dv.has_state(DeviceValueState::DV_HA_CLIMATE_NO_RT))) {
                 if (Mqtt::publish_ha_climate_config(dv.tag, true, false, dv.min, dv.max)) { // roomTemp
@@ -1866,14 +2189,20 @@ void EMSdevice::mqtt_ha_entity_config_create() {
         if (!dv.has_state(DeviceValueState::DV_HA_CONFIG_CREATED) && dv.has_state(DeviceValueState::DV_ACTIVE)
             && !dv.has_state(DeviceValueState::DV_API_MQTT_EXCLUDE)) {
             // create_device_config is only done once for the EMS device. It can added to any entity, so we take the first
-            if (Mqtt::publish_ha_sensor_config(dv, name().c_str(), brand_to_char(), false, create_device_config)) {
+            bool created;
+            if (create_device_config) {
+                created = Mqtt::publish_ha_sensor_config(dv, Mqtt::ha_device_json(device_type_, name().c_str(), brand_to_char()).c_str(), false);
+            } else {
+                created = Mqtt::publish_ha_sensor_config(dv, ha_dev_json_.c_str(), false);
+            }
+            if (created) {
                 dv.add_state(DeviceValueState::DV_HA_CONFIG_CREATED);
                 create_device_config = false; // only create the main config once
                 count++;
             }
 #ifndef EMSESP_STANDALONE
-            // always create minimum one config
             if (count && (heap_caps_get_free_size(MALLOC_CAP_8BIT) < 65 * 1024)) { // checks free Heap+PSRAM
+                complete = false;
                 break;
             }
 #endif
@@ -1885,6 +2214,7 @@ void EMSdevice::mqtt_ha_entity_config_create() {
     }
 #endif
     ha_config_done(!create_device_config);
+    ha_discovery_ = complete ? HADiscovery::HA_DISCOVERY_DONE : HADiscovery::HA_DISCOVERY_PENDING;
 }
 
 // remove all config topics in HA
@@ -1894,6 +2224,7 @@ void EMSdevice::ha_config_clear() {
     }
 
     ha_config_done(false); // this will force the recreation of the main HA device config
+    ha_discovery_ = HADiscovery::HA_DISCOVERY_WAITING;
 }
 
 bool EMSdevice::has_telegram_id(uint16_t id) const {
@@ -1923,38 +2254,42 @@ const char * EMSdevice::telegram_type_name(std::shared_ptr<const Telegram> teleg
     return "";
 }
 
-// take a telegram_type_id and call the matching handler
-// return true if match found
-bool EMSdevice::handle_telegram(std::shared_ptr<const Telegram> telegram) {
-    for (auto & tf : telegram_functions_) {
-        if (tf.telegram_type_id_ == telegram->type_id) {
-            // for telegram desitnation only read telegram
-            if (telegram->dest == device_id_ && telegram->message_length > 0) {
-                tf.process_function_(telegram);
-                return true;
-            }
-            // if the data block is empty and we have not received data before, assume that this telegram
-            // is not recognized by the bus master. So remove it from the automatic fetch list
-            if (telegram->message_length == 0 && telegram->offset == 0 && !tf.received_) {
-#if defined(EMSESP_DEBUG)
-                EMSESP::logger().debug("This telegram (%s) is not recognized by the EMS bus", tf.telegram_type_name_);
-#endif
-                // removing fetch after start causes issue: https://github.com/emsesp/EMS-ESP32/issues/1420
-                // continue retry the first 5 minutes, then disable (added 15.3.2024)
-                if (uuid::get_uptime_sec() > 600) {
-                    tf.fetch_ = false;
-                }
-                return false;
-            }
-            if (telegram->message_length > 0) {
-                tf.received_ = true;
-                tf.process_function_(telegram);
-            }
+// call the handler of the registered telegram function at tf_index, found via EMSESP's routing table
+// return true if the telegram was handled
+bool EMSdevice::handle_telegram(std::shared_ptr<const Telegram> telegram, const uint16_t tf_index) {
+    auto & tf = telegram_functions_[tf_index];
 
-            return true;
-        }
+    // for telegram desitnation only read telegram
+    if (telegram->dest == device_id_ && telegram->message_length > 0) {
+        tf.process_function_(telegram);
+        return true;
     }
-    return false; // type not found
+    // if the data block is empty and we have not received data before, assume that this telegram
+    // is not recognized by the bus master. So remove it from the automatic fetch list
+    if (telegram->message_length == 0 && telegram->offset == 0 && !tf.received_) {
+#if defined(EMSESP_DEBUG)
+        EMSESP::logger().debug("This telegram (%s) is not recognized by the EMS bus", tf.telegram_type_name_);
+#endif
+        // removing fetch after start causes issue: https://github.com/emsesp/EMS-ESP32/issues/1420
+        // continue retry the first 5 minutes, then disable (added 15.3.2024)
+        if (uuid::get_uptime_sec() > 600) {
+            tf.fetch_ = false;
+        }
+        return false;
+    }
+    if (telegram->message_length > 0) {
+        // note if the values changed, keeping the flag for the mqtt publish
+        bool has_update   = has_update_;
+        has_update_       = false;
+        tf.received_      = true;
+        tf.unsolicited_   = telegram->dest != EMSbus::ems_bus_id();
+        tf.last_received_ = uuid::get_uptime_sec();
+        tf.process_function_(telegram);
+        tf.changed_ |= has_update_;
+        has_update_ |= has_update;
+    }
+
+    return true;
 }
 
 // send Tx write with a data block
@@ -1988,13 +2323,12 @@ std::string EMSdevice::name() {
 // copy a raw value (i.e. without applying the numeric_operator) to the output buffer.
 // returns true on success.
 int EMSdevice::get_modbus_value(uint8_t tag, const std::string & shortname, std::vector<uint16_t> & result) {
-    // find device value by shortname
-    // TODO replace linear search which is inefficient
-    const auto & it = std::find_if(devicevalues_.begin(), devicevalues_.end(), [&](const DeviceValue & x) { return x.tag == tag && x.short_name == shortname; });
-    if (it == devicevalues_.end())
+    // find device value by tag and shortname
+    auto index = dv_name_index_find(tag, shortname.c_str());
+    if (index < 0)
         return -1;
 
-    auto & dv = *it;
+    auto & dv = devicevalues_[index];
 
     // check if it exists, there is a value for the entity. Set the flag to ACTIVE
     // not that this will override any previously removed states
@@ -2075,13 +2409,13 @@ int EMSdevice::get_modbus_value(uint8_t tag, const std::string & shortname, std:
 int EMSdevice::modbus_value_to_json(uint8_t tag, const std::string & shortname, const std::vector<uint8_t> & modbus_data, JsonObject jsonValue) {
     // LOG_DEBUG("modbus_value_to_json(%d,%s,[%d bytes])\n", tag, shortname.c_str(), modbus_data.size());
 
-    // find device value by shortname
-    const auto & it = std::find_if(devicevalues_.begin(), devicevalues_.end(), [&](const DeviceValue & x) { return x.tag == tag && x.short_name == shortname; });
-    if (it == devicevalues_.end()) {
+    // find device value by tag and shortname
+    auto index = dv_name_index_find(tag, shortname.c_str());
+    if (index < 0) {
         return -1;
     }
 
-    auto & dv = *it;
+    auto & dv = devicevalues_[index];
 
     // handle Booleans
     if (dv.type == DeviceValueType::BOOL) {
@@ -52,6 +52,7 @@ class EMSdevice {
     static const char * tag_to_mqtt(int8_t tag);
     static uint8_t      decode_brand(uint8_t value);
     static bool         export_values(uint8_t device_type, JsonObject output, const int8_t id, const uint8_t output_target);
+    static bool         export_values_tag(uint8_t device_type, JsonObject output, const int8_t tag, const uint8_t output_target);
 
     // non static
 
@@ -59,6 +60,7 @@ class EMSdevice {
     const char * device_type_2_device_name_translated(); // returns translated device type name
 
     bool has_tags(const int8_t tag) const;
+    bool has_export_values() const;
     bool has_cmd(const char * cmd, const int8_t id) const;
 
     inline uint8_t device_id() const {
@@ -216,6 +218,7 @@ class EMSdevice {
 
     void   show_telegram_handlers(uuid::console::Shell & shell) const;
     char * show_telegram_handlers(char * result, const size_t len, const uint8_t handlers);
+    char * show_fetch_intervals(char * result, const size_t len) const;
     void   show_mqtt_handlers(uuid::console::Shell & shell) const;
     void   add_handlers_ignored(const uint16_t handler);
 
@@ -224,16 +227,27 @@ class EMSdevice {
     void getCustomizationEntities(std::vector<std::string> & entity_ids);
 
     void register_telegram_type(const uint16_t telegram_type_id, const char * telegram_type_name, bool fetch, const process_function_p cb);
-    bool handle_telegram(std::shared_ptr<const Telegram> telegram);
+    bool handle_telegram(std::shared_ptr<const Telegram> telegram, const uint16_t tf_index);
+
+    // used to build the telegram routing table in EMSESP
+    uint16_t num_telegram_functions() const {
+        return telegram_functions_.size();
+    }
+    uint16_t telegram_function_type_id(const uint16_t tf_index) const {
+        return telegram_functions_[tf_index].telegram_type_id_;
+    }
 
     std::string get_value_uom(const std::string & shortname) const;
 
     bool get_value_info(JsonObject root, const char * cmd, const int8_t id);
     void get_value_json(JsonObject output, DeviceValue & dv);
+
+    int16_t      find_device_value(const char * shortname, const int8_t tag) const;
+    const char * get_value_string(const int16_t index, char * buf, const size_t len) const;
     void get_dv_info(JsonObject json);
 
     enum OUTPUT_TARGET : uint8_t { API_VERBOSE, API_SHORTNAMES, MQTT, CONSOLE };
-    bool generate_values(JsonObject output, const int8_t tag_filter, const bool nested, const uint8_t output_target);
+    bool generate_values(JsonObject output, const int8_t tag_filter, const bool nested, const uint8_t output_target, const bool changed_only = false);
     void generate_values_web(JsonObject output, const bool is_dashboard = false);
     void generate_values_web_customization(JsonArray output);
 
@@ -318,15 +332,20 @@ class EMSdevice {
     bool is_readonly(const std::string & cmd, const int8_t id) const;
     bool has_command(const void * value_p) const;
     void set_minmax(const void * value_p, int16_t min, uint32_t max);
-    void publish_value(void * value_p) const;
+    void publish_value(void * value_p);
     void publish_all_values();
 
+    void clear_changes() {
+        std::fill(dv_changed_.begin(), dv_changed_.end(), 0);
+    }
+
     void mqtt_ha_entity_config_create();
 
     const char * telegram_type_name(std::shared_ptr<const Telegram> telegram);
 
-    void fetch_values();
-    void toggle_fetch(uint16_t telegram_id, bool toggle);
+    void    fetch_values();
+    uint8_t fetch_due(const uint32_t now, const uint8_t max);
+    void    toggle_fetch(uint16_t telegram_id, bool toggle);
     bool is_fetch(uint16_t telegram_id) const;
     bool is_received(uint16_t telegram_id) const;
     bool has_telegram_id(uint16_t id) const;
@@ -339,6 +358,14 @@ class EMSdevice {
         ha_config_done_ = v;
     }
 
+    // progress of the discovery configs after ha_config_clear()
+    // waiting for the first publish of the values, pending when the budget ran out before all configs were queued
+    enum HADiscovery : uint8_t { HA_DISCOVERY_WAITING, HA_DISCOVERY_PENDING, HA_DISCOVERY_DONE };
+
+    uint8_t ha_discovery() const {
+        return ha_discovery_;
+    }
+
     enum Brand : uint8_t {
         NO_BRAND = 0, // 0
         BOSCH,        // 1
@@ -386,6 +413,11 @@ class EMSdevice {
 
     static constexpr uint8_t EMS_DEVICES_MAX_TELEGRAMS = 20;
 
+    // automatic fetch intervals in seconds, adapted per telegram type to how often its values change
+    static constexpr uint16_t FETCH_INTERVAL     = 60;
+    static constexpr uint16_t FETCH_INTERVAL_MIN = 15;
+    static constexpr uint16_t FETCH_INTERVAL_MAX = 480;
+
     // static device IDs
     static constexpr uint8_t EMS_DEVICE_ID_BOILER         = 0x08; // fixed device_id for Master Boiler/UBA
     static constexpr uint8_t EMS_DEVICE_ID_HS1            = 0x70; // fixed device_id for 1st. Cascade Boiler/UBA
@@ -489,6 +521,18 @@ class EMSdevice {
     };
     void dump_telegram_info(std::vector<TelegramFunctionDump> & telegram_functions_dump);
     void dump_value_info();
+
+    // instrumentation for the value pointer index, see test "dv_index"
+    struct DeviceValueIndexStats {
+        uint32_t lookups;         // number of lookups by value pointer
+        uint32_t probes;          // slots inspected in the index
+        uint32_t matches;         // entities found
+        uint32_t linear_compares; // compares a full scan of devicevalues_ would have needed
+    };
+    static DeviceValueIndexStats dv_index_stats_;
+
+    // the single topic and the scheduler command publish_value() builds for an entity, see test "topics"
+    void publish_value_topics(const int8_t tag, const char * shortname, std::string & topic, std::string & cmd);
 #endif
 
   private:
@@ -503,8 +547,13 @@ class EMSdevice {
     uint8_t      brand_       = Brand::NO_BRAND;
     bool         active_      = true;
 
-    bool ha_config_done_ = false;
-    bool has_update_     = false;
+    bool    ha_config_done_ = false;
+    bool    has_update_     = false;
+    uint8_t ha_discovery_   = HADiscovery::HA_DISCOVERY_WAITING;
+
+    // the "dev" section of the discovery configs, rebuilt when Mqtt::topics_version() changes
+    std::string ha_dev_json_;
+    uint32_t    ha_dev_json_version_ = 0;
 
     struct TelegramFunction {
         const uint16_t           telegram_type_id_;   // it's type_id
@@ -513,6 +562,13 @@ class EMSdevice {
         bool                     received_;
         const process_function_p process_function_;
 
+        // adaptive fetch, see fetch_due()
+        bool     changed_       = false;          // values changed since the last automatic fetch
+        bool     unsolicited_   = false;          // last arrived without a read request from us, e.g. broadcasted by the master
+        uint16_t interval_      = FETCH_INTERVAL; // seconds between automatic fetches
+        uint32_t last_received_ = 0;              // uptime in seconds the telegram last arrived
+        uint32_t last_fetch_    = 0;              // uptime in seconds of the last read request
+
         TelegramFunction(uint16_t telegram_type_id, const char * telegram_type_name, bool fetch, bool received, const process_function_p process_function)
             : telegram_type_id_(telegram_type_id)
             , telegram_type_name_(telegram_type_name)
@@ -526,6 +582,66 @@ class EMSdevice {
 
     std::vector<uint16_t> handlers_ignored_;
 
+    // hash index from value_p to the position in devicevalues_, built in add_device_value()
+    HashIndex dv_index_;
+
+    int16_t dv_index_first(const void * value_p) const;
+    template <typename F>
+    void dv_index_find(const void * value_p, F f) const;
+
+    // positions in devicevalues_ grouped by tag, in order of registration within a tag, built in add_device_value()
+    // the entries for a tag are dv_tag_order_[dv_tag_start_[tag + 1]] up to dv_tag_start_[tag + 2], TAG_NONE is bucket 0
+    std::vector<uint16_t> dv_tag_order_;
+    uint16_t              dv_tag_start_[DeviceValue::DeviceValueTAG::TAG_HS16 + 3] = {0};
+
+    void dv_tag_add(uint16_t index);
+
+    // hash index from tag and shortname to the position in devicevalues_, used to resolve Modbus registers and customizations
+    // built on the first lookup and kept up to date in add_device_value() from then on, so it costs nothing when neither is used
+    HashIndex dv_name_index_;
+
+    int16_t dv_name_index_find(uint8_t tag, const char * shortname);
+
+    // an entity customization "<mask in hex>[tag/]shortname[|custom fullname]" split up
+    struct CustomizationEntity {
+        int8_t      tag;
+        uint8_t     mask;
+        bool        has_custom_name;
+        std::string shortname;
+        std::string custom_fullname;
+    };
+
+    static bool parse_customization(const std::string & entity_id, CustomizationEntity & entity);
+    void        apply_customization(DeviceValue & dv, const CustomizationEntity & entity);
+
+    // this device's entity customizations, parsed once and hashed on tag and shortname the same way as dv_name_index_
+    // used when registering device values, re-read when the customizations have changed since
+    std::vector<CustomizationEntity> customizations_;
+    HashIndex                        customization_index_;
+    uint32_t                         customization_version_ = 0;
+
+    const CustomizationEntity * customization_find(int8_t tag, const char * shortname);
+
+    // the MQTT topics of a tag up to the shortname, for single topic publishing and the scheduler's onChange in publish_value()
+    // built on first use for the tags this device has, rebuilt when Mqtt::topics_version() changes
+    struct TopicPrefix {
+        int8_t      tag;
+        std::string state; // with the base, e.g. "ems-esp/thermostat_data_hc1/", or "ems-esp/thermostat/hc1/" with publish_single2cmd
+        std::string cmd;   // e.g. "thermostat/hc1/"
+    };
+
+    std::vector<TopicPrefix> topic_prefixes_;
+    uint32_t                 topic_prefixes_version_ = 0;
+
+    const TopicPrefix & topic_prefix(int8_t tag);
+
+    // entities changed since the last MQTT publish of this device, one bit per position in devicevalues_, set in publish_value()
+    std::vector<uint32_t> dv_changed_;
+
+    bool dv_changed(uint16_t index) const {
+        return dv_changed_[index >> 5] & (1UL << (index & 31));
+    }
+
 #if defined(EMSESP_STANDALONE) || defined(EMSESP_TEST)
   public: // so we can call it from WebCustomizationService::test()
 #endif
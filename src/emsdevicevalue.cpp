@@ -369,6 +369,14 @@ std::string DeviceValue::get_fullname() const {
     return customname;
 }
 
+// same as !get_fullname().empty(), without building the string
+bool DeviceValue::has_fullname() const {
+    if (!custom_fullname.empty() && custom_fullname[0] != '>' && custom_fullname[0] != '<') {
+        return true;
+    }
+    return *Helpers::translated_word(fullname) != '\0';
+}
+
 // returns any custom name defined in the entity_id
 std::string DeviceValue::get_name(const std::string & entity) {
     auto pos = entity.find('|');
@@ -191,6 +191,7 @@ class DeviceValue {
     bool               get_custom_max(uint32_t & val);
     std::string        get_custom_fullname() const;
     std::string        get_fullname() const;
+    bool               has_fullname() const;
     static std::string get_name(const std::string & entity);
 
     // dv state flags
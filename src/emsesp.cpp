@@ -94,6 +94,11 @@ bool     EMSESP::trace_raw_        = false;
 uint16_t EMSESP::wait_validate_    = 0;
 bool     EMSESP::wait_km_          = true;
 
+std::vector<EMSESP::TelegramRoute> EMSESP::telegram_routes_;
+HashIndex                          EMSESP::telegram_routes_index_;
+uint8_t                            EMSESP::device_index_by_id_[0x80];
+bool                               EMSESP::telegram_routes_dirty_ = true;
+
 // for a specific EMS device go and request data values
 // or if device_id is 0 it will fetch from all our known and active devices
 void EMSESP::fetch_device_values(const uint8_t device_id) {
@@ -205,13 +210,15 @@ void EMSESP::watch_id(uint16_t watch_id) {
 // resets all counters and bumps the UART
 // this is called when the tx_mode is persisted in the FS either via Web UI or the console
 void EMSESP::uart_init() {
-    uint8_t tx_mode = 0;
-    uint8_t rx_gpio = 0;
-    uint8_t tx_gpio = 0;
+    uint8_t tx_mode      = 0;
+    uint8_t rx_gpio      = 0;
+    uint8_t tx_gpio      = 0;
+    uint8_t fetch_budget = 0;
     EMSESP::webSettingsService.read([&](WebSettings const & settings) {
-        tx_mode = settings.tx_mode;
-        rx_gpio = settings.rx_gpio;
-        tx_gpio = settings.tx_gpio;
+        tx_mode      = settings.tx_mode;
+        rx_gpio      = settings.rx_gpio;
+        tx_gpio      = settings.tx_gpio;
+        fetch_budget = settings.fetch_budget;
     });
 
     EMSuart::stop();
@@ -225,6 +232,7 @@ void EMSESP::uart_init() {
 
     txservice_.start(); // sends out request to EMS bus for all devices
     txservice_.tx_mode(tx_mode);
+    system_.fetch_budget(fetch_budget);
 
     // force a fetch for all new values, unless Tx is set to off
     // if (tx_mode != 0) {
@@ -284,17 +292,24 @@ void EMSESP::show_ems(uuid::console::Shell & shell) {
         shell.printfln("  #recognized EMS devices: %d", EMSESP::emsdevices.size());
         shell.printfln("  #telegrams received: %d", rxservice_.telegram_count());
         shell.printfln("  #read requests sent: %d", txservice_.telegram_read_count());
+        shell.printfln("  #read requests merged: %d", txservice_.telegram_read_merged_count());
         shell.printfln("  #write requests sent: %d", txservice_.telegram_write_count());
+        shell.printfln("  #write requests merged: %d", txservice_.telegram_write_merged_count());
         shell.printfln("  #incomplete telegrams: %d", rxservice_.telegram_error_count());
+        shell.printfln("  #dropped telegrams (Rx buffer full): %d", rxservice_.telegram_dropped_count());
         shell.printfln("  #read fails (after %d retries): %d", TxService::MAXIMUM_TX_RETRIES, txservice_.telegram_read_fail_count());
         shell.printfln("  #write fails (after %d retries): %d", TxService::MAXIMUM_TX_RETRIES, txservice_.telegram_write_fail_count());
         shell.printfln("  Rx line quality: %d%%", rxservice_.quality());
         shell.printfln("  Tx line quality: %d%%", (txservice_.read_quality() + txservice_.read_quality()) / 2);
+        char result[100];
+        for (uint8_t priority = 0; priority < TxService::NUM_PRIORITIES; priority++) {
+            shell.printfln("  Tx %s: %s", TxService::priority_name(priority), txservice_.show_priority_stats(priority, result, sizeof(result)));
+        }
         shell.println();
     }
 
     // Rx queue
-    auto rx_telegrams = rxservice_.queue();
+    const auto & rx_telegrams = rxservice_.queue();
     if (rx_telegrams.empty()) {
         shell.printfln("Rx Queue is empty");
     } else {
@@ -307,7 +322,7 @@ void EMSESP::show_ems(uuid::console::Shell & shell) {
     shell.println();
 
     // Tx queue
-    auto tx_telegrams = txservice_.queue();
+    const auto & tx_telegrams = txservice_.queue();
     if (tx_telegrams.empty()) {
         shell.printfln("Tx Queue is empty");
     } else {
@@ -566,6 +581,13 @@ void EMSESP::publish_all(bool force) {
     }
 }
 
+// publish all values again in parts, without re-creating the HA configs
+void EMSESP::publish_all_refresh() {
+    if (!publish_all_idx_) {
+        publish_all_idx_ = 1;
+    }
+}
+
 // loop and wait between devices for publishing all values
 void EMSESP::publish_all_loop() {
     if (!Mqtt::connected() || !publish_all_idx_) {
@@ -573,7 +595,7 @@ void EMSESP::publish_all_loop() {
     }
 
     // wait for free queue before sending next message, HA-messages are also queued
-    if (Mqtt::publish_queued() > 0) {
+    if (Mqtt::publish_queued() > 0 || Mqtt::backpressure()) {
         return;
     }
 
@@ -621,6 +643,7 @@ void EMSESP::reset_mqtt_ha() {
     for (const auto & emsdevice : emsdevices) {
         emsdevice->ha_config_clear();
     }
+    Mqtt::ha_discovery_start();
 
     // force the re-creating of the temperature and analog sensor topics (for HA)
     temperaturesensor_.reload();
@@ -630,10 +653,12 @@ void EMSESP::reset_mqtt_ha() {
 // create json doc for the devices values and add to MQTT publish queue
 // this will also create the HA /config topic for each device value
 // generate_values_json is called to build the device value (dv) object array
-void EMSESP::publish_device_values(uint8_t device_type) {
+// with changed_only set, only the entities that changed since the last publish are added
+void EMSESP::publish_device_values(uint8_t device_type, const bool changed_only) {
     JsonDocument doc;
     JsonObject   json         = doc.to<JsonObject>();
     bool         need_publish = false;
+    bool         queued       = true; // all payloads made it into the queue
     bool         nested       = (Mqtt::is_nested());
 
     // group by device type
@@ -646,11 +671,14 @@ void EMSESP::publish_device_values(uint8_t device_type) {
                     json_tag     = doc[EMSdevice::tag_to_mqtt(tag)].to<JsonObject>();
                     nest_created = true;
                 }
-                need_publish |= emsdevice->generate_values(json_tag, tag, false, EMSdevice::OUTPUT_TARGET::MQTT);
+                need_publish |= emsdevice->generate_values(json_tag, tag, false, EMSdevice::OUTPUT_TARGET::MQTT, changed_only);
             }
         }
+        if (changed_only && nest_created && json_tag.size() == 0) {
+            doc.remove(EMSdevice::tag_to_mqtt(tag)); // nothing changed in this tag
+        }
         if (need_publish && !nested) {
-            Mqtt::queue_publish(Mqtt::tag_to_topic(device_type, tag), json);
+            queued &= Mqtt::queue_publish(Mqtt::tag_to_topic(device_type, tag), json);
             json         = doc.to<JsonObject>();
             need_publish = false;
         }
@@ -660,17 +688,40 @@ void EMSESP::publish_device_values(uint8_t device_type) {
         if (doc.overflowed()) {
             LOG_WARNING("MQTT buffer overflow, please use individual topics");
         }
-        Mqtt::queue_publish(Mqtt::tag_to_topic(device_type, DeviceValueTAG::TAG_NONE), json);
+        queued &= Mqtt::queue_publish(Mqtt::tag_to_topic(device_type, DeviceValueTAG::TAG_NONE), json);
     }
 
-    // we want to create the /config topic after the data payload to prevent HA from throwing up a warning
-    if (Mqtt::ha_enabled()) {
-        for (const auto & emsdevice : emsdevices) {
-            if (emsdevice && (emsdevice->device_type() == device_type)) {
+    Mqtt::ha_budget_reset();
+    for (const auto & emsdevice : emsdevices) {
+        if (emsdevice && (emsdevice->device_type() == device_type)) {
+            // keep the changes for the next publish if the queue refused the payload
+            if (queued) {
+                emsdevice->clear_changes(); // all changes are published now
+            }
+            // we want to create the /config topic after the data payload to prevent HA from throwing up a warning
+            if (Mqtt::ha_enabled()) {
+                emsdevice->mqtt_ha_entity_config_create();
+            }
+        }
+    }
+}
+
+// continue the discovery of the devices whose configs didn't fit in the budget of their publish, until the budget runs out
+// the rollout is finished when the staged publish of all values is done and no device has configs pending
+void EMSESP::ha_discovery_loop() {
+    bool pending = false;
+    for (const auto & emsdevice : emsdevices) {
+        if (emsdevice && emsdevice->ha_discovery() == EMSdevice::HADiscovery::HA_DISCOVERY_PENDING) {
+            pending = true;
+            if (Mqtt::ha_budget_left()) {
                 emsdevice->mqtt_ha_entity_config_create();
             }
         }
     }
+
+    if (!pending && !publish_all_idx_) {
+        Mqtt::ha_discovery_finish();
+    }
 }
 
 // call the devices that don't need special attention
@@ -1058,60 +1109,44 @@ bool EMSESP::process_telegram(std::shared_ptr<const Telegram> telegram) {
         return true;
     }
 
-    // match device_id and type_id
+    // match device_id and type_id using the routing table
     // calls the associated process function for that EMS device
     // returns false if the device_id doesn't recognize it
     // after the telegram has been processed, see if there have been values changed and we need to do a MQTT publish
-    bool    telegram_found = false;
-    uint8_t device_found   = 0;
+    if (telegram_routes_dirty_) {
+        build_telegram_routes();
+    }
+    bool        telegram_found = false;
+    EMSdevice * device_found   = nullptr;
     // broadcast or send to us
-    for (const auto & emsdevice : emsdevices) {
-        if (emsdevice->is_device_id(telegram->src) && (telegram->dest == 0 || telegram->dest == EMSbus::ems_bus_id())) {
-            telegram_found = emsdevice->handle_telegram(telegram);
-            device_found   = emsdevice->unique_id();
-            break;
-        }
+    if (telegram->dest == 0 || telegram->dest == EMSbus::ems_bus_id()) {
+        telegram_found = route_telegram(telegram->src, telegram, device_found);
     }
-    if (!telegram_found) {
+    if (!telegram_found && telegram->src != EMSbus::ems_bus_id()) {
         // check for command to the device
-        for (const auto & emsdevice : emsdevices) {
-            if (emsdevice->is_device_id(telegram->dest) && telegram->src != EMSbus::ems_bus_id()) {
-                telegram_found = emsdevice->handle_telegram(telegram);
-                device_found   = emsdevice->unique_id();
-                break;
-            }
-        }
+        telegram_found = route_telegram(telegram->dest, telegram, device_found);
     }
-    if (!telegram_found) {
+    if (!telegram_found && telegram->dest == 0x10) {
         // check for sends to master thermostat
-        for (const auto & emsdevice : emsdevices) {
-            if (emsdevice->is_device_id(telegram->src) && telegram->dest == 0x10) {
-                telegram_found = emsdevice->handle_telegram(telegram);
-                device_found   = emsdevice->unique_id();
-                break;
-            }
-        }
+        telegram_found = route_telegram(telegram->src, telegram, device_found);
     }
-    for (const auto & emsdevice : emsdevices) {
-        if (emsdevice->unique_id() == device_found) {
-            if (!telegram_found && telegram->message_length > 0) {
-                emsdevice->add_handlers_ignored(telegram->type_id);
-            }
-            if (wait_validate_ == telegram->type_id) {
-                wait_validate_ = 0;
+    if (device_found) {
+        if (!telegram_found && telegram->message_length > 0) {
+            device_found->add_handlers_ignored(telegram->type_id);
+        }
+        if (wait_validate_ == telegram->type_id) {
+            wait_validate_ = 0;
+        }
+        if (Mqtt::connected() && telegram_found
+            && ((mqtt_.get_publish_onchange(device_found->device_type()) && device_found->has_update())
+                || (telegram->type_id == publish_id_ && telegram->dest == EMSbus::ems_bus_id()))) {
+            if (telegram->type_id == publish_id_) {
+                publish_id_ = 0;
             }
-            if (Mqtt::connected() && telegram_found
-                && ((mqtt_.get_publish_onchange(emsdevice->device_type()) && emsdevice->has_update())
-                    || (telegram->type_id == publish_id_ && telegram->dest == EMSbus::ems_bus_id()))) {
-                if (telegram->type_id == publish_id_) {
-                    publish_id_ = 0;
-                }
-                emsdevice->has_update(false); // reset flag
-                if (!Mqtt::publish_single()) {
-                    publish_device_values(emsdevice->device_type()); // publish to MQTT if we explicitly have too
-                }
+            device_found->has_update(false); // reset flag
+            if (!Mqtt::publish_single()) {
+                publish_device_values(device_found->device_type(), Mqtt::publish_changes()); // publish to MQTT if we explicitly have too
             }
-            break;
         }
     }
     // handle unknown broadcasted telegrams (or send to us)
@@ -1128,6 +1163,71 @@ bool EMSESP::process_telegram(std::shared_ptr<const Telegram> telegram) {
     return telegram_found;
 }
 
+// hash of a route key, for telegram_routes_index_
+uint32_t EMSESP::route_hash(const uint8_t device_id, const uint16_t type_id) {
+    return Helpers::hash32((device_id << 16) | type_id);
+}
+
+// returns the position in telegram_routes_ of the route for (device_id, type_id), or -1
+int32_t EMSESP::find_telegram_route(const uint8_t device_id, const uint16_t type_id) {
+    return telegram_routes_index_.find(route_hash(device_id, type_id), [&](uint16_t r) {
+        return telegram_routes_[r].device_id == device_id && telegram_routes_[r].type_id == type_id;
+    });
+}
+
+// build the routing table from (device_id, type_id) to the registered telegram function
+// only the first device with a device_id and the first function with a type_id are used, like a linear search would
+void EMSESP::build_telegram_routes() {
+    memset(device_index_by_id_, 0, sizeof(device_index_by_id_));
+    telegram_routes_.clear();
+
+    size_t num_functions = 0;
+    for (const auto & emsdevice : emsdevices) {
+        num_functions += emsdevice->num_telegram_functions();
+    }
+
+    telegram_routes_index_.clear();
+    telegram_routes_.reserve(num_functions);
+
+    for (uint8_t i = 0; i < emsdevices.size(); i++) {
+        uint8_t device_id = emsdevices[i]->device_id() & 0x7F;
+        if (device_index_by_id_[device_id]) {
+            continue; // a device with this id is already routed
+        }
+        device_index_by_id_[device_id] = i + 1;
+
+        for (uint16_t tf_index = 0; tf_index < emsdevices[i]->num_telegram_functions(); tf_index++) {
+            uint16_t type_id = emsdevices[i]->telegram_function_type_id(tf_index);
+            if (find_telegram_route(device_id, type_id) < 0) {
+                telegram_routes_.push_back({device_id, type_id, tf_index});
+                telegram_routes_index_.add(telegram_routes_.size() - 1, telegram_routes_.size(), [](uint16_t r) {
+                    return route_hash(telegram_routes_[r].device_id, telegram_routes_[r].type_id);
+                });
+            }
+        }
+    }
+
+    telegram_routes_dirty_ = false;
+}
+
+// route a telegram to the device with device_id and call the handler for its type_id
+// emsdevice is set if there is a device with this id, even if it has no handler for the type
+// returns true if the telegram was handled
+bool EMSESP::route_telegram(const uint8_t device_id, std::shared_ptr<const Telegram> telegram, EMSdevice *& emsdevice) {
+    uint8_t device_index = device_index_by_id_[device_id & 0x7F];
+    if (!device_index) {
+        return false;
+    }
+    emsdevice = emsdevices[device_index - 1].get();
+
+    int32_t route = find_telegram_route(device_id & 0x7F, telegram->type_id);
+    if (route >= 0) {
+        return emsdevice->handle_telegram(telegram, telegram_routes_[route].tf_index);
+    }
+
+    return false; // type not found
+}
+
 // return true if we have this device already registered
 bool EMSESP::device_exists(const uint8_t device_id) {
     for (const auto & emsdevice : emsdevices) {
@@ -1204,6 +1304,7 @@ bool EMSESP::add_device(const uint8_t device_id, const uint8_t product_id, const
                 return true;
             }
             emsdevices.erase(it); // erase the old device without product_id and re detect
+            invalidate_telegram_routes();
             break;
         }
         it++;
@@ -1239,6 +1340,7 @@ bool EMSESP::add_device(const uint8_t device_id, const uint8_t product_id, const
         LOG_NOTICE("Unrecognized EMS device (deviceID 0x%02X, productID %d). Please report on GitHub.", device_id, product_id);
         emsdevices.push_back(
             EMSFactory::add(DeviceType::GENERIC, device_id, product_id, version, "unknown", DeviceFlags::EMS_DEVICE_FLAG_NONE, EMSdevice::Brand::NO_BRAND));
+        invalidate_telegram_routes();
         return false; // not found
     }
 
@@ -1322,6 +1424,7 @@ bool EMSESP::add_device(const uint8_t device_id, const uint8_t product_id, const
 
     LOG_DEBUG("Adding new device %s (deviceID 0x%02X, productID %d, version %s)", default_name, device_id, product_id, version);
     emsdevices.push_back(EMSFactory::add(device_type, device_id, product_id, version, default_name, flags, brand));
+    invalidate_telegram_routes();
 
     // see if we have a custom device name in our Customizations list, and if so set it
     webCustomizationService.read([&](WebCustomization const & settings) {
@@ -1404,7 +1507,7 @@ void EMSESP::incoming_telegram(uint8_t * data, const uint8_t length) {
         LOG_TRACE("[UART_DEBUG] Echo after %d ms: %s", ::millis() - rx_time_, Helpers::data_to_hex(data, length).c_str());
 #endif
         // add to RxQueue for log/watch
-        rxservice_.add(data, length);
+        rxservice_.push(data, length);
         return; // it's an echo
     }
 
@@ -1501,12 +1604,48 @@ void EMSESP::incoming_telegram(uint8_t * data, const uint8_t length) {
 #endif
         Roomctrl::check(data[1], data, length); // check if there is a message for the roomcontroller
 
-        rxservice_.add(data, length); // add to RxQueue
+        rxservice_.push(data, length); // hand over to the main loop for parsing
     }
 }
 
 // fetch devices one by one
+// with a fetch budget set, request the telegrams that are due (see EMSdevice::fetch_due) at most budget per minute
+// otherwise fetch all telegrams of all devices every minute, one device at a time
 void EMSESP::scheduled_fetch_values() {
+    if (system_.fetch_budget()) {
+        static uint32_t last_check = 0;
+        static uint32_t tokens     = 0; // in 1/1000 read request
+        static uint8_t  next       = 0; // device to start with, so all get their turn if the budget runs out
+        uint32_t        now        = uuid::get_uptime();
+        if (now - last_check < 1000) {
+            return;
+        }
+        tokens     = std::min<uint32_t>(tokens + (now - last_check) * system_.fetch_budget() / 60, system_.fetch_budget() * 1000);
+        last_check = now;
+
+        // the custom entities take the first slot of the budget when they are due, also with a busy Tx queue
+        if (now - last_fetch_ > EMS_FETCH_FREQUENCY && tokens >= 1000) {
+            last_fetch_ = now;
+            tokens -= std::min<uint32_t>(webCustomEntityService.fetch() * 1000, tokens);
+        }
+
+        if (!txservice_.tx_queue_empty()) {
+            return;
+        }
+
+        uint8_t available = tokens / 1000;
+        for (uint8_t i = 0; i < emsdevices.size() && available; i++) {
+            auto device = (next + i) % emsdevices.size();
+            auto count  = emsdevices[device]->fetch_due(now / 1000, available);
+            available -= count;
+            tokens -= count * 1000;
+            if (!available) {
+                next = device;
+            }
+        }
+        return;
+    }
+
     static uint8_t no = 0;
     if (no || (uuid::get_uptime() - last_fetch_ > EMS_FETCH_FREQUENCY)) {
         if (!no) {
@@ -1547,6 +1686,10 @@ void EMSESP::start() {
     system_.PSram(ESP.getPsramSize());
 #endif
 
+    // allocate the log ring before anything is logged
+    size_t log_ring_size = system_.PSram() ? LOG_RING_SIZE_PSRAM : LOG_RING_SIZE;
+    bool   log_ring_ok   = uuid::log::Ring::begin(log_ring_size);
+
     serial_console_.begin(SERIAL_CONSOLE_BAUD_RATE);
 
     // always start a serial console if we're running standalone, except if we're running unit tests
@@ -1556,6 +1699,11 @@ void EMSESP::start() {
 #endif
 #endif
 
+    // the first message allocates the default size instead
+    if (!log_ring_ok) {
+        LOG_WARNING("Failed to allocate %d bytes for the log buffer, using the default size", (int)log_ring_size);
+    }
+
 // start the file system
 #ifndef EMSESP_STANDALONE
     if (!LittleFS.begin(true)) {
@@ -1640,7 +1788,7 @@ void EMSESP::start() {
     // start services
     if (system_.modbus_enabled()) {
         modbus_ = new Modbus;
-        modbus_->start(1, system_.modbus_port(), system_.modbus_max_clients(), system_.modbus_timeout());
+        modbus_->start(1, system_.modbus_port(), system_.modbus_max_clients(), system_.modbus_timeout(), system_.modbus_strict());
     }
     mqtt_.start();              // mqtt init
     system_.start();            // starts commands, led, adc, button, network (sets hostname), syslog & uart
@@ -50,6 +50,7 @@
 #include "web/WebLogService.h"
 #include "web/WebCustomEntityService.h"
 #include "web/WebModulesService.h"
+#include "web/WebStreamResponse.h"
 
 #include "emsdevicevalue.h"
 #include "emsdevice.h"
@@ -96,13 +97,18 @@ class EMSESP {
     virtual void start();
     virtual void loop();
 
+    static constexpr size_t LOG_RING_SIZE       = 8 * 1024;  // bytes of log messages kept for all log outputs, about 100 messages
+    static constexpr size_t LOG_RING_SIZE_PSRAM = 32 * 1024; // with PSRAM
+
     static uuid::log::Logger logger();
 
-    static void publish_device_values(uint8_t device_type);
+    static void publish_device_values(uint8_t device_type, const bool changed_only = false);
     static void publish_other_values();
     static void publish_sensor_values(const bool time, const bool force = false);
     static void publish_all(bool force = false);
+    static void publish_all_refresh();
     static void reset_mqtt_ha();
+    static void ha_discovery_loop();
 
 #ifdef EMSESP_STANDALONE
     static void run_test(uuid::console::Shell & shell, const std::string & command); // only for testing
@@ -215,6 +221,9 @@ class EMSESP {
     static void scheduled_fetch_values();
 
     static bool add_device(const uint8_t device_id, const uint8_t product_id, const char * version, const uint8_t brand);
+    static void invalidate_telegram_routes() {
+        telegram_routes_dirty_ = true;
+    }
     static void scan_devices();
     static void clear_all_devices();
 
@@ -252,6 +261,8 @@ class EMSESP {
     static void        process_version(std::shared_ptr<const Telegram> telegram);
     static void        publish_response(std::shared_ptr<const Telegram> telegram);
     static void        publish_all_loop();
+    static void        build_telegram_routes();
+    static bool        route_telegram(const uint8_t device_id, std::shared_ptr<const Telegram> telegram, EMSdevice *& emsdevice);
 
     void shell_prompt();
     void start_serial_console();
@@ -281,6 +292,21 @@ class EMSESP {
     static bool     wait_km_;
     static uint32_t last_fetch_;
 
+    // routing table for incoming telegrams, from (device_id, type_id) to the registered telegram function of the device, found by device_index_by_id_
+    // rebuilt on the next telegram after a device is added or a telegram type is registered
+    struct TelegramRoute {
+        uint8_t  device_id;
+        uint16_t type_id;
+        uint16_t tf_index; // position in the device's telegram functions
+    };
+    static std::vector<TelegramRoute> telegram_routes_;
+    static HashIndex                  telegram_routes_index_;    // on (device_id, type_id) to the position in telegram_routes_
+    static uint8_t                    device_index_by_id_[0x80]; // position in emsdevices + 1, 0 if not known
+    static bool                       telegram_routes_dirty_;
+
+    static uint32_t route_hash(const uint8_t device_id, const uint16_t type_id);
+    static int32_t  find_telegram_route(const uint8_t device_id, const uint16_t type_id);
+
     // UUID stuff
     static constexpr auto &        serial_console_          = Serial;
     static constexpr unsigned long SERIAL_CONSOLE_BAUD_RATE = 115200;
@@ -776,6 +776,34 @@ const char * Helpers::translated_word(const char * const * strings, const bool f
     return strings[index];
 }
 
+// integer hash, mixing all bits so it can be masked to a power of 2 sized table
+uint32_t Helpers::hash32(uint32_t value) {
+    value ^= value >> 16;
+    value *= 0x45D9F3B;
+    value ^= value >> 16;
+    return value;
+}
+
+// FNV-1a hash of a string, optionally not case sensitive
+uint32_t Helpers::hash32(const char * str, size_t len, uint32_t seed, const bool ignore_case) {
+    uint32_t hash = 2166136261UL ^ seed;
+    while (len--) {
+        uint8_t c = *str++;
+        hash      = (hash ^ (uint8_t)(ignore_case ? tolower(c) : c)) * 16777619UL;
+    }
+    return hash;
+}
+
+// put the entry at position index in the first free slot of its probe chain
+void HashIndex::insert(uint16_t index, uint32_t hash) {
+    size_t mask = slots_.size() - 1;
+    size_t slot = hash & mask;
+    while (slots_[slot]) {
+        slot = (slot + 1) & mask;
+    }
+    slots_[slot] = index + 1;
+}
+
 uint16_t Helpers::string2minutes(const std::string & str) {
     uint8_t  i     = 0;
     uint16_t res   = 0;
@@ -82,11 +82,73 @@ class Helpers {
 
     static const char * translated_word(const char * const * strings, const bool force_en = false);
 
+    static uint32_t hash32(uint32_t value);
+    static uint32_t hash32(const char * str, size_t len, uint32_t seed = 0, const bool ignore_case = false);
+
 #ifdef EMSESP_STANDALONE
     static char * ultostr(char * ptr, uint32_t value, const uint8_t base);
 #endif
 };
 
+// hash index (open addressing) to the positions of entries kept in a separate vector
+// each slot holds the position + 1, 0 is an empty slot. Sized to a power of 2 and kept at most half full
+// entries with the same hash sit on the same probe chain in the order they were added
+class HashIndex {
+  public:
+    // add the entry at position index, count is the number of entries including this one
+    // hash_of(i) returns the hash of the entry at position i, used to re-add all entries when the index grows
+    template <typename HashOf>
+    void add(uint16_t index, size_t count, HashOf hash_of) {
+        if ((count * 2) > slots_.size()) {
+            rebuild(count, hash_of);
+            return; // a rebuild adds all entries including the new one
+        }
+        insert(index, hash_of(index));
+    }
+
+    // resize the index for count entries and re-add them all
+    template <typename HashOf>
+    void rebuild(size_t count, HashOf hash_of) {
+        size_t size = 16;
+        while (size < count * 2) {
+            size *= 2;
+        }
+        slots_.assign(size, 0);
+        for (uint16_t i = 0; i < count; i++) {
+            insert(i, hash_of(i));
+        }
+    }
+
+    // call match(index) for each entry on the probe chain of hash until it returns true
+    // returns the index match returned true for, or -1
+    template <typename Match>
+    int32_t find(uint32_t hash, Match match) const {
+        if (slots_.empty()) {
+            return -1;
+        }
+        size_t mask = slots_.size() - 1;
+        for (size_t slot = hash & mask; slots_[slot]; slot = (slot + 1) & mask) {
+            if (match((uint16_t)(slots_[slot] - 1))) {
+                return slots_[slot] - 1;
+            }
+        }
+        return -1;
+    }
+
+    void clear() {
+        std::vector<uint16_t>().swap(slots_);
+    }
+
+    bool empty() const {
+        return slots_.empty();
+    }
+
+  private:
+    void insert(uint16_t index, uint32_t hash);
+
+    std::vector<uint16_t> slots_;
+};
+
 } // namespace emsesp
 
 #endif
\ No newline at end of file
@@ -19,7 +19,11 @@ enum FunctionCode : uint8_t { WRITE_HOLD_REGISTER = 0x06, WRITE_MULT_REGISTERS =
 
 uuid::log::Logger Modbus::logger_{F_(modbus), uuid::log::Facility::DAEMON};
 
-void Modbus::start(uint8_t systemServerId, uint16_t port, uint8_t max_clients, uint32_t timeout) {
+bool Modbus::strict_ = false;
+
+void Modbus::start(uint8_t systemServerId, uint16_t port, uint8_t max_clients, uint32_t timeout, bool strict) {
+    strict_ = strict;
+
 #ifndef EMSESP_STANDALONE
     if (!check_parameter_order()) {
         LOG_ERROR("Unable to enable Modbus - the parameter list order is corrupt. This is a firmware bug.");
@@ -287,42 +291,95 @@ ModbusMessage Modbus::handleRead(const ModbusMessage & request) {
 
     const auto & dev = *dev_it;
 
-    // binary search in modbus infos
+    if (num_words == 0 || num_words > MAX_READ_REGISTERS) {
+        LOG_ERROR("invalid number of registers (%d) requested", num_words);
+        response.setError(request.getServerID(), request.getFunctionCode(), ILLEGAL_DATA_VALUE);
+        return response;
+    }
+
+    if (register_offset + num_words > REGISTER_BLOCK_SIZE) {
+        // a read can't span more than one tag
+        LOG_ERROR("register range %d-%d exceeds the register block", start_address, start_address + num_words - 1);
+        response.setError(request.getServerID(), request.getFunctionCode(), ILLEGAL_DATA_ADDRESS);
+        return response;
+    }
+
+    // binary search in modbus infos for the first entity at or after the start address
     auto key = EntityModbusInfoKey(dev->device_type(), tag_type, register_offset);
 
-    const auto & modbusInfo = std::lower_bound(std::begin(modbus_register_mappings),
-                                               std::end(modbus_register_mappings),
-                                               key,
-                                               [](const EntityModbusInfo & a, const EntityModbusInfoKey & b) { return a.isLessThan(b); });
+    auto modbusInfo = std::lower_bound(std::begin(modbus_register_mappings),
+                                       std::end(modbus_register_mappings),
+                                       key,
+                                       [](const EntityModbusInfo & a, const EntityModbusInfoKey & b) { return a.isLessThan(b); });
+
+    // the entity before it may still overlap the start of the range
+    if (modbusInfo != std::begin(modbus_register_mappings)) {
+        const auto & prev = *(modbusInfo - 1);
+        if (prev.device_type == key.device_type && prev.device_value_tag_type == key.device_value_tag_type
+            && prev.registerOffset + prev.registerCount > register_offset) {
+            modbusInfo--;
+        }
+    }
+
+    // copy the registers of all entities overlapping the range, holes stay 0
+    auto     end_offset = register_offset + num_words;
+    auto     buf        = std::vector<uint16_t>(num_words, 0);
+    auto     value      = std::vector<uint16_t>();
+    uint16_t mapped     = 0; // number of registers covered by an entity
+    uint8_t  entities   = 0;
+    uint8_t  failed     = 0;
+
+    for (; modbusInfo != std::end(modbus_register_mappings) && modbusInfo->device_type == key.device_type
+           && modbusInfo->device_value_tag_type == key.device_value_tag_type && modbusInfo->registerOffset < end_offset;
+         modbusInfo++) {
+        auto first = std::max<int>(modbusInfo->registerOffset, register_offset);
+        auto last  = std::min<int>(modbusInfo->registerOffset + modbusInfo->registerCount, end_offset);
+
+        if (strict_ && (first != modbusInfo->registerOffset || last != modbusInfo->registerOffset + modbusInfo->registerCount)) {
+            // only part of the entity is requested
+            LOG_ERROR("register range %d-%d only covers part of entity %s", start_address, start_address + num_words - 1, modbusInfo->short_name);
+            response.setError(request.getServerID(), request.getFunctionCode(), ILLEGAL_DATA_ADDRESS);
+            return response;
+        }
 
+        entities++;
+        mapped += last - first;
+
+        value.assign(modbusInfo->registerCount, 0);
+        auto error_code = dev->get_modbus_value(tag, modbusInfo->short_name, value);
+        if (error_code) {
+            LOG_ERROR("Unable to read raw device value %s for tag=%d - error_code = %d", modbusInfo->short_name, (int)tag, error_code);
+            if (strict_) {
+                response.setError(request.getServerID(), request.getFunctionCode(), SERVER_DEVICE_FAILURE);
+                return response;
+            }
+            failed++;
+            continue;
+        }
 
-    if (modbusInfo == std::end(modbus_register_mappings) || !modbusInfo->equals(key)) {
-        // combination of device_type/tag_type/register_offset does not exist
-        LOG_ERROR("combination of device_type/tag_type/register_offset does not exist");
-        response.setError(request.getServerID(), request.getFunctionCode(), ILLEGAL_DATA_ADDRESS);
-        return response;
+        std::copy(value.begin() + (first - modbusInfo->registerOffset),
+                  value.begin() + (last - modbusInfo->registerOffset),
+                  buf.begin() + (first - register_offset));
     }
 
-    // only reading a single value at a time is supported for now
-    if (num_words != modbusInfo->registerCount) {
-        // number of registers requested does not match actual register count for entity
-        LOG_ERROR("number of registers requested does not match actual register count for entity");
+    if (!entities || (strict_ && mapped != num_words)) {
+        // combination of device_type/tag_type/register range does not exist
+        LOG_ERROR("combination of device_type/tag_type/register range %d-%d does not exist", start_address, start_address + num_words - 1);
         response.setError(request.getServerID(), request.getFunctionCode(), ILLEGAL_DATA_ADDRESS);
         return response;
     }
 
-    auto buf        = std::vector<uint16_t>(num_words);
-    auto error_code = dev->get_modbus_value(tag, modbusInfo->short_name, buf);
-    if (error_code) {
-        LOG_ERROR("Unable to read raw device value %s for tag=%d - error_code = %d", modbusInfo->short_name, (int)tag, error_code);
+    if (failed == entities) {
+        // none of the values could be read
         response.setError(request.getServerID(), request.getFunctionCode(), SERVER_DEVICE_FAILURE);
+        return response;
     }
 
     response.add(request.getServerID());
     response.add(request.getFunctionCode());
     response.add((uint8_t)(num_words * 2));
-    for (auto & value : buf)
-        response.add(value);
+    for (auto & word : buf)
+        response.add(word);
 
     return response;
 }
@@ -26,8 +26,9 @@ namespace emsesp {
 class Modbus {
   public:
     static const int REGISTER_BLOCK_SIZE = 1000;
+    static const int MAX_READ_REGISTERS  = 125; // maximum quantity of registers in one read request, from the Modbus spec
 
-    void start(uint8_t systemServerId, uint16_t port, uint8_t max_clients, uint32_t timeout);
+    void start(uint8_t systemServerId, uint16_t port, uint8_t max_clients, uint32_t timeout, bool strict = false);
     void stop();
 
 #if defined(EMSESP_STANDALONE)
@@ -100,6 +101,10 @@ class Modbus {
   public:
 #endif
 
+    // when set, a register read fails if the range contains unmapped registers, partial entities or values that can't be read
+    // otherwise these are returned as 0
+    static bool strict_;
+
     static ModbusMessage handleSystemRead(const ModbusMessage & request);
     static ModbusMessage handleRead(const ModbusMessage & request);
     static ModbusMessage handleWrite(const ModbusMessage & request);
@@ -47,15 +47,33 @@ uint8_t     Mqtt::discovery_type_;
 bool        Mqtt::send_response_;
 bool        Mqtt::publish_single_;
 bool        Mqtt::publish_single2cmd_;
+bool        Mqtt::publish_changes_;
+uint32_t    Mqtt::topics_version_ = 1;
+uint8_t     Mqtt::discovery_budget_;
 
 std::vector<Mqtt::MQTTSubFunction> Mqtt::mqtt_subfunctions_;
+HashIndex                          Mqtt::sub_index_;
 
 uint32_t Mqtt::mqtt_publish_fails_ = 0;
 bool     Mqtt::connecting_         = false;
 bool     Mqtt::initialized_        = false;
 bool     Mqtt::ha_climate_reset_   = false;
 uint16_t Mqtt::queuecount_         = 0;
+uint32_t Mqtt::queuebytes_         = 0;
+uint16_t Mqtt::queue_hwm_count_    = 0;
+uint32_t Mqtt::queue_hwm_bytes_    = 0;
+uint32_t Mqtt::queue_drops_[Mqtt::DROP_REASONS];
+bool     Mqtt::backpressure_       = false;
+uint32_t Mqtt::backpressure_count_ = 0;
 uint8_t  Mqtt::connectcount_       = 0;
+
+uint8_t  Mqtt::ha_budget_msgs_       = 0;
+int32_t  Mqtt::ha_budget_bytes_      = 0;
+bool     Mqtt::ha_discovery_running_ = false;
+uint32_t Mqtt::ha_discovery_start_   = 0;
+uint32_t Mqtt::ha_discovery_time_    = 0;
+uint16_t Mqtt::ha_discovery_configs_ = 0;
+uint32_t Mqtt::ha_discovery_bytes_   = 0;
 uint32_t Mqtt::mqtt_message_id_    = 0;
 char     will_topic_[Mqtt::MQTT_TOPIC_MAX_SIZE]; // because MQTT library keeps only char pointer
 
@@ -82,21 +100,23 @@ uuid::log::Logger Mqtt::logger_{F_(mqtt), uuid::log::Facility::DAEMON};
 void Mqtt::subscribe(const uint8_t device_type, const std::string & topic, mqtt_sub_function_p cb) {
     // check if we already have the topic subscribed for this specific device type, if so don't add it again
     // add the function (in case its not there) and quit because it already exists
-    if (!mqtt_subfunctions_.empty()) {
-        for (auto & mqtt_subfunction : mqtt_subfunctions_) {
-            if ((mqtt_subfunction.device_type_ == device_type) && (strcmp(mqtt_subfunction.topic_.c_str(), topic.c_str()) == 0)) {
-                if (cb) {
-                    mqtt_subfunction.mqtt_subfunction_ = cb;
-                }
-                return; // exit - don't add
-            }
+    uint32_t hash  = Helpers::hash32(topic.c_str(), topic.size());
+    int32_t  found = sub_index_.find(hash, [&](uint16_t index) {
+        const auto & mqtt_subfunction = mqtt_subfunctions_[index];
+        return (mqtt_subfunction.hash_ == hash) && (mqtt_subfunction.device_type_ == device_type) && (mqtt_subfunction.topic_ == topic);
+    });
+    if (found >= 0) {
+        if (cb) {
+            mqtt_subfunctions_[found].mqtt_subfunction_ = cb;
         }
+        return; // exit - don't add
     }
 
     // register in our libary with the callback function.
     // We store the original topic string without base
     // removed std::move(topic) in 3.7.0-dev.43
     mqtt_subfunctions_.emplace_back(device_type, topic, cb);
+    sub_index_.add(mqtt_subfunctions_.size() - 1, mqtt_subfunctions_.size(), [](uint16_t i) { return mqtt_subfunctions_[i].hash_; });
 
     if (!enabled() || !connected()) {
         return;
@@ -126,7 +146,7 @@ void Mqtt::resubscribe() {
 
 // Main MQTT loop - sends out top item on publish queue
 void Mqtt::loop() {
-    queuecount_ = mqttClient_->queueSize();
+    queue_update();
 
     // exit if MQTT is not enabled or if there is no network connection
     if (!connected()) {
@@ -141,40 +161,47 @@ void Mqtt::loop() {
         EMSESP::system_.send_heartbeat(); // send heartbeat
     }
 
+    // when only publishing changes, publish everything now and then as a fallback
+    // for values not set via has_update() and for clients that missed a message
+    if (publish_changes() && (currentMillis - last_publish_full_ > PUBLISH_FULL_REFRESH)) {
+        last_publish_full_ = currentMillis;
+        EMSESP::publish_all_refresh();
+    }
+
     // temperature and analog sensor publish on change
-    if (!publish_time_sensor_) {
+    if (!publish_time_sensor_ && !backpressure()) {
         EMSESP::publish_sensor_values(false);
     }
 
     // wait for empty queue before sending scheduled device messages
-    if (queuecount_ > 0) {
+    if (queuecount_ > 0 || backpressure()) {
         return;
     }
 
     // create publish messages for each of the EMS device values, adding to queue, only one device per loop
     if (publish_time_boiler_ && (currentMillis - last_publish_boiler_ > publish_time_boiler_)) {
         last_publish_boiler_ = (currentMillis / publish_time_boiler_) * publish_time_boiler_;
-        EMSESP::publish_device_values(EMSdevice::DeviceType::BOILER);
+        EMSESP::publish_device_values(EMSdevice::DeviceType::BOILER, publish_changes());
     } else
 
         if (publish_time_thermostat_ && (currentMillis - last_publish_thermostat_ > publish_time_thermostat_)) {
         last_publish_thermostat_ = (currentMillis / publish_time_thermostat_) * publish_time_thermostat_;
-        EMSESP::publish_device_values(EMSdevice::DeviceType::THERMOSTAT);
+        EMSESP::publish_device_values(EMSdevice::DeviceType::THERMOSTAT, publish_changes());
     } else
 
         if (publish_time_solar_ && (currentMillis - last_publish_solar_ > publish_time_solar_)) {
         last_publish_solar_ = (currentMillis / publish_time_solar_) * publish_time_solar_;
-        EMSESP::publish_device_values(EMSdevice::DeviceType::SOLAR);
+        EMSESP::publish_device_values(EMSdevice::DeviceType::SOLAR, publish_changes());
     } else
 
         if (publish_time_mixer_ && (currentMillis - last_publish_mixer_ > publish_time_mixer_)) {
         last_publish_mixer_ = (currentMillis / publish_time_mixer_) * publish_time_mixer_;
-        EMSESP::publish_device_values(EMSdevice::DeviceType::MIXER);
+        EMSESP::publish_device_values(EMSdevice::DeviceType::MIXER, publish_changes());
     } else
 
         if (publish_time_water_ && (currentMillis - last_publish_water_ > publish_time_water_)) {
         last_publish_water_ = (currentMillis / publish_time_water_) * publish_time_water_;
-        EMSESP::publish_device_values(EMSdevice::DeviceType::WATER);
+        EMSESP::publish_device_values(EMSdevice::DeviceType::WATER, publish_changes());
     } else
 
         if (publish_time_other_ && (currentMillis - last_publish_other_ > publish_time_other_)) {
@@ -185,6 +212,12 @@ void Mqtt::loop() {
         if (publish_time_sensor_ && (currentMillis - last_publish_sensor_ > publish_time_sensor_)) {
         last_publish_sensor_ = (currentMillis / publish_time_sensor_) * publish_time_sensor_;
         EMSESP::publish_sensor_values(true);
+    } else
+
+        if (ha_enabled_) {
+        // nothing scheduled, continue with the discovery configs that didn't fit in the budget of their device publish
+        ha_budget_reset();
+        EMSESP::ha_discovery_loop();
     }
 }
 
@@ -194,7 +227,60 @@ void Mqtt::show_mqtt(uuid::console::Shell & shell) {
     shell.printfln("MQTT Entity ID format is %d", entity_format_);
 
     shell.printfln("MQTT publish errors: %lu", mqtt_publish_fails_);
-    shell.printfln("MQTT queue: %d", queuecount_);
+    queue_update();
+    shell.printfln("MQTT queue: %d messages, %lu of %lu bytes, high-water %d messages, %lu bytes",
+                   queuecount_,
+                   queuebytes_,
+                   mqttClient_->queueLimit(),
+                   queue_hwm_count_,
+                   queue_hwm_bytes_);
+    shell.printfln("MQTT queue drops: %lu low memory, %lu queue full, %lu queue bytes, %lu client",
+                   queue_drops_[DROP_LOW_MEMORY],
+                   queue_drops_[DROP_QUEUE_FULL],
+                   queue_drops_[DROP_QUEUE_BYTES],
+                   queue_drops_[DROP_CLIENT]);
+    bool on = backpressure();
+    shell.printfln("MQTT backpressure: %s, %lu times", on ? "on" : "off", backpressure_count_);
+
+    // the topics in the queue, with the number of messages and their bytes
+    if (queuecount_) {
+        struct QueuedTopic {
+            std::string topic;
+            uint16_t    count;
+            uint32_t    bytes;
+        };
+        std::vector<QueuedTopic> queued;
+        mqttClient_->forEachQueuedPublish([&queued](const char * topic, size_t topic_length, size_t size) {
+            for (auto & q : queued) {
+                if (q.topic.size() == topic_length && !memcmp(q.topic.c_str(), topic, topic_length)) {
+                    q.count++;
+                    q.bytes += size;
+                    return;
+                }
+            }
+            queued.push_back({std::string(topic, topic_length), 1, (uint32_t)size});
+        });
+        std::sort(queued.begin(), queued.end(), [](const QueuedTopic & a, const QueuedTopic & b) { return a.bytes > b.bytes; });
+        shell.printfln("MQTT queued topics:");
+        for (const auto & q : queued) {
+            shell.printfln(" %s: %d messages, %lu bytes", q.topic.c_str(), q.count, q.bytes);
+        }
+    }
+    if (ha_enabled_) {
+        if (ha_discovery_running_) {
+            uint8_t pending = 0;
+            for (const auto & emsdevice : EMSESP::emsdevices) {
+                pending += (emsdevice->ha_discovery() == EMSdevice::HADiscovery::HA_DISCOVERY_PENDING);
+            }
+            shell.printfln("MQTT discovery: running for %lu ms, %d configs (%lu bytes) queued, %d devices pending",
+                           uuid::get_uptime() - ha_discovery_start_,
+                           ha_discovery_configs_,
+                           ha_discovery_bytes_,
+                           pending);
+        } else {
+            shell.printfln("MQTT discovery: finished in %lu ms, %d configs (%lu bytes)", ha_discovery_time_, ha_discovery_configs_, ha_discovery_bytes_);
+        }
+    }
     shell.println();
 
     // show subscriptions
@@ -219,23 +305,19 @@ void Mqtt::incoming(const char * topic, const char * payload) {
 // received an MQTT message that we subscribed too
 // topic is the full path
 // payload is json or a single string and converted to a json with key 'value'
+// the payload is not terminated, see https://www.emelis.net/espMqttClient/#code-samples
 void Mqtt::on_message(const char * topic, const uint8_t * payload, size_t len) {
-    // the payload is not terminated
-    // convert payload to a null-terminated char string
-    // see https://www.emelis.net/espMqttClient/#code-samples
-    char message[len + 1];
-    memcpy(message, payload, len);
-    message[len] = '\0';
+    const char * message = (const char *)payload;
 
 #if defined(EMSESP_DEBUG)
     if (len) {
-        LOG_DEBUG("Received topic %s => payload '%s' (length %d)", topic, message, len);
+        LOG_DEBUG("Received topic %s => payload '%.*s' (length %d)", topic, (int)len, message, len);
     } else {
         LOG_DEBUG("Received topic %s", topic);
     }
 #endif
     // remove HA topics if we don't use discovery
-    if (strncmp(topic, discovery_prefix().c_str(), discovery_prefix().size()) == 0) {
+    if (!discovery_prefix_.empty() && !strncmp(topic, discovery_prefix_.c_str(), discovery_prefix_.size()) && topic[discovery_prefix_.size()] == '/') {
         if (!ha_enabled_ && len) { // don't ping pong the empty message
             queue_publish_message(topic, "", true);
             LOG_DEBUG("Remove topic %s", topic);
@@ -244,20 +326,27 @@ void Mqtt::on_message(const char * topic, const uint8_t * payload, size_t len) {
     }
 
     // for misconfigured mqtt servers and publish2command ignore echos
-    if (publish_single_ && publish_single2cmd_ && lasttopic_ == topic && lastpayload_ == message) {
-        LOG_DEBUG("Received echo message %s: %s", topic, message);
+    if (publish_single_ && publish_single2cmd_ && lasttopic_ == topic && lastpayload_.size() == len && !memcmp(lastpayload_.data(), message, len)) {
+        LOG_DEBUG("Received echo message %s: %.*s", topic, (int)len, message);
         return;
     }
 
-    // check first against any of our subscribed topics
-    for (const auto & mf : mqtt_subfunctions_) {
-        // add the base back
-        char full_topic[MQTT_TOPIC_MAX_SIZE];
-        snprintf(full_topic, sizeof(full_topic), "%s/%s", Mqtt::base().c_str(), mf.topic_.c_str());
-
-        if ((!strcmp(topic, full_topic)) && (mf.mqtt_subfunction_)) {
-            if (!(mf.mqtt_subfunction_)(message)) {
-                LOG_ERROR("error: invalid payload %s for this topic %s", message, topic);
+    // check first against any of our subscribed topics, strip the base once and look up the short topic
+    // the same topic can be subscribed for several device types, take the first registered one with a callback
+    size_t base_len = mqtt_base_.size();
+    if (!sub_index_.empty() && !strncmp(topic, mqtt_base_.c_str(), base_len) && topic[base_len] == '/') {
+        const char * sub_topic = topic + base_len + 1;
+        size_t       sub_len   = strlen(sub_topic);
+        uint32_t     hash      = Helpers::hash32(sub_topic, sub_len);
+        int32_t      index     = sub_index_.find(hash, [&](uint16_t i) {
+            const auto & mf = mqtt_subfunctions_[i];
+            return (mf.hash_ == hash) && mf.mqtt_subfunction_ && (mf.topic_.size() == sub_len) && !memcmp(mf.topic_.c_str(), sub_topic, sub_len);
+        });
+        if (index >= 0) {
+            // the callbacks take a terminated string, on the heap so large retained payloads can't overflow the stack
+            std::string message_text(message, len);
+            if (!(mqtt_subfunctions_[index].mqtt_subfunction_)(message_text.c_str())) {
+                LOG_ERROR("error: invalid payload %s for this topic %s", message_text.c_str(), topic);
                 Mqtt::queue_publish("response", "error: invalid data");
             }
             return;
@@ -272,10 +361,10 @@ void Mqtt::on_message(const char * topic, const uint8_t * payload, size_t len) {
     // convert payload into a json doc
     // if the payload doesn't not contain the key 'value' or 'data', treat the whole payload as the 'value'
     if (len != 0) {
-        DeserializationError error = deserializeJson(input_doc, (const char *)message);
+        DeserializationError error = deserializeJson(input_doc, message, len); // parsed from the payload, which is not terminated
         if (((!input_doc["value"].is<JsonVariantConst>()) && (!input_doc["data"].is<JsonVariantConst>())) || error) {
             input_doc.clear();
-            input_doc["value"] = (const char *)message; // always a string
+            input_doc["value"] = JsonString(message, len, JsonString::Copied); // always a string
         }
     }
 
@@ -344,10 +433,12 @@ void Mqtt::load_settings() {
         nested_format_      = mqttSettings.nested_format;
         publish_single_     = mqttSettings.publish_single;
         publish_single2cmd_ = mqttSettings.publish_single2cmd;
+        publish_changes_    = mqttSettings.publish_changes;
         send_response_      = mqttSettings.send_response;
         discovery_prefix_   = mqttSettings.discovery_prefix.c_str();
         entity_format_      = mqttSettings.entity_format;
         discovery_type_     = mqttSettings.discovery_type;
+        discovery_budget_   = mqttSettings.discovery_budget;
 
         // convert to milliseconds
         publish_time_boiler_     = mqttSettings.publish_time_boiler * 1000;
@@ -364,11 +455,14 @@ void Mqtt::load_settings() {
     // and replacing all / with underscores, in case it's a path
     mqtt_basename_ = mqtt_base_;
     std::replace(mqtt_basename_.begin(), mqtt_basename_.end(), '/', '_');
+
+    topics_version_++; // nested format or single topic settings may have changed
 }
 
 // start mqtt
 void Mqtt::start() {
     mqttClient_ = EMSESP::esp8266React.getMqttClient();
+    mqttClient_->setQueueLimit(EMSESP::system_.PSram() ? MQTT_QUEUE_MAX_BYTES_PSRAM : MQTT_QUEUE_MAX_BYTES);
 
     load_settings(); // fetch MQTT settings
 
@@ -500,13 +594,13 @@ void Mqtt::on_connect() {
 
     connecting_ = true;
     connectcount_++; // count # reconnects. not currently used.
-    queuecount_ = mqttClient_->queueSize();
+    queue_update();
 
     load_settings(); // reload MQTT settings - in case they have changes
 
     if (ha_enabled_) {
         queue_unsubscribe_message(discovery_prefix_ + "/+/" + mqtt_basename_ + "/#");
-        EMSESP::reset_mqtt_ha(); // re-create all HA devices if there are any
+        EMSESP::publish_all(true); // publish all values and re-create all HA devices if there are any
         ha_status();             // create the EMS-ESP device in HA, which is MQTT retained
         ha_climate_reset(true);
     } else {
@@ -610,36 +704,13 @@ bool Mqtt::queue_message(const uint8_t operation, const std::string & topic, con
     if (!mqtt_enabled_ || topic.empty() || !connected()) {
         return false; // quit, not using MQTT
     }
-// check free mem
-#ifndef EMSESP_STANDALONE
-    // if (ESP.getFreeHeap() < 60 * 1024 || ESP.getMaxAllocHeap() < 40 * 1024) {
-    if (heap_caps_get_free_size(MALLOC_CAP_8BIT) < 60 * 1024) { // checks free Heap+PSRAM
-        if (operation == Operation::PUBLISH) {
-            mqtt_message_id_++;
-            mqtt_publish_fails_++;
-        }
-        LOG_WARNING("%s failed: low memory", operation == Operation::PUBLISH ? "Publish" : operation == Operation::SUBSCRIBE ? "Subscribe" : "Unsubscribe");
-        return false; // quit
-    }
-    if (queuecount_ >= MQTT_QUEUE_MAX_SIZE) {
-        if (operation == Operation::PUBLISH) {
-            mqtt_message_id_++;
-            mqtt_publish_fails_++;
-        }
-        LOG_WARNING("%s failed: queue full", operation == Operation::PUBLISH ? "Publish" : operation == Operation::SUBSCRIBE ? "Subscribe" : "Unsubscribe");
-        return false; // quit
+    if (!queue_has_space(operation, topic.size() + payload.size())) {
+        return false;
     }
-#endif
 
     uint16_t packet_id = 0;
     char     fulltopic[MQTT_TOPIC_MAX_SIZE];
-
-    if (topic.find(discovery_prefix_) == 0) {
-        strlcpy(fulltopic, topic.c_str(), sizeof(fulltopic)); // leave discovery topic as it is
-    } else {
-        // it's not a discovery topic, added the mqtt base to the topic path
-        snprintf(fulltopic, sizeof(fulltopic), "%s/%s", Mqtt::base().c_str(), topic.c_str());
-    }
+    make_fulltopic(fulltopic, topic.c_str());
 
     if (operation == Operation::PUBLISH) {
         packet_id = mqttClient_->publish(fulltopic, mqtt_qos_, retain, payload.c_str());
@@ -654,13 +725,134 @@ bool Mqtt::queue_message(const uint8_t operation, const std::string & topic, con
     }
 #ifndef EMSESP_STANDALONE
     if (packet_id == 0) {
-        LOG_WARNING("%s failed: %s", operation == Operation::PUBLISH ? "Publish" : operation == Operation::SUBSCRIBE ? "Subscribe" : "Unsubscribe", fulltopic);
-        mqtt_publish_fails_++;
+        queue_dropped(operation, DROP_CLIENT, fulltopic);
+    }
+#endif
+    queue_update();
+    return (packet_id != 0);
+}
+
+// the topic as published, a discovery topic is left as it is, others get the mqtt base added
+void Mqtt::make_fulltopic(char * fulltopic, const char * topic) {
+    if (!strncmp(topic, discovery_prefix_.c_str(), discovery_prefix_.size())) {
+        strlcpy(fulltopic, topic, MQTT_TOPIC_MAX_SIZE); // leave discovery topic as it is
+    } else {
+        snprintf(fulltopic, MQTT_TOPIC_MAX_SIZE, "%s/%s", mqtt_base_.c_str(), topic);
+    }
+}
+
+// publish a json object, serialized straight into the outbox packet instead of a string that is copied there
+// so the payload is only once on the heap
+bool Mqtt::queue_publish_json(const char * topic, const JsonObjectConst payload, const bool retain) {
+    if (!mqtt_enabled_ || !*topic || !connected()) {
+        return false;
+    }
+    size_t payload_length = measureJson(payload);
+    if (!queue_has_space(Operation::PUBLISH, strlen(topic) + payload_length)) {
+        return false;
+    }
+
+    char fulltopic[MQTT_TOPIC_MAX_SIZE];
+    make_fulltopic(fulltopic, topic);
+
+    uint16_t packet_id = mqttClient_->publish(
+        fulltopic, mqtt_qos_, retain, [payload](uint8_t * data, size_t length) { serializeJson(payload, data, length); }, payload_length);
+    mqtt_message_id_++;
+    LOG_DEBUG("Publishing topic '%s', pid %d", fulltopic, packet_id);
+#ifndef EMSESP_STANDALONE
+    if (packet_id == 0) {
+        queue_dropped(Operation::PUBLISH, DROP_CLIENT, fulltopic);
+    }
+#endif
+    queue_update();
+    return (packet_id != 0);
+}
+
+// publish a single value to a topic that already includes the base, as cached by the devices
+// no strings are built, the topic and payload are copied straight into the outbox
+bool Mqtt::queue_publish_value(const char * fulltopic, const char * payload) {
+    if (!mqtt_enabled_ || !connected() || !queue_has_space(Operation::PUBLISH, strlen(fulltopic) + strlen(payload))) {
+        return false;
+    }
+
+    uint16_t packet_id = mqttClient_->publish(fulltopic, mqtt_qos_, mqtt_retain_, payload);
+    mqtt_message_id_++;
+    LOG_DEBUG("Publishing topic '%s', pid %d", fulltopic, packet_id);
+#ifndef EMSESP_STANDALONE
+    if (packet_id == 0) {
+        queue_dropped(Operation::PUBLISH, DROP_CLIENT, fulltopic);
     }
 #endif
+    queue_update();
     return (packet_id != 0);
 }
 
+// check free mem, the queue size and its bytes before adding to the queue
+// length is the topic and payload, without the mqtt base
+bool Mqtt::queue_has_space(const uint8_t operation, const size_t length) {
+#ifndef EMSESP_STANDALONE
+    // if (ESP.getFreeHeap() < 60 * 1024 || ESP.getMaxAllocHeap() < 40 * 1024) {
+    if (heap_caps_get_free_size(MALLOC_CAP_8BIT) < 60 * 1024) { // checks free Heap+PSRAM
+        queue_dropped(operation, DROP_LOW_MEMORY, nullptr);
+        return false; // quit
+    }
+    if (queuecount_ >= MQTT_QUEUE_MAX_SIZE) {
+        queue_dropped(operation, DROP_QUEUE_FULL, nullptr);
+        return false; // quit
+    }
+#endif
+    // the packet header and the base are not known here, the client makes the exact check
+    auto limit = mqttClient_->queueLimit();
+    if (limit && (queuebytes_ + length > limit)) {
+        queue_dropped(operation, DROP_QUEUE_BYTES, nullptr);
+        return false; // quit
+    }
+    return true;
+}
+
+// count and log a message that is not queued
+void Mqtt::queue_dropped(const uint8_t operation, const uint8_t reason, const char * topic) {
+    queue_drops_[reason]++;
+    if (operation == Operation::PUBLISH && reason != DROP_CLIENT) {
+        mqtt_message_id_++; // a publish refused by the client is already counted
+    }
+    if (operation == Operation::PUBLISH || reason == DROP_CLIENT) {
+        mqtt_publish_fails_++;
+    }
+    const char * op = operation == Operation::PUBLISH ? "Publish" : operation == Operation::SUBSCRIBE ? "Subscribe" : "Unsubscribe";
+    if (reason == DROP_CLIENT) {
+        LOG_WARNING("%s failed: %s", op, topic);
+    } else {
+        LOG_WARNING("%s failed: %s", op, reason == DROP_LOW_MEMORY ? "low memory" : reason == DROP_QUEUE_FULL ? "queue full" : "queue bytes full");
+    }
+}
+
+// read the queue of the client and keep the high-water marks
+void Mqtt::queue_update() {
+    queuecount_ = mqttClient_->queueSize();
+    queuebytes_ = mqttClient_->queueBytes();
+    if (queuecount_ > queue_hwm_count_) {
+        queue_hwm_count_ = queuecount_;
+    }
+    if (queuebytes_ > queue_hwm_bytes_) {
+        queue_hwm_bytes_ = queuebytes_;
+    }
+}
+
+// true when the queue is filling up or the heap runs low
+// new payloads are not generated then, they would be dropped by queue_has_space()
+bool Mqtt::backpressure() {
+    bool on = (queuecount_ >= MQTT_QUEUE_MAX_SIZE * 3 / 4) || (mqttClient_->queueLimit() && queuebytes_ >= mqttClient_->queueLimit() * 3 / 4);
+#ifndef EMSESP_STANDALONE
+    on |= (heap_caps_get_free_size(MALLOC_CAP_8BIT) < 70 * 1024);
+#endif
+    if (on && !backpressure_) {
+        backpressure_count_++;
+    }
+    backpressure_ = on;
+    return on;
+}
+
 // add MQTT message to queue, payload is a string
 bool Mqtt::queue_publish_message(const std::string & topic, const std::string & payload, const bool retain) {
     return queue_message(Operation::PUBLISH, topic, payload, retain);
@@ -711,7 +903,11 @@ bool Mqtt::queue_publish_retain(const std::string & topic, const JsonObjectConst
 }
 
 bool Mqtt::queue_publish_retain(const char * topic, const JsonObjectConst payload, const bool retain) {
+    if (payload.size() && strcmp(topic, "response")) {
+        return queue_publish_json(topic, payload, retain);
+    }
     if (payload.size()) {
+        // the response is also kept as text, see queue_message()
         std::string payload_text;
         payload_text.reserve(measureJson(payload) + 1);
         serializeJson(payload, payload_text); // convert json to string
@@ -735,39 +931,67 @@ bool Mqtt::queue_ha(const char * topic, const JsonObjectConst payload) {
         return false;
     }
 
-    std::string payload_text;
-    payload_text.reserve(measureJson(payload) + 1);
-    serializeJson(payload, payload_text); // convert json to string
+    // count against the budget of this loop, also if the queue refuses it, the work is done
+    size_t length   = measureJson(payload);
+    ha_budget_msgs_ = ha_budget_msgs_ ? ha_budget_msgs_ - 1 : 0;
+    ha_budget_bytes_ -= length;
+    ha_discovery_configs_++;
+    ha_discovery_bytes_ += length;
 
-    return queue_publish_message(Mqtt::discovery_prefix() + topic, payload_text, true); // with retain true
+    char fulltopic[MQTT_TOPIC_MAX_SIZE];
+    snprintf(fulltopic, sizeof(fulltopic), "%s%s", discovery_prefix().c_str(), topic);
+    return queue_publish_json(fulltopic, payload, true); // with retain true
 }
 
-// create's a ha sensor config topic from a device value object
-// and also takes a flag (create_device_config) used to also create the main HA device config. This is only needed for one entity
-bool Mqtt::publish_ha_sensor_config(DeviceValue & dv, const char * model, const char * brand, const bool remove, const bool create_device_config) {
+// a discovery rollout starts, called from EMSESP::reset_mqtt_ha()
+void Mqtt::ha_discovery_start() {
+    ha_discovery_running_ = true;
+    ha_discovery_start_   = uuid::get_uptime();
+    ha_discovery_configs_ = 0;
+    ha_discovery_bytes_   = 0;
+}
+
+// all devices have their configs, called from EMSESP::ha_discovery_loop()
+void Mqtt::ha_discovery_finish() {
+    if (!ha_discovery_running_) {
+        return;
+    }
+    ha_discovery_running_ = false;
+    ha_discovery_time_    = uuid::get_uptime() - ha_discovery_start_;
+    LOG_INFO("MQTT discovery finished in %lu ms, %d configs (%lu bytes)", ha_discovery_time_, ha_discovery_configs_, ha_discovery_bytes_);
+}
+
+// the serialized "dev" section of the discovery configs of a device type
+// always with the ids (discovery identifiers) and the name
+// and the manufacturer and model if we're creating the device config, this is only needed for one entity
+std::string Mqtt::ha_device_json(const uint8_t device_type, const char * model, const char * brand) {
     JsonDocument dev_json;
 
-    // always create the ids (discovery identifiers)
-    // with the name always
-    // and the manufacturer and model if we're creating the device config for the first entity
     JsonArray ids = dev_json["ids"].to<JsonArray>();
     char      ha_device[40];
-    auto      device_type_name = EMSdevice::device_type_2_device_name(dv.device_type);
+    auto      device_type_name = EMSdevice::device_type_2_device_name(device_type);
     snprintf(ha_device, sizeof(ha_device), "%s-%s", Mqtt::basename().c_str(), device_type_name);
     ids.add(ha_device);
 
-    auto cap_name = strdup(device_type_name);
+    char cap_name[30];
+    strlcpy(cap_name, device_type_name, sizeof(cap_name));
     Helpers::CharToUpperUTF8(cap_name); // capitalize first letter
     dev_json["name"] = Mqtt::basename() + " " + cap_name;
-    free(cap_name);
 
-    // create only once per category
-    if (create_device_config) {
+    if (model) {
         dev_json["mf"]         = brand;
         dev_json["mdl"]        = model;
         dev_json["via_device"] = Mqtt::basename();
     }
 
+    std::string dev_text;
+    serializeJson(dev_json, dev_text);
+    return dev_text;
+}
+
+// create's a ha sensor config topic from a device value object
+// dev_json is the serialized "dev" section from ha_device_json(), rendered once per device
+bool Mqtt::publish_ha_sensor_config(DeviceValue & dv, const char * dev_json, const bool remove) {
     // calculate the min and max
     int16_t  dv_set_min;
     uint32_t dv_set_max;
@@ -792,20 +1016,21 @@ bool Mqtt::publish_ha_sensor_config(DeviceValue & dv, const char * model, const
                                     dv_set_min,
                                     dv_set_max,
                                     dv.numeric_operator,
-                                    dev_json.as<JsonObject>());
+                                    dev_json);
 }
 
 // publish HA sensor for System using the heartbeat tag
 bool Mqtt::publish_system_ha_sensor_config(uint8_t type, const char * name, const char * entity, const uint8_t uom) {
-    JsonDocument doc;
-    JsonObject   dev_json = doc["dev"].to<JsonObject>();
-
+    JsonDocument dev_json;
     dev_json["name"] = Mqtt::basename();
     JsonArray ids    = dev_json["ids"].to<JsonArray>();
     ids.add(Mqtt::basename());
 
+    std::string dev_text;
+    serializeJson(dev_json, dev_text);
+
     return publish_ha_sensor_config(
-        type, DeviceValueTAG::TAG_DEVICE_DATA, name, name, EMSdevice::DeviceType::SYSTEM, entity, uom, false, false, nullptr, 0, 0, 0, 0, dev_json);
+        type, DeviceValueTAG::TAG_DEVICE_DATA, name, name, EMSdevice::DeviceType::SYSTEM, entity, uom, false, false, nullptr, 0, 0, 0, 0, dev_text.c_str());
 }
 
 // MQTT discovery configs
@@ -825,7 +1050,7 @@ bool Mqtt::publish_ha_sensor_config(uint8_t               type,        // EMSdev
                                     const int16_t         dv_set_min,
                                     const uint32_t        dv_set_max,
                                     const int8_t          num_op,
-                                    const JsonObjectConst dev_json) {
+                                    const char * const    dev_json) {
     // ignore if name (fullname) is empty
     if (!fullname || !en_name) {
         return false;
@@ -1137,7 +1362,7 @@ bool Mqtt::publish_ha_sensor_config(uint8_t               type,        // EMSdev
         add_ha_uom(doc.as<JsonObject>(), type, uom, entity); // add the UoM, device and state class
     }
 
-    doc["dev"] = dev_json;
+    doc["dev"] = serialized(dev_json); // already rendered, copied in as it is
 
     return queue_ha(topic, doc.as<JsonObject>());
 }
@@ -62,6 +62,11 @@ class Mqtt {
 
     static constexpr uint8_t  MQTT_TOPIC_MAX_SIZE = 128; // fixed, not a user setting anymore
     static constexpr uint16_t MQTT_QUEUE_MAX_SIZE = 300;
+    static constexpr uint32_t MQTT_QUEUE_MAX_BYTES       = 32 * 1024;  // limit of the outbox packets
+    static constexpr uint32_t MQTT_QUEUE_MAX_BYTES_PSRAM = 128 * 1024; // with PSRAM
+
+    // why a message is not queued, counted for "show mqtt"
+    enum DropReason : uint8_t { DROP_LOW_MEMORY, DROP_QUEUE_FULL, DROP_QUEUE_BYTES, DROP_CLIENT, DROP_REASONS };
 
     static void on_connect();
     static void on_disconnect(espMqttClientTypes::DisconnectReason reason);
@@ -78,10 +83,11 @@ class Mqtt {
     static bool queue_publish_retain(const std::string & topic, const JsonObjectConst payload, const bool retain);
     static bool queue_publish_retain(const char * topic, const std::string & payload, const bool retain);
     static bool queue_publish_retain(const char * topic, const JsonObjectConst payload, const bool retain);
+    static bool queue_publish_value(const char * fulltopic, const char * payload);
     static bool queue_ha(const char * topic, const JsonObjectConst payload);
     static bool queue_remove_topic(const char * topic);
 
-    static bool publish_ha_sensor_config(DeviceValue & dv, const char * model, const char * brand, const bool remove, const bool create_device_config = false);
+    static bool publish_ha_sensor_config(DeviceValue & dv, const char * dev_json, const bool remove);
     static bool publish_ha_sensor_config(uint8_t               type,
                                          int8_t                tag,
                                          const char * const    fullname,
@@ -96,7 +102,8 @@ class Mqtt {
                                          const int16_t         dv_set_min,
                                          const uint32_t        dv_set_max,
                                          const int8_t          num_op,
-                                         const JsonObjectConst dev_json);
+                                         const char * const    dev_json);
+    static std::string ha_device_json(const uint8_t device_type, const char * model = nullptr, const char * brand = nullptr);
 
     static bool publish_system_ha_sensor_config(uint8_t type, const char * name, const char * entity, const uint8_t uom);
     static bool publish_ha_climate_config(const int8_t tag, const bool has_roomtemp, const bool remove = false, const int16_t min = 5, const uint32_t max = 30);
@@ -154,6 +161,8 @@ class Mqtt {
         return queuecount_;
     }
 
+    static bool backpressure();
+
     static uint8_t connect_count() {
         return connectcount_;
     }
@@ -178,6 +187,7 @@ class Mqtt {
 
     static void nested_format(uint8_t nested_format) {
         nested_format_ = nested_format;
+        topics_version_++;
     }
 
     static bool publish_single() {
@@ -188,14 +198,55 @@ class Mqtt {
         return publish_single2cmd_;
     }
 
+    static void publish_single2cmd(bool publish_single2cmd) {
+        publish_single2cmd_ = publish_single2cmd;
+        topics_version_++;
+    }
+
     static void publish_single(bool publish_single) {
         publish_single_ = publish_single;
+        topics_version_++;
+    }
+
+    // changes whenever a setting the topics are built from changes, so the devices can rebuild their cached topic prefixes
+    static uint32_t topics_version() {
+        return topics_version_;
+    }
+
+    // only publish the entities that changed, not usable with discovery or single topics
+    static bool publish_changes() {
+        return mqtt_enabled_ && publish_changes_ && !ha_enabled_ && !publish_single_;
+    }
+
+    static void publish_changes(bool publish_changes) {
+        publish_changes_ = publish_changes;
     }
 
     static bool ha_enabled() {
         return mqtt_enabled_ && ha_enabled_;
     }
 
+    // the discovery configs queued per loop are limited by the discovery_budget setting and HA_BUDGET_BYTES
+    static void ha_budget_reset() {
+        ha_budget_msgs_  = discovery_budget_ ? discovery_budget_ : 1;
+        ha_budget_bytes_ = HA_BUDGET_BYTES;
+    }
+
+    static bool ha_budget_left() {
+        return ha_budget_msgs_ > 0 && ha_budget_bytes_ > 0;
+    }
+
+    static void discovery_budget(uint8_t discovery_budget) {
+        discovery_budget_ = discovery_budget;
+    }
+
+    static void ha_discovery_start();
+    static void ha_discovery_finish();
+
+    static uint16_t ha_discovery_configs() {
+        return ha_discovery_configs_;
+    }
+
     static void ha_enabled(bool ha_enabled) {
         ha_enabled_ = ha_enabled;
     }
@@ -245,6 +296,11 @@ class Mqtt {
 
     static bool queue_message(const uint8_t operation, const std::string & topic, const std::string & payload, const bool retain);
     static bool queue_publish_message(const std::string & topic, const std::string & payload, const bool retain);
+    static bool queue_has_space(const uint8_t operation, const size_t length = 0);
+    static void queue_dropped(const uint8_t operation, const uint8_t reason, const char * topic);
+    static void queue_update();
+    static bool queue_publish_json(const char * topic, const JsonObjectConst payload, const bool retain);
+    static void make_fulltopic(char * fulltopic, const char * topic);
     static void queue_subscribe_message(const std::string & topic);
     static void queue_unsubscribe_message(const std::string & topic);
 
@@ -255,17 +311,21 @@ class Mqtt {
         uint8_t             device_type_;      // which device type, from DeviceType::
         const std::string   topic_;            // short topic name
         mqtt_sub_function_p mqtt_subfunction_; // can be empty
+        uint32_t            hash_;             // of topic_
 
         // replaced &&topic with &topic in 3.7.0-dev.43, so we prevent the std:move later
         MQTTSubFunction(uint8_t device_type, const std::string & topic, mqtt_sub_function_p mqtt_subfunction)
             : device_type_(device_type)
             , topic_(topic)
-            , mqtt_subfunction_(mqtt_subfunction) {
+            , mqtt_subfunction_(mqtt_subfunction)
+            , hash_(Helpers::hash32(topic.c_str(), topic.size())) {
         }
     };
 
     static std::vector<MQTTSubFunction> mqtt_subfunctions_; // list of mqtt subscribe callbacks for all devices
 
+    static HashIndex sub_index_; // on the short topic to the position in mqtt_subfunctions_
+
     uint32_t last_publish_boiler_     = 0;
     uint32_t last_publish_thermostat_ = 0;
     uint32_t last_publish_solar_      = 0;
@@ -274,12 +334,19 @@ class Mqtt {
     uint32_t last_publish_other_      = 0;
     uint32_t last_publish_sensor_     = 0;
     uint32_t last_publish_heartbeat_  = 0;
+    uint32_t last_publish_full_       = 0;
     // uint32_t last_publish_queue_      = 0;
 
     static bool     connecting_;
     static bool     initialized_;
     static uint32_t mqtt_publish_fails_;
     static uint16_t queuecount_;
+    static uint32_t queuebytes_;
+    static uint16_t queue_hwm_count_; // high-water marks
+    static uint32_t queue_hwm_bytes_;
+    static uint32_t queue_drops_[DROP_REASONS];
+    static bool     backpressure_;
+    static uint32_t backpressure_count_;
     static uint8_t  connectcount_;
     static bool     ha_climate_reset_;
 
@@ -309,7 +376,22 @@ class Mqtt {
     static uint8_t     discovery_type_;
     static bool        publish_single_;
     static bool        publish_single2cmd_;
+    static bool        publish_changes_;
     static bool        send_response_;
+    static uint32_t    topics_version_;
+    static uint8_t     discovery_budget_;
+
+    // discovery rollout, from reset_mqtt_ha() until all devices have their configs
+    static uint8_t  ha_budget_msgs_;
+    static int32_t  ha_budget_bytes_;
+    static bool     ha_discovery_running_;
+    static uint32_t ha_discovery_start_;
+    static uint32_t ha_discovery_time_; // duration of the last completed rollout in ms
+    static uint16_t ha_discovery_configs_;
+    static uint32_t ha_discovery_bytes_;
+
+    static constexpr uint32_t PUBLISH_FULL_REFRESH = 600000; // 10 minutes, full publish when only publishing changes
+    static constexpr int32_t  HA_BUDGET_BYTES      = 8192;   // discovery payload bytes per loop
 };
 
 } // namespace emsesp
@@ -34,6 +34,7 @@ class Token {
         Unary,
         LeftParen,
         RightParen,
+        Entity, // placeholder for a bound entity in a compiled condition, str holds the index + 1
     };
 
     Token(Type type, const std::string & s, int8_t precedence = -1, bool rightAssociative = false)
@@ -56,6 +57,9 @@ std::deque<Token> exprToTokens(const std::string & expr) {
     for (const auto * p = expr.c_str(); *p; ++p) {
         if (isblank(*p)) {
             // do nothing
+        } else if (*p == '\x01' && p[1]) { // entity placeholder from ScheduleCondition::compile()
+            ++p;
+            tokens.emplace_back(Token::Type::Entity, std::string(1, *p), -4);
         } else if (*p == '{') { // json is stored as string including {}
             const auto * b = p;
             ++p;
@@ -225,6 +229,7 @@ std::deque<Token> shuntingYard(const std::deque<Token> & tokens) {
         switch (token.type) {
         case Token::Type::Number:
         case Token::Type::String:
+        case Token::Type::Entity:
             // If the token is a number, then add it to the output queue
             queue.push_back(token);
             break;
@@ -315,13 +320,25 @@ std::deque<Token> shuntingYard(const std::deque<Token> & tokens) {
 }
 
 // check if string is a number
+// an empty token or a single minus is not a number
 bool isnum(const std::string & s) {
+    if (s.empty() || s == "-") {
+        return false;
+    }
     if (s.find_first_not_of("0123456789.") == std::string::npos || (s[0] == '-' && s.find_first_not_of("0123456789.", 1) == std::string::npos)) {
         return true;
     }
     return false;
 }
 
+bool isnum(const char * s) {
+    auto l = strlen(s);
+    if (l == 0 || (l == 1 && s[0] == '-')) {
+        return false;
+    }
+    return strspn(s, "0123456789.") == l || (s[0] == '-' && strspn(s + 1, "0123456789.") == l - 1);
+}
+
 
 // replace commands like "<device>/<hc>/<cmd>" with its value"
 std::string commands(std::string & expr, bool quotes = true) {
@@ -381,6 +398,16 @@ int to_logic(const std::string & s) {
     return -1;
 }
 
+int to_logic(const char * s) {
+    if (s[0] == '1' || !strcmp(s, "on") || !strcmp(s, "ON") || !strcmp(s, "true")) {
+        return 1;
+    }
+    if (s[0] == '0' || !strcmp(s, "off") || !strcmp(s, "OFF") || !strcmp(s, "false")) {
+        return 0;
+    }
+    return -1;
+}
+
 // number to string, remove trailing zeros
 std::string to_string(double d) {
     std::string s = std::to_string(d);
@@ -569,6 +596,7 @@ std::string calculate(const std::string & expr) {
         } break;
         case Token::Type::LeftParen:
         case Token::Type::RightParen:
+        case Token::Type::Entity:
         case Token::Type::Unknown:
         default:
             return "";
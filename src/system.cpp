@@ -387,6 +387,8 @@ void System::reload_settings() {
         modbus_port_        = settings.modbus_port;
         modbus_max_clients_ = settings.modbus_max_clients;
         modbus_timeout_     = settings.modbus_timeout;
+        modbus_strict_      = settings.modbus_strict;
+        fetch_budget_       = settings.fetch_budget;
 
         rx_gpio_     = settings.rx_gpio;
         tx_gpio_     = settings.tx_gpio;
@@ -1564,6 +1566,7 @@ bool System::command_info(const char * value, const int8_t id, JsonObject output
         node["base"]                  = settings.base;
         node["discoveryPrefix"]       = settings.discovery_prefix;
         node["discoveryType"]         = settings.discovery_type;
+        node["discoveryBudget"]       = settings.discovery_budget;
         node["nestedFormat"]          = settings.nested_format;
         node["haEnabled"]             = settings.ha_enabled;
         node["mqttQos"]               = settings.mqtt_qos;
@@ -1578,6 +1581,7 @@ bool System::command_info(const char * value, const int8_t id, JsonObject output
         node["publishTimeSensor"]     = settings.publish_time_sensor;
         node["publishSingle"]         = settings.publish_single;
         node["publish2command"]       = settings.publish_single2cmd;
+        node["publishChanges"]        = settings.publish_changes;
         node["sendResponse"]          = settings.send_response;
     });
 
@@ -1617,6 +1621,10 @@ bool System::command_info(const char * value, const int8_t id, JsonObject output
     node["APICalls"] = WebAPIService::api_count();
     node["APIFails"] = WebAPIService::api_fails();
 #endif
+#ifndef EMSESP_STANDALONE
+    node["authCacheHits"]   = EMSESP::esp8266React.jwtCacheHits();
+    node["authCacheMisses"] = EMSESP::esp8266React.jwtCacheMisses();
+#endif
 
     // EMS Bus Status
     node = output["bus"].to<JsonObject>();
@@ -1643,6 +1651,13 @@ bool System::command_info(const char * value, const int8_t id, JsonObject output
     node["busWritesFailed"]        = EMSESP::txservice_.telegram_write_fail_count();
     node["busRxLineQuality"]       = EMSESP::rxservice_.quality();
     node["busTxLineQuality"]       = (EMSESP::txservice_.read_quality() + EMSESP::txservice_.read_quality()) / 2;
+    char stats[100];
+    (void)EMSESP::txservice_.show_priority_stats(TxService::CONTROL, stats, sizeof(stats));
+    node["busTxControl"] = stats;
+    (void)EMSESP::txservice_.show_priority_stats(TxService::INTERACTIVE, stats, sizeof(stats));
+    node["busTxInteractive"] = stats;
+    (void)EMSESP::txservice_.show_priority_stats(TxService::BACKGROUND, stats, sizeof(stats));
+    node["busTxBackground"] = stats;
 
     // Settings
     node = output["settings"].to<JsonObject>();
@@ -1722,6 +1737,10 @@ bool System::command_info(const char * value, const int8_t id, JsonObject output
                     if (result[0] != '\0') {
                         obj["handlersIgnored"] = result;
                     }
+                    (void)emsdevice->show_fetch_intervals(result, sizeof(result));
+                    if (result[0] != '\0') {
+                        obj["fetchIntervals"] = result;
+                    }
                 }
             }
         }
@@ -158,6 +158,19 @@ class System {
         return modbus_timeout_;
     }
 
+    bool modbus_strict() {
+        return modbus_strict_;
+    }
+
+    // max. automatic read requests per minute, 0 for a fixed fetch of everything every minute
+    uint8_t fetch_budget() {
+        return fetch_budget_;
+    }
+
+    void fetch_budget(uint8_t fetch_budget) {
+        fetch_budget_ = fetch_budget;
+    }
+
     bool analog_enabled() {
         return analog_enabled_;
     }
@@ -398,6 +411,8 @@ class System {
     uint16_t    modbus_port_;
     uint8_t     modbus_max_clients_;
     uint32_t    modbus_timeout_;
+    bool        modbus_strict_;
+    uint8_t     fetch_budget_;
 
     // ethernet
     uint8_t phy_type_;
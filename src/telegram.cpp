@@ -126,8 +126,63 @@ std::string Telegram::to_string_message() const {
     return Helpers::data_to_hex(this->message_data, this->message_length);
 }
 
+TelegramPool::Slot   TelegramPool::slots_[TelegramPool::NUM_SLOTS];
+TelegramPool::Slot * TelegramPool::free_        = nullptr;
+uint16_t             TelegramPool::unused_      = TelegramPool::NUM_SLOTS;
+uint16_t             TelegramPool::in_use_      = 0;
+uint16_t             TelegramPool::high_water_  = 0;
+uint32_t             TelegramPool::pool_allocs_ = 0;
+uint32_t             TelegramPool::heap_allocs_ = 0;
+std::mutex           TelegramPool::mutex_;
+
+// takes a free slot, or goes to the heap if the pool is exhausted or the size doesn't fit
+void * TelegramPool::allocate(const size_t size) {
+    if (size <= SLOT_SIZE) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Slot *                      slot = free_;
+        if (slot) {
+            free_ = slot->next;
+        } else if (unused_) {
+            slot = &slots_[--unused_];
+        }
+        if (slot) {
+            pool_allocs_++;
+            if (++in_use_ > high_water_) {
+                high_water_ = in_use_;
+            }
+            return slot;
+        }
+    }
+
+    heap_allocs_++;
+    return ::operator new(size);
+}
+
+void TelegramPool::deallocate(void * p) {
+    Slot * slot = static_cast<Slot *>(p);
+    if (slot < slots_ || slot >= slots_ + NUM_SLOTS) {
+        ::operator delete(p); // was a heap fallback
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    slot->next = free_;
+    free_      = slot;
+    in_use_--;
+}
+
 // checks if we have an Rx telegram that needs processing
 void RxService::loop() {
+    // parse the raw frames handed over by the UART task
+    if (frames_.dropped() != frames_dropped_reported_) {
+        LOG_WARNING("Rx buffer full, %d telegrams dropped", frames_.dropped() - frames_dropped_reported_);
+        frames_dropped_reported_ = frames_.dropped();
+    }
+    while (auto frame = frames_.front()) {
+        add(frame->data, frame->length, frame->empty);
+        frames_.pop();
+    }
+
     while (!rx_telegrams_.empty()) {
         auto telegram = rx_telegrams_.front().telegram_;
         (void)EMSESP::process_telegram(telegram); // further process the telegram
@@ -140,7 +195,8 @@ void RxService::loop() {
 // data is the whole telegram, assuming last byte holds the CRC
 // length includes the CRC
 // for EMS+ the type_id has the value + 256. We look for these type of telegrams with F7, F9 and FF in 3rd byte
-void RxService::add(uint8_t * data, uint8_t length) {
+// empty is set for the telegrams of add_empty(), which are not shown in the raw trace
+void RxService::add(uint8_t * data, uint8_t length, const bool empty) {
     if (length < 5) {
         return;
     }
@@ -161,7 +217,7 @@ void RxService::add(uint8_t * data, uint8_t length) {
     // we check the 1st byte, which assumed is the src ID and see if the MSB (8th bit) is set
     // this is used to identify if the protocol should be Junkers/HT3 or Buderus
     // this only happens once with the first valid rx telegram is processed
-    if (ems_mask() == EMS_MASK_UNSET) {
+    if (ems_mask() == EMS_MASK_UNSET && !empty) {
         ems_mask(data[0]);
     }
 
@@ -199,7 +255,7 @@ void RxService::add(uint8_t * data, uint8_t length) {
 
     // if we're watching and "raw" print out actual telegram as bytes to the console
     // including the CRC at the end
-    if (EMSESP::watch() == EMSESP::Watch::WATCH_RAW) {
+    if (!empty && EMSESP::watch() == EMSESP::Watch::WATCH_RAW) {
         uint16_t trace_watch_id = EMSESP::watch_id();
         if ((trace_watch_id == WATCH_ID_NONE) || (type_id == trace_watch_id)
             || ((trace_watch_id < 0x80) && ((src == trace_watch_id) || (dest == trace_watch_id)))) {
@@ -207,7 +263,7 @@ void RxService::add(uint8_t * data, uint8_t length) {
         } else if (EMSESP::trace_raw()) {
             LOG_TRACE("Rx: %s", Helpers::data_to_hex(data, length).c_str());
         }
-    } else if (EMSESP::trace_raw()) {
+    } else if (!empty && EMSESP::trace_raw()) {
         LOG_TRACE("Rx: %s", Helpers::data_to_hex(data, length).c_str());
     }
 
@@ -220,7 +276,7 @@ void RxService::add(uint8_t * data, uint8_t length) {
     }
 
     // create the telegram
-    auto telegram = std::make_shared<Telegram>(operation, src, dest, type_id, offset, message_data, message_length);
+    auto telegram = make_telegram(operation, src, dest, type_id, offset, message_data, message_length);
 
     // check if queue is full, if so remove top item to make space
     if (rx_telegrams_.size() >= MAX_RX_TELEGRAMS) {
@@ -231,12 +287,23 @@ void RxService::add(uint8_t * data, uint8_t length) {
 }
 
 // add empty telegram to rx-queue
+// this is called from the UART task, so it goes through the frame buffer as a raw telegram without data
 void RxService::add_empty(const uint8_t src, const uint8_t dest, const uint16_t type_id, uint8_t offset) {
-    auto telegram = std::make_shared<Telegram>(Telegram::Operation::RX, src, dest, type_id, offset, nullptr, 0);
-    // only if queue is  not full
-    if (rx_telegrams_.size() < MAX_RX_TELEGRAMS) {
-        rx_telegrams_.emplace_back(rx_telegram_id_++, std::move(telegram)); // add to queue
+    uint8_t data[7];
+    uint8_t length = 0;
+    data[length++] = src;
+    data[length++] = dest;
+    if (type_id > 0xFF) {
+        data[length++] = 0xFF;
+        data[length++] = offset;
+        data[length++] = (type_id >> 8) - 1;
+        data[length++] = type_id & 0xFF;
+    } else {
+        data[length++] = type_id;
+        data[length++] = offset;
     }
+    data[length] = calculate_crc(data, length);
+    frames_.push(data, length + 1, true);
 }
 
 // start and initialize Tx
@@ -252,6 +319,10 @@ void TxService::start() {
     telegram_read_count(0);
     telegram_write_count(0);
     telegram_fail_count(0);
+    telegram_read_merged_count_  = 0;
+    telegram_write_merged_count_ = 0;
+    memset(priority_sent_, 0, sizeof(priority_sent_));
+    memset(priority_wait_, 0, sizeof(priority_wait_));
 
     // send first Tx request to bus master (boiler) for its registered devices
     // this will be added to the queue and sent during the first tx loop()
@@ -268,14 +339,18 @@ void TxService::send_poll() const {
 
 // get src id from next telegram to check poll in emsesp::incoming_telegram
 uint8_t TxService::get_send_id() {
-    static uint32_t count = 0;
-    if (!tx_telegrams_.empty() && tx_telegrams_.front().telegram_->src != ems_bus_id()) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    static uint32_t                       count = 0;
+    auto                                  next  = next_telegram();
+    if (next != tx_telegrams_.end() && next->telegram_->src != ems_bus_id()) {
         if (++count > 500) { // after 500 polls (~3-10 sec) there will be no master poll for this id
-            tx_telegrams_.pop_front();
+            tx_telegrams_.erase(next);
+            queue_changed();
             count = 0;
-            return tx_telegrams_.empty() ? ems_bus_id() : tx_telegrams_.front().telegram_->src;
+            next  = next_telegram();
+            return next == tx_telegrams_.end() ? ems_bus_id() : next->telegram_->src;
         }
-        return tx_telegrams_.front().telegram_->src;
+        return next->telegram_->src;
     }
     count = 0;
     return ems_bus_id();
@@ -289,19 +364,147 @@ void TxService::send() {
         return;
     }
 
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+
     // if there's nothing in the queue to transmit or sending should be delayed, send back a poll and quit
     if (tx_telegrams_.empty() || (delayed_send_ && uuid::get_uptime() < delayed_send_)) {
         send_poll();
         return;
     }
+
+    // nothing to send if the queue only holds new writes waiting for more writes to merge
+    auto next = next_telegram();
+    if (next == tx_telegrams_.end()) {
+        send_poll();
+        return;
+    }
     delayed_send_ = 0;
+    overtaken_    = next_starving_ ? overtaken_ + 1 : 0;
+
+    // how long it waited in the queue, retries are left out as they go first anyway
+    auto wait      = uuid::get_uptime() - next->queued_;
+    priority_last_ = next->priority_;
+    if (!next->retry_) {
+        priority_sent_[priority_last_]++;
+        priority_wait_[priority_last_][wait < 100 ? 0 : wait < 500 ? 1 : wait < 2000 ? 2 : wait < 10000 ? 3 : 4]++;
+    }
 
     // if we're in read-only mode (tx_mode 0) forget the Tx call
     if (tx_mode() != 0) {
-        send_telegram(tx_telegrams_.front());
+        send_telegram(*next);
     }
 
-    tx_telegrams_.pop_front(); // remove the telegram from the queue
+    tx_telegrams_.erase(next); // remove the telegram from the queue
+    queue_changed();
+}
+
+// the telegram to send next, selected once and kept until the queue changes or a held write or deadline runs out
+// so the polls, which all call get_send_id(), and send() don't run the selection every time and agree on the telegram
+// only its id_ is kept, the returned iterator is only valid while the caller holds mutex_
+std::deque<TxService::QueuedTxTelegram>::iterator TxService::next_telegram() {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    auto                                  now = uuid::get_uptime();
+    if (next_version_ == queue_version_ && now - next_selected_ < next_valid_) {
+        if (!next_found_) {
+            return tx_telegrams_.end();
+        }
+        auto next = std::find_if(tx_telegrams_.begin(), tx_telegrams_.end(), [this](const QueuedTxTelegram & tx) { return tx.id_ == next_id_; });
+        if (next != tx_telegrams_.end()) {
+            return next;
+        }
+    }
+    auto next      = select_telegram(now);
+    next_found_    = next != tx_telegrams_.end();
+    next_id_       = next_found_ ? next->id_ : 0;
+    next_version_  = queue_version_;
+    next_selected_ = now;
+    return next;
+}
+
+// a retry goes first and otherwise the highest priority class, end() if there is nothing to send yet
+// within a class the queue order is kept, so adding to the front or back of the queue works as before
+// a new write is held for WRITE_MERGE_TIME so that following writes to the same telegram can be merged into it, the others go first meanwhile
+// a telegram past its deadline is overtaken by higher classes at most MAX_OVERTAKEN times in a row, so it can't starve
+// sets next_starving_ and next_valid_, the time the selection stays the same if the queue doesn't change
+std::deque<TxService::QueuedTxTelegram>::iterator TxService::select_telegram(const uint32_t now) {
+    next_starving_ = false;
+    next_valid_    = UINT32_MAX;
+    if (tx_telegrams_.empty() || tx_telegrams_.front().retry_) {
+        return tx_telegrams_.begin();
+    }
+    auto next    = tx_telegrams_.end();
+    auto expired = tx_telegrams_.end();
+    for (auto it = tx_telegrams_.begin(); it != tx_telegrams_.end(); ++it) {
+        auto wait = now - it->queued_;
+        if (it->telegram_->operation == Telegram::Operation::TX_WRITE && !it->retry_ && wait < WRITE_MERGE_TIME) {
+            next_valid_ = std::min(next_valid_, WRITE_MERGE_TIME - wait);
+            continue;
+        }
+        if (next == tx_telegrams_.end() || it->priority_ < next->priority_) {
+            next = it;
+        }
+        if (it->deadline_ && wait < it->deadline_) {
+            next_valid_ = std::min(next_valid_, it->deadline_ - wait);
+        } else if (expired == tx_telegrams_.end() && it->deadline_) {
+            expired = it;
+        }
+    }
+    if (expired != tx_telegrams_.end() && expired->priority_ > next->priority_) {
+        if (overtaken_ >= MAX_OVERTAKEN) {
+            return expired;
+        }
+        next_starving_ = true;
+    }
+    return next;
+}
+
+// if the queue is full, make room by removing the last one of the lowest priority class
+void TxService::make_room() {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    if (tx_telegrams_.size() < MAX_TX_TELEGRAMS) {
+        return;
+    }
+    LOG_WARNING("Tx queue overflow, skip one message");
+    auto last = tx_telegrams_.end();
+    for (auto it = tx_telegrams_.begin(); it != tx_telegrams_.end(); ++it) {
+        if (last == tx_telegrams_.end() || it->priority_ >= last->priority_) {
+            last = it;
+        }
+    }
+    if (last->telegram_->operation == Telegram::Operation::TX_WRITE) {
+        telegram_write_fail_count_++;
+    } else {
+        telegram_read_fail_count_++;
+    }
+    tx_telegrams_.erase(last);
+    queue_changed();
+}
+
+// number of telegrams of a priority class in the queue
+uint8_t TxService::queued_count(const uint8_t priority) const {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    return std::count_if(tx_telegrams_.begin(), tx_telegrams_.end(), [priority](const QueuedTxTelegram & tx) { return tx.priority_ == priority; });
+}
+
+const char * TxService::priority_name(const uint8_t priority) {
+    static const char * const names[] = {"control", "interactive", "background"};
+    return priority < NUM_PRIORITIES ? names[priority] : "";
+}
+
+// queued, sent and the wait time histogram of a priority class, for show ems and the system info
+const char * TxService::show_priority_stats(const uint8_t priority, char * result, const size_t len) const {
+    const auto & wait = priority_wait_[priority];
+    snprintf(result,
+             len,
+             "queued %d, sent %lu, wait <0.1s:%lu <0.5s:%lu <2s:%lu <10s:%lu >10s:%lu",
+             queued_count(priority),
+             (unsigned long)priority_sent_[priority],
+             (unsigned long)wait[0],
+             (unsigned long)wait[1],
+             (unsigned long)wait[2],
+             (unsigned long)wait[3],
+             (unsigned long)wait[4]);
+    return result;
 }
 
 // process a Tx telegram
@@ -367,7 +570,7 @@ void TxService::send_telegram(const QueuedTxTelegram & tx_telegram) {
         }
     }
     // make a copy of the telegram with new dest (without read-flag)
-    telegram_last_ = std::make_shared<Telegram>(
+    telegram_last_ = make_telegram(
         telegram->operation, telegram->src, dest & 0x7F, telegram->type_id, telegram->offset, telegram->message_data, telegram->message_length);
 
     uint8_t length       = message_p;
@@ -426,31 +629,141 @@ void TxService::add(const uint8_t  operation,
                     const uint8_t  message_length,
                     const uint16_t validateid,
                     const bool     front) {
-    auto telegram = std::make_shared<Telegram>(operation, ems_bus_id(), dest, type_id, offset, message_data, message_length);
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
 
-    LOG_DEBUG("New Tx [#%d] telegram, length %d", tx_telegram_id_, message_length);
+    // a read of the same telegram is already queued, so extend that one instead of using another bus slot
+    if (operation == Telegram::Operation::TX_READ && validateid == 0 && message_length == 1 && merge_read(dest, type_id, offset, message_data[0], front)) {
+        return;
+    }
 
-    // if the queue is full, make room by removing the last one
-    if (tx_telegrams_.size() >= MAX_TX_TELEGRAMS) {
-        LOG_WARNING("Tx queue overflow, skip one message");
-        if (tx_telegrams_.front().telegram_->operation == Telegram::Operation::TX_WRITE) {
-            telegram_write_fail_count_++;
-        } else {
-            telegram_read_fail_count_++;
+    // the same for a write, with both writing the telegram and reading it back in one go
+    if (operation == Telegram::Operation::TX_WRITE && merge_write(dest, type_id, offset, message_data, message_length, validateid, front)) {
+        if (validateid != 0) {
+            EMSESP::wait_validate(validateid);
         }
-        tx_telegrams_.pop_front();
+        return;
     }
 
+    auto telegram = make_telegram(operation, ems_bus_id(), dest, type_id, offset, message_data, message_length);
+
+    LOG_DEBUG("New Tx [#%d] telegram, length %d", tx_telegram_id_, message_length);
+
+    make_room();
+
+    uint8_t priority = operation == Telegram::Operation::TX_WRITE ? CONTROL : front ? INTERACTIVE : BACKGROUND;
     if (front) {
-        tx_telegrams_.emplace_front(tx_telegram_id_++, std::move(telegram), false, validateid); // add to front of queue
+        tx_telegrams_.emplace_front(tx_telegram_id_++, std::move(telegram), false, validateid, priority); // add to front of queue
     } else {
-        tx_telegrams_.emplace_back(tx_telegram_id_++, std::move(telegram), false, validateid); // add to back of queue
+        tx_telegrams_.emplace_back(tx_telegram_id_++, std::move(telegram), false, validateid, priority); // add to back of queue
     }
+    queue_changed();
     if (validateid != 0) {
         EMSESP::wait_validate(validateid);
     }
 }
 
+// merge a read request with a queued read of the same telegram, if their offset ranges overlap or touch
+// the queued read is extended to cover both, or moved to the front of the queue if the new one asks for that
+// a read is never moved across a queued write to the same telegram, so it still reads back the written values
+// returns true if the request was merged and doesn't need to be queued
+bool TxService::merge_read(const uint8_t dest, const uint16_t type_id, const uint8_t offset, const uint8_t length, const bool front) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    auto                                  found = tx_telegrams_.end();
+    for (auto it = tx_telegrams_.begin(); it != tx_telegrams_.end(); ++it) {
+        const auto & telegram = it->telegram_;
+        if ((telegram->dest & 0x7F) != dest || telegram->type_id != type_id) {
+            continue;
+        }
+        if (telegram->operation != Telegram::Operation::TX_READ) {
+            if (front) {
+                break; // the new read goes before this write
+            }
+            found = tx_telegrams_.end(); // the new read goes after this write
+            continue;
+        }
+        if (found == tx_telegrams_.end() && !it->retry_ && it->validateid_ == 0 && telegram->src == ems_bus_id() && telegram->message_length == 1
+            && offset <= telegram->offset + telegram->message_data[0] && telegram->offset <= offset + length) {
+            found = it;
+        }
+    }
+    if (found == tx_telegrams_.end()) {
+        return false;
+    }
+
+    const auto & queued = found->telegram_;
+    uint8_t      start  = std::min(offset, queued->offset);
+    uint16_t     end    = std::max(offset + length, queued->offset + queued->message_data[0]);
+    uint8_t      merged = (end - start > 0xFF) ? 0xFF : end - start;
+
+    telegram_read_merged_count_++;
+    LOG_DEBUG("Tx read request to deviceID 0x%02X for typeID 0x%02X merged with queued Tx [#%d]", dest, type_id, found->id_);
+
+    if (!front && start == queued->offset && merged == queued->message_data[0]) {
+        return true; // already covered
+    }
+
+    // a merged read keeps its place and wait time, or becomes interactive when moved to the front
+    auto id       = found->id_;
+    auto priority = found->priority_;
+    auto since    = found->queued_;
+    auto telegram = make_telegram(Telegram::Operation::TX_READ, ems_bus_id(), dest, type_id, start, &merged, 1);
+    auto next     = tx_telegrams_.erase(found);
+    if (front) {
+        tx_telegrams_.emplace_front(id, std::move(telegram), false, 0, INTERACTIVE);
+    } else {
+        tx_telegrams_.emplace(next, id, std::move(telegram), false, 0, priority)->queued_ = since;
+    }
+    queue_changed();
+    return true;
+}
+
+// merge a write with the last queued telegram to the same dest and type ID, if that is a write
+// with an offset range that overlaps or touches and the result fits in one telegram
+// where they overlap the new values win. Only the last queued telegram of the type is checked, so the writes keep their order.
+// that is the one nearest to the front of the queue, if writes are added to the front
+// returns true if the write was merged and doesn't need to be queued
+bool TxService::merge_write(const uint8_t   dest,
+                            const uint16_t  type_id,
+                            const uint8_t   offset,
+                            const uint8_t * message_data,
+                            const uint8_t   message_length,
+                            const uint16_t  validateid,
+                            const bool      front) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    for (size_t i = 0; i < tx_telegrams_.size(); i++) {
+        auto &       it     = front ? tx_telegrams_[i] : tx_telegrams_[tx_telegrams_.size() - 1 - i];
+        const auto & queued = it.telegram_;
+        if ((queued->dest & 0x7F) != dest || queued->type_id != type_id) {
+            continue;
+        }
+        if (queued->operation != Telegram::Operation::TX_WRITE || it.retry_ || queued->src != ems_bus_id()
+            || (validateid != 0 && it.validateid_ != 0 && validateid != it.validateid_)) {
+            return false;
+        }
+
+        // EMS+ has 2 more header bytes for the type ID
+        uint8_t  max_length = type_id > 0xFF ? EMS_MAX_TELEGRAM_MESSAGE_LENGTH - 2 : EMS_MAX_TELEGRAM_MESSAGE_LENGTH;
+        uint8_t  start      = std::min(offset, queued->offset);
+        uint16_t end        = std::max(offset + message_length, queued->offset + queued->message_length);
+        if (offset > queued->offset + queued->message_length || queued->offset > offset + message_length || end - start > max_length) {
+            return false;
+        }
+
+        uint8_t data[EMS_MAX_TELEGRAM_MESSAGE_LENGTH];
+        memcpy(data + queued->offset - start, queued->message_data, queued->message_length);
+        memcpy(data + offset - start, message_data, message_length);
+
+        LOG_DEBUG("Tx write to deviceID 0x%02X for typeID 0x%02X merged with queued Tx [#%d]", dest, type_id, it.id_);
+        it.telegram_ = make_telegram(Telegram::Operation::TX_WRITE, ems_bus_id(), dest, type_id, start, data, (uint8_t)(end - start));
+        if (it.validateid_ == 0) {
+            it.validateid_ = validateid;
+        }
+        telegram_write_merged_count_++;
+        return true;
+    }
+    return false;
+}
+
 // builds a Tx telegram and adds to queue
 // this is used by the retry() function to put the last failed Tx back into the queue
 // format is EMS 1.0 (src, dest, type_id, offset, data)
@@ -507,26 +820,21 @@ void TxService::add(uint8_t operation, const uint8_t * data, const uint8_t lengt
         }
     }
 
-    auto telegram = std::make_shared<Telegram>(operation, src, dest, type_id, offset, message_data, message_length); // operation is TX_WRITE or TX_READ
+    auto telegram = make_telegram(operation, src, dest, type_id, offset, message_data, message_length); // operation is TX_WRITE or TX_READ
 
-    // if the queue is full, make room by removing the last one
-    if (tx_telegrams_.size() >= MAX_TX_TELEGRAMS) {
-        LOG_WARNING("Tx queue overflow, skip one message");
-        if (tx_telegrams_.front().telegram_->operation == Telegram::Operation::TX_WRITE) {
-            telegram_write_fail_count_++;
-        } else {
-            telegram_read_fail_count_++;
-        }
-        tx_telegrams_.pop_front();
-    }
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    make_room();
 
     LOG_DEBUG("New Tx [#%d] telegram, length %d", tx_telegram_id_, message_length);
 
+    // raw reads are interactive, a raw read waiting for an earlier response goes to the back, but in the same class
+    uint8_t priority = operation == Telegram::Operation::TX_WRITE ? CONTROL : front ? INTERACTIVE : BACKGROUND;
     if (front && (operation != Telegram::Operation::TX_RAW || EMSESP::response_id() == 0)) {
-        tx_telegrams_.emplace_front(tx_telegram_id_++, std::move(telegram), false, validate_id); // add to front of queue
+        tx_telegrams_.emplace_front(tx_telegram_id_++, std::move(telegram), false, validate_id, priority); // add to front of queue
     } else {
-        tx_telegrams_.emplace_back(tx_telegram_id_++, std::move(telegram), false, validate_id); // add to back of queue
+        tx_telegrams_.emplace_back(tx_telegram_id_++, std::move(telegram), false, validate_id, priority); // add to back of queue
     }
+    queue_changed();
     if (validate_id != 0) {
         EMSESP::wait_validate(validate_id);
     }
@@ -611,6 +919,7 @@ void TxService::retry_tx(const uint8_t operation, const uint8_t * data, const ui
               Helpers::data_to_hex(data, length - 1).c_str());
 
     // add to the top of the queue
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
     if (tx_telegrams_.size() >= MAX_TX_TELEGRAMS) {
         LOG_WARNING("Tx queue overflow, skip retry");
         reset_retry_count();      // give up
@@ -618,7 +927,8 @@ void TxService::retry_tx(const uint8_t operation, const uint8_t * data, const ui
         return;
     }
 
-    tx_telegrams_.emplace_front(tx_telegram_id_++, std::move(telegram_last_), true, get_post_send_query());
+    tx_telegrams_.emplace_front(tx_telegram_id_++, std::move(telegram_last_), true, get_post_send_query(), priority_last_);
+    queue_changed();
 }
 
 // send a request to read the next block of data from longer telegrams
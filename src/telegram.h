@@ -21,6 +21,9 @@
 
 #include <string>
 #include <deque>
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <uuid/log.h>
 
 // UART drivers
@@ -35,9 +38,11 @@
 #if defined(EMSESP_STANDALONE)
 #define MAX_RX_TELEGRAMS 100 // size of Rx queue
 #define MAX_TX_TELEGRAMS 200 // size of Tx queue
+#define MAX_RX_FRAMES 128    // size of the raw Rx frame buffer, must be a power of 2
 #else
 #define MAX_RX_TELEGRAMS 10  // size of Rx queue
 #define MAX_TX_TELEGRAMS 100 // size of Tx queue
+#define MAX_RX_FRAMES 16     // size of the raw Rx frame buffer, must be a power of 2
 #endif
 
 // default values for null values
@@ -159,6 +164,84 @@ class Telegram {
     int8_t _getDataPosition(const uint8_t index, const uint8_t size) const;
 };
 
+// fixed-size pool of Telegram slots, shared by the Rx and Tx queues
+// telegrams are created with std::allocate_shared, so the reference count and the Telegram live together in one slot
+// and creating or dropping a telegram doesn't touch the heap. Falls back to the heap when all slots are taken
+class TelegramPool {
+  public:
+    static constexpr size_t   SLOT_SIZE = (sizeof(Telegram) + 4 * sizeof(void *) + 7) & ~static_cast<size_t>(7); // Telegram + shared_ptr control block
+    static constexpr uint16_t NUM_SLOTS = MAX_RX_TELEGRAMS + MAX_TX_TELEGRAMS + 8; // both queues full, plus the last Tx and ones being processed
+
+    static void * allocate(const size_t size);
+    static void   deallocate(void * p);
+
+    static uint16_t in_use() {
+        return in_use_;
+    }
+
+    static uint16_t high_water() {
+        return high_water_;
+    }
+
+    static uint32_t pool_allocs() {
+        return pool_allocs_;
+    }
+
+    static uint32_t heap_allocs() {
+        return heap_allocs_;
+    }
+
+  private:
+    union Slot {
+        Slot *                         next; // when on the free list
+        alignas(std::max_align_t) char data[SLOT_SIZE];
+    };
+
+    static Slot       slots_[NUM_SLOTS];
+    static Slot *     free_;    // recycled slots
+    static uint16_t   unused_;  // slots never handed out yet, from the end of slots_
+    static uint16_t   in_use_;
+    static uint16_t   high_water_;
+    static uint32_t   pool_allocs_;
+    static uint32_t   heap_allocs_;
+    static std::mutex mutex_; // telegrams are also released on the UART task
+};
+
+// allocator for std::allocate_shared, taking the memory from the TelegramPool
+template <typename T>
+struct TelegramAllocator {
+    using value_type = T;
+
+    TelegramAllocator() = default;
+    template <typename U>
+    TelegramAllocator(const TelegramAllocator<U> &) {
+    }
+
+    T * allocate(const size_t n) {
+        return static_cast<T *>(TelegramPool::allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T * p, const size_t) {
+        TelegramPool::deallocate(p);
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const TelegramAllocator<T> &, const TelegramAllocator<U> &) {
+    return true;
+}
+
+template <typename T, typename U>
+bool operator!=(const TelegramAllocator<T> &, const TelegramAllocator<U> &) {
+    return false;
+}
+
+// use instead of std::make_shared<Telegram>
+template <typename... Args>
+std::shared_ptr<Telegram> make_telegram(Args &&... args) {
+    return std::allocate_shared<Telegram>(TelegramAllocator<Telegram>(), std::forward<Args>(args)...);
+}
+
 class EMSbus {
   public:
     static uuid::log::Logger logger_;
@@ -249,13 +332,68 @@ class EMSbus {
     static uint8_t  tx_state_;          // state of the Tx line (NONE or waiting on a TX_READ or TX_WRITE)
 };
 
+// lock-free single producer/single consumer ring of raw Rx frames
+// the UART task pushes the frames as they come off the bus, the main loop pops and parses them
+// all storage is allocated up front, so nothing is allocated on the UART task
+class RxFrameBuffer {
+  public:
+    struct Frame {
+        uint8_t length; // including the CRC
+        bool    empty;  // an empty reply made up by add_empty(), not read from the bus
+        uint8_t data[EMS_MAXBUFFERSIZE];
+    };
+
+    // producer side, returns false and counts a drop if the buffer is full
+    bool push(const uint8_t * data, const uint8_t length, const bool empty) {
+        uint32_t head = head_.load(std::memory_order_relaxed);
+        if ((head - tail_.load(std::memory_order_acquire)) >= MAX_RX_FRAMES || length > EMS_MAXBUFFERSIZE) {
+            dropped_.store(dropped_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return false;
+        }
+        Frame & frame = frames_[head & (MAX_RX_FRAMES - 1)];
+        frame.length  = length;
+        frame.empty   = empty;
+        memcpy(frame.data, data, length);
+        head_.store(head + 1, std::memory_order_release); // publish the frame
+        return true;
+    }
+
+    // consumer side, returns the oldest frame or nullptr if empty. The frame stays valid until pop()
+    Frame * front() {
+        uint32_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        return &frames_[tail & (MAX_RX_FRAMES - 1)];
+    }
+
+    void pop() {
+        tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release); // hand the slot back
+    }
+
+    uint32_t dropped() const {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+  private:
+    static_assert((MAX_RX_FRAMES & (MAX_RX_FRAMES - 1)) == 0, "MAX_RX_FRAMES must be a power of 2");
+
+    Frame                 frames_[MAX_RX_FRAMES];
+    std::atomic<uint32_t> head_{0};    // next slot to write, only changed by the producer
+    std::atomic<uint32_t> tail_{0};    // next slot to read, only changed by the consumer
+    std::atomic<uint32_t> dropped_{0}; // frames lost because the buffer was full
+};
+
 class RxService : public EMSbus {
   public:
     RxService()  = default;
     ~RxService() = default;
 
     void loop();
-    void add(uint8_t * data, uint8_t length);
+    void add(uint8_t * data, uint8_t length, const bool empty = false);
+    void push(const uint8_t * data, const uint8_t length) {
+        frames_.push(data, length, false); // called from the UART task, parsed later in loop()
+    }
     void add_empty(const uint8_t src, const uint8_t dst, const uint16_t type_id, uint8_t offset);
 
     uint32_t telegram_count() const {
@@ -270,6 +408,10 @@ class RxService : public EMSbus {
         return telegram_error_count_;
     }
 
+    uint32_t telegram_dropped_count() const {
+        return frames_.dropped();
+    }
+
     // returns a %
     uint8_t quality() const {
         if (telegram_error_count_ == 0) {
@@ -292,7 +434,7 @@ class RxService : public EMSbus {
         }
     };
 
-    std::deque<QueuedRxTelegram> queue() const {
+    const std::deque<QueuedRxTelegram> & queue() const {
         return rx_telegrams_;
     }
 
@@ -304,6 +446,8 @@ class RxService : public EMSbus {
     uint32_t                        telegram_error_count_ = 0; // # Rx CRC errors
     std::shared_ptr<const Telegram> rx_telegram;               // the incoming Rx telegram
     std::deque<QueuedRxTelegram>    rx_telegrams_;             // the Rx Queue
+    RxFrameBuffer                   frames_;                   // raw frames from the UART task, not yet parsed
+    uint32_t                        frames_dropped_reported_ = 0;
 };
 
 class TxService : public EMSbus {
@@ -377,6 +521,14 @@ class TxService : public EMSbus {
         return telegram_read_fail_count_;
     }
 
+    uint32_t telegram_read_merged_count() const {
+        return telegram_read_merged_count_;
+    }
+
+    uint32_t telegram_write_merged_count() const {
+        return telegram_write_merged_count_;
+    }
+
     uint32_t telegram_write_fail_count() const {
         return telegram_write_fail_count_;
     }
@@ -408,40 +560,79 @@ class TxService : public EMSbus {
         telegram_write_fail_count_++;
     }
 
+    // priority classes of the Tx queue, the lower the sooner it's sent
+    // writes are control, reads to the front of the queue (console, api, validation and follow-up reads) are interactive
+    // and all other reads, like the automatic fetch, are background
+    enum Priority : uint8_t { CONTROL, INTERACTIVE, BACKGROUND };
+    static constexpr uint8_t NUM_PRIORITIES   = 3;
+    static constexpr uint8_t NUM_WAIT_BUCKETS = 5; // wait time histogram: <100ms, <500ms, <2s, <10s and longer
+
+    // not const, so merge_read() can replace a queued read in the middle of the queue
     struct QueuedTxTelegram {
-        const uint16_t                        id_;
-        const std::shared_ptr<const Telegram> telegram_;
-        const bool                            retry_; // true if its a retry
-        const uint16_t                        validateid_;
+        uint16_t                        id_;
+        std::shared_ptr<const Telegram> telegram_;
+        bool                            retry_; // true if its a retry
+        uint16_t                        validateid_;
+        uint8_t                         priority_;
+        uint32_t                        queued_ = uuid::get_uptime(); // when it was added to the queue
+        uint32_t                        deadline_;                    // ms after queued_ it stops giving way to higher classes, 0 for none
 
         ~QueuedTxTelegram() = default;
         // replaced && im std::shared_ptr<Telegram> telegram in 3.7.0-dev.43
-        QueuedTxTelegram(uint16_t id, std::shared_ptr<Telegram> telegram, bool retry, uint16_t validateid)
+        QueuedTxTelegram(uint16_t id, std::shared_ptr<Telegram> telegram, bool retry, uint16_t validateid, uint8_t priority)
             : id_(id)
             , telegram_(std::move(telegram))
             , retry_(retry)
-            , validateid_(validateid) {
+            , validateid_(validateid)
+            , priority_(priority)
+            , deadline_(priority == BACKGROUND ? BACKGROUND_DEADLINE : 0) {
         }
     };
 
-    std::deque<QueuedTxTelegram> queue() const {
+    const std::deque<QueuedTxTelegram> & queue() const {
         return tx_telegrams_;
     }
 
     bool tx_queue_empty() const {
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
         return tx_telegrams_.empty();
     }
 
-    static constexpr uint8_t  MAXIMUM_TX_RETRIES = 3;
-    static constexpr uint32_t POST_SEND_DELAY    = 2000;
+    static constexpr uint8_t  MAXIMUM_TX_RETRIES  = 3;
+    static constexpr uint32_t POST_SEND_DELAY     = 2000;
+    static constexpr uint32_t WRITE_MERGE_TIME    = 100;   // ms a new write is held for more writes to the same telegram, other telegrams go first
+    static constexpr uint32_t BACKGROUND_DEADLINE = 10000; // ms, so a background read still goes out when the higher classes keep the bus busy
+    static constexpr uint8_t  MAX_OVERTAKEN       = 4;     // times in a row a telegram past its deadline lets a higher class go first
+
+    static const char * priority_name(const uint8_t priority);
+    uint8_t             queued_count(const uint8_t priority) const;
+    const char *        show_priority_stats(const uint8_t priority, char * result, const size_t len) const;
 
   private:
     std::deque<QueuedTxTelegram> tx_telegrams_; // the Tx queue
-
-    uint32_t telegram_read_count_       = 0; // # Tx successful reads
-    uint32_t telegram_write_count_      = 0; // # Tx successful writes
-    uint32_t telegram_read_fail_count_  = 0; // # Tx unsuccessful transmits
-    uint32_t telegram_write_fail_count_ = 0; // # Tx unsuccessful transmits
+    mutable std::recursive_mutex mutex_;        // the queue is also read and changed on the UART task, recursive as add() calls merge_read()
+
+    uint32_t telegram_read_count_         = 0; // # Tx successful reads
+    uint32_t telegram_write_count_        = 0; // # Tx successful writes
+    uint32_t telegram_read_fail_count_    = 0; // # Tx unsuccessful transmits
+    uint32_t telegram_write_fail_count_   = 0; // # Tx unsuccessful transmits
+    uint32_t telegram_read_merged_count_  = 0; // # Tx reads merged with a queued read, each one a bus slot saved
+    uint32_t telegram_write_merged_count_ = 0; // # Tx writes merged with a queued write, saving a bus slot and a validation read
+
+    // per priority class, # sent and how long they waited in the queue
+    uint32_t priority_sent_[NUM_PRIORITIES]                   = {};
+    uint32_t priority_wait_[NUM_PRIORITIES][NUM_WAIT_BUCKETS] = {};
+    uint8_t  priority_last_                                   = BACKGROUND; // class of the last Tx, for its retries
+    uint8_t  overtaken_                                       = 0;          // # sends in a row a telegram past its deadline was overtaken
+
+    // the selected next telegram, see next_telegram(). Only used with mutex_ held
+    uint16_t next_id_       = 0;     // id_ of the selected telegram
+    bool     next_found_    = false; // false if there was nothing to send
+    uint32_t queue_version_ = 0;     // changed with every change of tx_telegrams_
+    uint32_t next_version_  = 1;     // queue_version_ the selection was made for
+    uint32_t next_selected_ = 0;     // uptime the selection was made
+    uint32_t next_valid_    = 0;     // ms the selection holds
+    bool     next_starving_ = false; // the selection overtakes a telegram past its deadline
 
     std::shared_ptr<Telegram> telegram_last_;
     uint16_t                  telegram_last_post_send_query_; // which type ID to query after a successful send, to read back the values just written
@@ -450,7 +641,23 @@ class TxService : public EMSbus {
 
     uint8_t tx_telegram_id_ = 0; // queue counter
 
-    void send_telegram(const QueuedTxTelegram & tx_telegram);
+    void                                   send_telegram(const QueuedTxTelegram & tx_telegram);
+    std::deque<QueuedTxTelegram>::iterator next_telegram();
+    std::deque<QueuedTxTelegram>::iterator select_telegram(const uint32_t now);
+    void                                   make_room();
+
+    void queue_changed() {
+        queue_version_++;
+    }
+
+    bool merge_read(const uint8_t dest, const uint16_t type_id, const uint8_t offset, const uint8_t length, const bool front);
+    bool merge_write(const uint8_t   dest,
+                     const uint16_t  type_id,
+                     const uint8_t   offset,
+                     const uint8_t * message_data,
+                     const uint8_t   message_length,
+                     const uint16_t  validateid,
+                     const bool      front);
 };
 
 } // namespace emsesp
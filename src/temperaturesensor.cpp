@@ -379,6 +379,26 @@ bool TemperatureSensor::get_value_info(JsonObject output, const char * cmd, cons
     return false; // not found
 }
 
+// the value of a sensor, matched by name or ID, as get_value_info() returns <name>/value, without building the json
+// index is where it was found the last time and is updated, nullptr if it's not found or has no value
+const char * TemperatureSensor::get_value_string(const char * name, int16_t & index, char * result, const size_t len) const {
+    auto match = [name](const Sensor & sensor) { return !strcasecmp(sensor.name().c_str(), name) || !strcasecmp(sensor.id().c_str(), name); };
+    if (index < 0 || index >= (int16_t)sensors_.size() || !match(sensors_[index])) {
+        auto sensor = std::find_if(sensors_.begin(), sensors_.end(), match);
+        if (sensor == sensors_.end()) {
+            index = -1;
+            return nullptr;
+        }
+        index = sensor - sensors_.begin();
+    }
+
+    const auto & sensor = sensors_[index];
+    if (!Helpers::hasValue(sensor.temperature_c) || len < 10) {
+        return nullptr;
+    }
+    return Helpers::render_value(result, sensor.temperature_c, 10, EMSESP::system_.fahrenheit() ? 2 : 0);
+}
+
 void TemperatureSensor::get_value_json(JsonObject output, const Sensor & sensor) {
     output["id"]       = sensor.id();
     output["name"]     = sensor.name();
@@ -560,7 +580,7 @@ uint64_t TemperatureSensor::get_id(const uint8_t addr[]) {
 
 // find the name from the customization service
 // if empty, return the ID as a string
-std::string TemperatureSensor::Sensor::name() const {
+const std::string & TemperatureSensor::Sensor::name() const {
     if (name_.empty()) {
         return id_;
     }
@@ -44,7 +44,7 @@ class TemperatureSensor {
             return internal_id_;
         }
 
-        std::string id() const {
+        const std::string & id() const {
             return id_;
         }
 
@@ -55,8 +55,8 @@ class TemperatureSensor {
             offset_ = offset;
         }
 
-        std::string name() const;
-        void        set_name(const std::string & name) {
+        const std::string & name() const;
+        void                set_name(const std::string & name) {
             name_ = name;
         }
 
@@ -85,6 +85,8 @@ class TemperatureSensor {
     bool updated_values();
     bool get_value_info(JsonObject output, const char * cmd, const int8_t id = -1);
 
+    const char * get_value_string(const char * name, int16_t & index, char * result, const size_t len) const;
+
     // return back reference to the sensor list, used by other classes
     std::vector<Sensor> sensors() const {
         return sensors_;
@@ -20,8 +20,108 @@
 
 #include "test.h"
 
+#ifdef EMSESP_STANDALONE
+#include <thread>
+#include <chrono>
+
+#include "JWTCache.h"
+#endif
+
+// count heap allocations for the benchmarks, only in a build with EMSESP_BENCHMARK as it replaces the allocator of the whole program
+#ifdef EMSESP_BENCHMARK
+#include <new>
+
+static std::atomic<uint32_t> test_allocs_{0};
+
+void * operator new(size_t size) {
+    test_allocs_++;
+    if (void * p = malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void * p) noexcept {
+    free(p);
+}
+
+void operator delete(void * p, size_t) noexcept {
+    free(p);
+}
+#endif
+
 namespace emsesp {
 
+#ifdef EMSESP_STANDALONE
+// the heap allocations so far, always 0 without EMSESP_BENCHMARK
+static uint32_t test_allocs() {
+#ifdef EMSESP_BENCHMARK
+    return test_allocs_.load();
+#else
+    return 0;
+#endif
+}
+
+// times the runs of a benchmark and, in a build with EMSESP_BENCHMARK, counts their heap allocations
+class Benchmark {
+  public:
+    // call f() the given number of times, adding to the totals
+    template <typename F>
+    void run(const uint32_t times, F && f) {
+        uint32_t allocs = test_allocs();
+        auto     start  = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < times; i++) {
+            f();
+        }
+        ns_ += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        allocs_ += test_allocs() - allocs;
+        runs_ += times;
+    }
+
+    // per run
+    long ns() const {
+        return runs_ ? (long)(ns_ / runs_) : 0;
+    }
+    uint32_t allocs() const {
+        return runs_ ? allocs_ / runs_ : 0;
+    }
+
+    // "name: 1234 ns and 5 allocations per what"
+    void show(uuid::console::Shell & shell, const char * name, const char * what) const {
+#ifdef EMSESP_BENCHMARK
+        shell.printfln("%s: %ld ns and %d allocations per %s", name, ns(), allocs(), what);
+#else
+        shell.printfln("%s: %ld ns per %s", name, ns(), what);
+#endif
+    }
+
+    // the result of a check on the allocations, at most max per run on average
+    const char * allocs_check(const uint32_t max = 0) const {
+#ifdef EMSESP_BENCHMARK
+        return allocs_ <= (uint64_t)max * runs_ ? "[OK]" : "[FAIL]";
+#else
+        return "[not counted]";
+#endif
+    }
+
+  private:
+    int64_t  ns_     = 0;
+    uint32_t allocs_ = 0;
+    uint32_t runs_   = 0;
+};
+
+// the linear scan Command::find_command() did before the hash index, to compare with in test "command_find"
+static const Command::CmdFunction * linear_find_command(const uint8_t device_type, const uint8_t device_id, const char * cmd, const uint8_t flag) {
+    for (const auto & cf : Command::commands()) {
+        if (Helpers::toLower(cmd) == Helpers::toLower(cf.cmd_) && (cf.device_type_ == device_type) && (!device_id || cf.device_id_ == device_id)
+            && (flag == CommandFlag::CMD_FLAG_DEFAULT || (flag & 0x3F) == (cf.flags_ & 0x3F))) {
+            return &cf;
+        }
+    }
+    return nullptr;
+}
+#endif
+
 // no shell, called via the API or 'call system test' command
 // or http://ems-esp/api?device=system&cmd=test&data=boiler
 bool Test::test(const std::string & cmd, int8_t id1, int8_t id2) {
@@ -780,6 +880,681 @@ void Test::run_test(uuid::console::Shell & shell, const std::string & cmd, const
         ok = true;
     }
 
+    if (command == "dv_index") {
+        shell.printfln("Testing the lookup cost of publish_value() via the device value index");
+
+        test("memory"); // boiler and 2 thermostats with all entities active
+
+        // every lookup must find all entities sharing the value pointer, as the scan did
+        EMSdevice::dv_index_stats_ = {0, 0, 0, 0};
+        uint32_t expected          = 0;
+        for (const auto & emsdevice : EMSESP::emsdevices) {
+            for (const auto & dv : emsdevice->devicevalues_) {
+                emsdevice->publish_value(dv.value_p);
+                for (const auto & other : emsdevice->devicevalues_) {
+                    expected += (other.value_p == dv.value_p) ? 1 : 0;
+                }
+            }
+        }
+
+        auto & stats = EMSdevice::dv_index_stats_;
+        shell.printfln("lookups: %d, entities found: %d of %d %s", stats.lookups, stats.matches, expected, stats.matches == expected ? "[OK]" : "[FAIL]");
+        shell.printfln("compares per lookup with a linear scan: %d", stats.linear_compares / stats.lookups);
+        shell.printfln("probes per lookup with the index: %d.%02d %s",
+                       stats.probes / stats.lookups,
+                       (stats.probes * 100 / stats.lookups) % 100,
+                       stats.probes < stats.linear_compares ? "[OK]" : "[FAIL]");
+        ok = true;
+    }
+
+    if (command == "publish_values") {
+        shell.printfln("Benchmarking publish_device_values() for a fully populated boiler and thermostat");
+
+        test("memory"); // boiler and 2 thermostats with all entities active
+
+        // a tag filter only visits the entities of that tag, which must still give all of them in the order they were registered
+        uint16_t values     = 0;
+        uint16_t mismatches = 0;
+        for (const auto & emsdevice : EMSESP::emsdevices) {
+            for (int8_t tag = DeviceValueTAG::TAG_DEVICE_DATA; tag <= DeviceValueTAG::TAG_HS16; tag++) {
+                JsonDocument doc;
+                emsdevice->generate_values(doc.to<JsonObject>(), tag, false, EMSdevice::OUTPUT_TARGET::MQTT);
+                JsonDocument expected_doc;
+                JsonObject   expected = expected_doc.to<JsonObject>();
+                for (const auto & dv : emsdevice->devicevalues_) {
+                    if (dv.tag == tag && dv.has_state(DeviceValueState::DV_ACTIVE) && !dv.has_state(DeviceValueState::DV_API_MQTT_EXCLUDE) && dv.has_fullname()
+                        && !expected[dv.short_name].is<JsonVariantConst>()) {
+                        expected[dv.short_name] = true;
+                    }
+                }
+                auto it = doc.as<JsonObject>().begin();
+                for (auto e : expected) {
+                    mismatches += (it == doc.as<JsonObject>().end() || it->key() != e.key()) ? 1 : 0;
+                    ++it;
+                }
+                mismatches += (expected.size() != doc.size()) ? 1 : 0;
+                values += expected.size();
+            }
+        }
+        shell.printfln("%d values by tag in registration order: %s", values, values && !mismatches ? "yes [OK]" : "no [FAIL]");
+
+        const uint16_t num_publishes = 1000;
+        for (const uint8_t device_type : {EMSdevice::DeviceType::BOILER, EMSdevice::DeviceType::THERMOSTAT}) {
+            EMSESP::publish_device_values(device_type); // warm up, creates the HA configs
+
+            Benchmark bench;
+            bench.run(num_publishes, [&] { EMSESP::publish_device_values(device_type); });
+            bench.show(shell, EMSdevice::device_type_2_device_name(device_type), "publish");
+        }
+        ok = true;
+    }
+
+    if (command == "publish_changes") {
+        shell.printfln("Testing MQTT publish of changed values only");
+
+        test("memory"); // boiler and 2 thermostats with all entities active
+
+        Mqtt::ha_enabled(false);
+        Mqtt::publish_changes(true);
+
+        EMSdevice * boiler = nullptr;
+        for (const auto & emsdevice : EMSESP::emsdevices) {
+            if (emsdevice->device_type() == EMSdevice::DeviceType::BOILER) {
+                boiler = emsdevice.get();
+            }
+        }
+        JsonDocument doc_before;
+        boiler->generate_values(doc_before.to<JsonObject>(), DeviceValueTAG::TAG_NONE, false, EMSdevice::OUTPUT_TARGET::MQTT);
+        boiler->clear_changes(); // as after a full publish
+
+        // Boiler -> Me, UBAMonitorFast(0x18)
+        uart_telegram({0x08, 0x00, 0x18, 0x00, 0x00, 0x02, 0x5A, 0x73, 0x3D, 0x0A, 0x10, 0x65, 0x40, 0x02, 0x1A,
+                       0x80, 0x00, 0x01, 0xE1, 0x01, 0x76, 0x0E, 0x3D, 0x48, 0x00, 0xC9, 0x44, 0x02, 0x00});
+
+        JsonDocument doc_full;
+        JsonDocument doc_changed;
+        boiler->generate_values(doc_full.to<JsonObject>(), DeviceValueTAG::TAG_NONE, false, EMSdevice::OUTPUT_TARGET::MQTT);
+        boiler->generate_values(doc_changed.to<JsonObject>(), DeviceValueTAG::TAG_NONE, false, EMSdevice::OUTPUT_TARGET::MQTT, true);
+        shell.printfln("full: %d entities, %d bytes", doc_full.size(), measureJson(doc_full));
+        shell.printfln("changed: %d entities, %d bytes", doc_changed.size(), measureJson(doc_changed));
+        serializeJson(doc_changed, shell);
+        shell.println();
+
+        // exactly the values the telegram changed
+        uint16_t differ = 0;
+        bool     same   = true;
+        for (auto kv : doc_full.as<JsonObject>()) {
+            if (doc_before[kv.key()] != kv.value()) {
+                differ++;
+                same &= (doc_changed[kv.key()] == kv.value());
+            }
+        }
+        shell.printfln("changed values published: %s", same && differ && differ == doc_changed.size() ? "all and only those [OK]" : "no [FAIL]");
+
+        // the broker isn't connected here, so the changes are kept for the next publish
+        EMSESP::publish_device_values(EMSdevice::DeviceType::BOILER, true);
+        JsonDocument doc;
+        bool         kept = boiler->generate_values(doc.to<JsonObject>(), DeviceValueTAG::TAG_NONE, false, EMSdevice::OUTPUT_TARGET::MQTT, true);
+        boiler->clear_changes();
+        bool cleared = !boiler->generate_values(doc.to<JsonObject>(), DeviceValueTAG::TAG_NONE, false, EMSdevice::OUTPUT_TARGET::MQTT, true);
+        shell.printfln("changes kept when not published: %s, none after clearing: %s", kept ? "yes [OK]" : "no [FAIL]", cleared ? "yes [OK]" : "no [FAIL]");
+
+        Mqtt::publish_changes(false);
+        ok = true;
+    }
+
+    if (command == "command_find") {
+        shell.printfln("Benchmarking Command::find_command() with the linear scan and with the hashed command index");
+
+        test("memory"); // boiler and 2 thermostats with all entities active
+
+        // a dummy command registered last, the worst case for the linear scan
+        Command::add(EMSdevice::DeviceType::SYSTEM, "benchCmd", [](const char * value, const int8_t id) { return true; }, nullptr);
+
+        const uint32_t num_calls = 10000;
+        Benchmark      linear;
+        Benchmark      hashed;
+        linear.run(num_calls, [] { linear_find_command(EMSdevice::DeviceType::SYSTEM, 0, "BENCHcmd", CommandFlag::CMD_FLAG_DEFAULT); });
+        hashed.run(num_calls, [] { Command::find_command(EMSdevice::DeviceType::SYSTEM, 0, "BENCHcmd", CommandFlag::CMD_FLAG_DEFAULT); });
+        shell.printfln("%d commands", Command::commands().size());
+        linear.show(shell, "linear scan", "lookup");
+        hashed.show(shell, "hash index", "lookup");
+        shell.printfln("no allocations with the hash index: %s", hashed.allocs_check());
+
+        // both must find the same commands
+        uint16_t mismatches = 0;
+        for (const auto & cf : Command::commands()) {
+            for (const uint8_t device_id : {(uint8_t)0, cf.device_id_}) {
+                auto found = Command::find_command(cf.device_type_, device_id, Helpers::toUpper(cf.cmd_).c_str(), cf.flags_);
+                mismatches += (found != linear_find_command(cf.device_type_, device_id, cf.cmd_, cf.flags_));
+            }
+        }
+        shell.printfln("lookups with different results: %d %s", mismatches, mismatches ? "[FAIL]" : "[OK]");
+
+        Command::erase_command(EMSdevice::DeviceType::SYSTEM, "benchcmd");
+        shell.printfln("dummy command found after erase: %s", Command::find_command(EMSdevice::DeviceType::SYSTEM, 0, "benchcmd", 0) ? "yes [FAIL]" : "no [OK]");
+        ok = true;
+    }
+
+    if (command == "condition") {
+        shell.printfln("Benchmarking scheduler conditions, parsed on every evaluation and compiled");
+
+        test("memory"); // boiler and 2 thermostats with all entities active
+        EMSESP::webCustomEntityService.test();
+        EMSESP::webCustomizationService.test(); // the sensor names and the analog sensors
+        EMSESP::temperaturesensor_.test();
+
+        const std::vector<std::string> conditions = {"boiler/outdoortemp < 10",
+                                                     "boiler/curflowtemp > 40 && boiler/heatingactive == on",
+                                                     "boiler/selflowtemp >= 30",
+                                                     "(boiler/curflowtemp - boiler/rettemp) > 5",
+                                                     "thermostat/hc1/seltemp > 20",
+                                                     "thermostat/hc1/mode == \"auto\"",
+                                                     "thermostat/hc1/currtemp <= thermostat/hc1/seltemp",
+                                                     "!boiler/heatingactive",
+                                                     "boiler/syspress < 1.2 || boiler/syspress > 2.5",
+                                                     "boiler/dhw/seltemp != 60",
+                                                     "system/network/rssi < -70",
+                                                     "boiler/outdoortemp * 2 + 5 > 0",
+                                                     "boiler/heatingpump == off && boiler/outdoortemp < 5",
+                                                     "-boiler/outdoortemp > 3",
+                                                     "boiler/heatingpump == on",
+                                                     "boiler/curburnpow % 10 == 0",
+                                                     "boiler/nosuchentity > 1",
+                                                     "boiler/outdoortemp < 0 ? 1 : 0",
+                                                     "boiler/curflowtemp / 2 > boiler/rettemp / 3",
+                                                     "thermostat/hc1/currtemp < 19.5",
+                                                     "boiler/tapwateractive == off || boiler/heatingactive == off",
+                                                     "boiler/dhw/curtemp < boiler/dhw/seltemp - 5",
+                                                     "boiler/heatstarts > 1000",
+                                                     "boiler/outdoortemp ^ 2 > 100",
+                                                     "thermostat/hc1/seltemp == 21.5 && thermostat/hc1/mode != \"off\"",
+                                                     "thermostat/hc1/mode == \"auto\" || thermostat/hc1/mode == \"manual\"",
+                                                     "boiler/burnstarts > 0 && boiler/burnworkmin > 0",
+                                                     "boiler/curflowtemp + boiler/rettemp",
+                                                     "(boiler/selflowtemp > 20) == (boiler/curflowtemp > 20)",
+                                                     "boiler/outdoortemp > -10 && boiler/outdoortemp < 25",
+                                                     "custom/test_custom > 50",
+                                                     "custom/test_read_only < 50 && custom/test_ram == \"14\"",
+                                                     "custom/nosuchentity > 1",
+                                                     "temperaturesensor/test_tempsensor1 < 20",
+                                                     "temperaturesensor/0b_0c0d_0e0f_1011 > temperaturesensor/test_tempsensor1",
+                                                     "analogsensor/test_analogsensor1 == 0",
+                                                     "analogsensor/37 + 1 > 0",
+                                                     "boiler/outdoortemp < temperaturesensor/test_tempsensor2"};
+
+        std::vector<ScheduleCondition> compiled(conditions.size());
+        uint8_t                        num_compiled = 0;
+        uint8_t                        mismatches   = 0;
+        for (size_t i = 0; i < conditions.size(); i++) {
+            num_compiled += compiled[i].compile(conditions[i]) ? 1 : 0;
+            auto   result = EMSESP::webSchedulerService.test_compute(conditions[i]);
+            int8_t match  = (result == "1") ? 1 : (result == "0") ? 0 : -1;
+            if (compiled[i].compiled() && compiled[i].evaluate() != match) {
+                shell.printfln("mismatch: %s (%s)", conditions[i].c_str(), result.c_str());
+                mismatches++;
+            }
+            shell.printfln("%-70s %-8s %s", conditions[i].c_str(), compiled[i].compiled() ? "compiled" : "parsed", result.c_str());
+        }
+        shell.printfln("%d of %d conditions compiled, %d with a different result %s", num_compiled, static_cast<int>(conditions.size()), mismatches, mismatches ? "[FAIL]" : "[OK]");
+
+        const uint32_t rounds    = 100;
+        auto           log_level = shell.log_level();
+        shell.log_level(uuid::log::Level::WARNING); // don't log every api call
+        Benchmark parsed;
+        Benchmark evaluated;
+        parsed.run(rounds, [&] {
+            for (const auto & condition : conditions) {
+                EMSESP::webSchedulerService.test_compute(condition);
+            }
+        });
+        evaluated.run(rounds, [&] {
+            for (auto & condition : compiled) {
+                if (condition.compiled()) {
+                    condition.evaluate();
+                }
+            }
+        });
+        // EMS device values, custom entities and sensors are bound, only system values are still read through the api
+        auto      reads_system = [](const std::string & condition) { return condition.find("system/") != std::string::npos; };
+        auto      num_system   = std::count_if(conditions.begin(), conditions.end(), reads_system);
+        Benchmark bound;
+        bound.run(rounds, [&] {
+            for (size_t i = 0; i < conditions.size(); i++) {
+                if (compiled[i].compiled() && !reads_system(conditions[i])) {
+                    compiled[i].evaluate();
+                }
+            }
+        });
+        shell.log_level(log_level);
+        parsed.show(shell, "parsed", "check of all conditions");
+        evaluated.show(shell, "compiled", "check of the compiled conditions");
+        shell.printfln("no allocations evaluating the compiled conditions, except the %d reading system values: %s", static_cast<int>(num_system), bound.allocs_check());
+        ok = true;
+    }
+
+    if (command == "onchange") {
+        shell.printfln("Benchmarking scheduler onChange and condition dependencies");
+
+        test("memory"); // boiler and 2 thermostats with all entities active
+
+        // every entity change the devices report to the scheduler, see EMSdevice::publish_value()
+        std::vector<std::string> cmds;
+        for (const auto & emsdevice : EMSESP::emsdevices) {
+            for (const auto & dv : emsdevice->devicevalues_) {
+                char cmd[COMMAND_MAX_LENGTH];
+                if (dv.tag >= DeviceValue::DeviceValueTAG::TAG_HC1) {
+                    snprintf(cmd, sizeof(cmd), "%s/%s/%s", emsdevice->device_type_name(), EMSdevice::tag_to_mqtt(dv.tag), dv.short_name);
+                } else {
+                    snprintf(cmd, sizeof(cmd), "%s/%s", emsdevice->device_type_name(), dv.short_name);
+                }
+                cmds.push_back(cmd);
+            }
+        }
+
+        // an onChange schedule on every 8th entity and a few conditions
+        JsonDocument doc;
+        JsonArray    schedule = doc["schedule"].to<JsonArray>();
+        for (size_t i = 0; i < cmds.size(); i += 8) {
+            JsonObject si = schedule.add<JsonObject>();
+            si["active"]  = true;
+            si["flags"]   = SCHEDULEFLAG_SCHEDULE_ONCHANGE;
+            si["time"]    = i % 16 ? cmds[i] : Helpers::toUpper(cmds[i]); // case doesn't matter
+            si["cmd"]     = "system/message";
+            si["value"]   = "\"changed\"";
+        }
+        for (const char * condition : {"boiler/outdoortemp < 10",
+                                       "thermostat/hc1/currtemp <= thermostat/hc1/seltemp",
+                                       "thermostat/seltemp > 20",
+                                       "boiler/dhw/curtemp < boiler/dhw/seltemp - 5",
+                                       "system/network/rssi < -70"}) {
+            JsonObject si = schedule.add<JsonObject>();
+            si["active"]  = true;
+            si["flags"]   = SCHEDULEFLAG_SCHEDULE_CONDITION;
+            si["time"]    = condition;
+            si["cmd"]     = "system/message";
+            si["value"]   = "\"condition\"";
+        }
+        EMSESP::webSchedulerService.updateWithoutPropagation(doc.as<JsonObject>(), WebScheduler::update);
+        auto & scheduleItems = *EMSESP::webSchedulerService.scheduleItems_;
+
+        // every change queues the active onChange schedules on that entity and marks the conditions reading it
+        uint8_t reactive = 0;
+        for (auto & scheduleItem : scheduleItems) {
+            reactive += scheduleItem.reactive ? 1 : 0;
+            scheduleItem.pending = false;
+        }
+        uint16_t queued     = 0;
+        uint16_t mismatches = 0;
+        for (const auto & cmd : cmds) {
+            EMSESP::webSchedulerService.cmd_changed_.clear();
+            EMSESP::webSchedulerService.onChange(cmd.c_str());
+            std::vector<ScheduleItem *> expected;
+            for (auto & scheduleItem : scheduleItems) {
+                if (scheduleItem.active && scheduleItem.flags == SCHEDULEFLAG_SCHEDULE_ONCHANGE && !strcasecmp(scheduleItem.time.c_str(), cmd.c_str())) {
+                    expected.push_back(&scheduleItem);
+                }
+            }
+            auto & changed = EMSESP::webSchedulerService.cmd_changed_;
+            queued += changed.size();
+            if (changed.size() != expected.size() || !std::is_permutation(changed.begin(), changed.end(), expected.begin())) {
+                shell.printfln("wrong onChange schedules queued for %s", cmd.c_str());
+                mismatches++;
+            }
+        }
+        EMSESP::webSchedulerService.cmd_changed_.clear();
+        uint8_t pending = 0;
+        for (const auto & scheduleItem : scheduleItems) {
+            pending += scheduleItem.pending ? 1 : 0;
+        }
+        shell.printfln("%d schedules, %d of %d onChange schedules queued, %d entities with the wrong schedules %s",
+                       static_cast<int>(scheduleItems.size()),
+                       queued,
+                       static_cast<int>(schedule.size()) - 5,
+                       mismatches,
+                       mismatches || queued != schedule.size() - 5 ? "[FAIL]" : "[OK]");
+        shell.printfln("%d of %d reactive conditions to evaluate %s", pending, reactive, pending == reactive ? "[OK]" : "[FAIL]");
+
+        const uint32_t rounds = 100;
+        Benchmark      bench;
+        bench.run(rounds, [&] {
+            for (const auto & cmd : cmds) {
+                EMSESP::webSchedulerService.onChange(cmd.c_str());
+            }
+            EMSESP::webSchedulerService.cmd_changed_.clear();
+        });
+        char what[40];
+        snprintf(what, sizeof(what), "change of all %d entities", static_cast<int>(cmds.size()));
+        bench.show(shell, "onChange", what);
+        shell.printfln("no allocations: %s", bench.allocs_check());
+
+        // a reactive condition whose command failed is checked again on the 10 second tick, standalone delay() moves the timer in us
+        doc.clear();
+        JsonObject retry = doc["schedule"].to<JsonArray>().add<JsonObject>();
+        retry["active"]  = true;
+        retry["flags"]   = SCHEDULEFLAG_SCHEDULE_CONDITION;
+        retry["time"]    = "boiler/outdoortemp < 100";
+        retry["cmd"]     = "boiler/nosuchentity";
+        retry["value"]   = "\"retry\"";
+        EMSESP::webSchedulerService.updateWithoutPropagation(doc.as<JsonObject>(), WebScheduler::update);
+        auto & retry_item = scheduleItems.front();
+        delay(70 * 1000 * 1000);
+        uuid::set_uptime();
+        EMSESP::webSchedulerService.loop();
+        bool failed    = retry_item.failed;
+        retry_item.cmd = "system/message"; // works now
+        delay(10 * 1000 * 1000);
+        uuid::set_uptime();
+        EMSESP::webSchedulerService.loop();
+        shell.printfln("failed condition command: %s, retried after 10 seconds: %s", failed ? "yes [OK]" : "no [FAIL]", retry_item.retry_cnt == 1 ? "yes [OK]" : "no [FAIL]");
+
+        doc.clear();
+        doc["schedule"].to<JsonArray>();
+        EMSESP::webSchedulerService.updateWithoutPropagation(doc.as<JsonObject>(), WebScheduler::update);
+        ok = true;
+    }
+
+    if (command == "customize") {
+        shell.printfln("Benchmarking entity customizations");
+
+        test("memory");          // boiler and 2 thermostats with all entities active
+        Mqtt::ha_enabled(false); // no HA config to remove
+
+        auto & boiler = EMSESP::emsdevices.front();
+
+        // 500 customizations, a mask on every boiler entity and a custom name on every 3rd, filled up with entities it doesn't have
+        std::vector<std::string> entity_ids;
+        std::vector<uint8_t>     masks;
+        std::vector<std::string> custom_names;
+        for (const auto & dv : boiler->devicevalues_) {
+            char entity_id[100];
+            masks.push_back(1 << (entity_ids.size() % 4));
+            custom_names.push_back(entity_ids.size() % 3 == 2 ? "custom name" : "");
+            snprintf(entity_id,
+                     sizeof(entity_id),
+                     "%02X%s%s%s",
+                     masks.back(),
+                     dv.tag >= DeviceValue::DeviceValueTAG::TAG_HC1 ? EMSdevice::tag_to_mqtt(dv.tag) : "",
+                     dv.tag >= DeviceValue::DeviceValueTAG::TAG_HC1 ? "/" : "",
+                     dv.short_name);
+            entity_ids.push_back(entity_id);
+            if (!custom_names.back().empty()) {
+                entity_ids.back() += "|" + custom_names.back();
+            }
+        }
+        size_t entities = entity_ids.size();
+        while (entity_ids.size() < 500) {
+            entity_ids.push_back("01dhw/unknown" + std::to_string(entity_ids.size()));
+        }
+
+        // the entities without the mask and custom name their customization sets
+        auto wrong_entities = [&](const EMSdevice & device) {
+            uint16_t wrong = 0;
+            for (size_t i = 0; i < device.devicevalues_.size(); i++) {
+                const auto & dv = device.devicevalues_[i];
+                wrong += (i >= entities || (dv.state >> 4) != masks[i] || dv.custom_fullname != custom_names[i]) ? 1 : 0;
+            }
+            return wrong;
+        };
+
+        const uint32_t rounds = 20;
+        Benchmark      apply;
+        apply.run(rounds, [&] {
+            for (const auto & entity_id : entity_ids) {
+                boiler->setCustomizationEntity(entity_id);
+            }
+        });
+        char what[60];
+        snprintf(what, sizeof(what), "%d customizations of %d entities", static_cast<int>(entity_ids.size()), static_cast<int>(entities));
+        apply.show(shell, "apply", what);
+        uint16_t wrong = wrong_entities(*boiler);
+        shell.printfln("entities with the wrong customization: %d %s", wrong, wrong ? "[FAIL]" : "[OK]");
+
+        // detecting the boiler again, with the customizations saved
+        uint8_t      product_id = boiler->product_id();
+        JsonDocument doc;
+        JsonObject   device     = doc["masked_entities"].to<JsonArray>().add<JsonObject>();
+        device["product_id"]    = product_id;
+        device["device_id"]     = 0x08;
+        JsonArray device_ids    = device["entity_ids"].to<JsonArray>();
+        for (const auto & entity_id : entity_ids) {
+            device_ids.add(entity_id);
+        }
+        EMSESP::webCustomizationService.update(doc.as<JsonObject>(), WebCustomization::update);
+        Benchmark                  detect;
+        std::unique_ptr<EMSdevice> detected;
+        detect.run(rounds, [&] { detected = EMSFactory::add(boiler->device_type(), 0x08, product_id, "1.0", "boiler", boiler->flags(), EMSdevice::Brand::NO_BRAND); });
+        detect.show(shell, "detect", "boiler with customized entities");
+        wrong = wrong_entities(*detected);
+        shell.printfln("detected entities with the wrong customization: %d of %d %s",
+                       wrong,
+                       static_cast<int>(detected->devicevalues_.size()),
+                       wrong || detected->devicevalues_.size() != entities ? "[FAIL]" : "[OK]");
+
+        doc.clear();
+        EMSESP::webCustomizationService.update(doc.to<JsonObject>(), WebCustomization::update);
+        ok = true;
+    }
+
+    if (command == "topics") {
+        shell.printfln("Benchmarking the topics publish_value() builds for single topic publishing and the scheduler");
+
+        test("memory"); // boiler and 2 thermostats with all entities active
+        Mqtt::ha_enabled(false);
+        Mqtt::publish_single(true);
+
+        // the state topic and the scheduler's command of an entity, separated by a space
+        auto topics = [](const uint8_t device_type, const int8_t tag, const char * shortname) {
+            std::string topic, cmd;
+            for (const auto & emsdevice : EMSESP::emsdevices) {
+                if (emsdevice->device_type() == device_type) {
+                    emsdevice->publish_value_topics(tag, shortname, topic, cmd);
+                    break;
+                }
+            }
+            return topic + " " + cmd;
+        };
+
+        const uint32_t rounds = 20;
+        for (const uint8_t mode : {0, 1, 2}) {
+            Mqtt::nested_format(mode == 1 ? Mqtt::NestedFormat::NESTED : Mqtt::NestedFormat::SINGLE);
+            Mqtt::publish_single2cmd(mode == 2);
+            const char * name = mode == 0 ? "single" : mode == 1 ? "single nested" : "single2cmd";
+
+            uint16_t values      = 0;
+            auto     publish_all = [&] {
+                values = 0;
+                for (const auto & emsdevice : EMSESP::emsdevices) {
+                    for (const auto & dv : emsdevice->devicevalues_) {
+                        emsdevice->publish_value(dv.value_p);
+                        values++;
+                    }
+                }
+            };
+            publish_all(); // the prefixes are built on the first publish after a change of the format
+            Benchmark bench;
+            bench.run(rounds, publish_all);
+            char what[20];
+            snprintf(what, sizeof(what), "%d values", values);
+            bench.show(shell, name, what);
+            shell.printfln("no allocations: %s", bench.allocs_check());
+
+            // the topics of this format, the command doesn't change
+            const std::string base          = Mqtt::base() + "/";
+            const char *      expected[][2] = {{"boiler_data/curflowtemp", "boiler_data/curflowtemp"},
+                                               {"thermostat_data_hc1/seltemp", "thermostat_data/hc1/seltemp"},
+                                               {"boiler_data_dhw/seltemp", "boiler_data/dhw/seltemp"}};
+            const std::string actual[]      = {topics(EMSdevice::DeviceType::BOILER, DeviceValue::DeviceValueTAG::TAG_DEVICE_DATA, "curflowtemp"),
+                                               topics(EMSdevice::DeviceType::THERMOSTAT, DeviceValue::DeviceValueTAG::TAG_HC1, "seltemp"),
+                                               topics(EMSdevice::DeviceType::BOILER, DeviceValue::DeviceValueTAG::TAG_DHW1, "seltemp")};
+            const char *      cmds[]        = {"boiler/curflowtemp", "thermostat/hc1/seltemp", "boiler/dhw/seltemp"};
+            for (uint8_t i = 0; i < 3; i++) {
+                auto topic = base + (mode == 2 ? cmds[i] : expected[i][mode]) + " " + cmds[i];
+                shell.printfln("%s %s", actual[i].c_str(), actual[i] == topic ? "[OK]" : "[FAIL]");
+            }
+        }
+
+        Mqtt::publish_single2cmd(false);
+        Mqtt::publish_single(false);
+        ok = true;
+    }
+
+    if (command == "hadiscovery") {
+        shell.printfln("Benchmarking the HA discovery configs and their budget per loop");
+
+        test("memory"); // boiler and 2 thermostats with all entities active
+        Mqtt::ha_enabled(true);
+        Mqtt::nested_format(1);
+        const uint8_t budget = 10;
+        Mqtt::discovery_budget(budget);
+        EMSESP::reset_mqtt_ha();
+
+        // publish the values, which queues the first configs of each device within the budget
+        EMSESP::publish_device_values(EMSdevice::DeviceType::BOILER);
+        EMSESP::publish_device_values(EMSdevice::DeviceType::THERMOSTAT);
+        auto configs = Mqtt::ha_discovery_configs();
+        shell.printfln("%d configs with the publish of the values, within the budget of each publish: %s",
+                       configs,
+                       configs && configs <= 2 * budget ? "yes [OK]" : "no [FAIL]");
+
+        // as if the broker took the device config with the first entity, so it's not rendered again
+        for (const auto & emsdevice : EMSESP::emsdevices) {
+            emsdevice->ha_config_done(true);
+        }
+
+        // the loops without a scheduled publish continue with the pending devices
+        // the broker is not connected here, so every loop starts over with the first entities
+        const uint32_t rounds = 20;
+        uint16_t       most   = 0;
+        Benchmark      bench;
+        configs = 0;
+        bench.run(rounds, [&] {
+            auto before = Mqtt::ha_discovery_configs();
+            Mqtt::ha_budget_reset();
+            EMSESP::ha_discovery_loop();
+            auto queued = Mqtt::ha_discovery_configs() - before;
+            configs += queued;
+            most = std::max(most, (uint16_t)queued);
+        });
+        bench.show(shell, "discovery", "loop");
+        shell.printfln("%d configs per loop, at most %d: %s", configs / rounds, most, most && most <= budget ? "within the budget [OK]" : "[FAIL]");
+        shell.invoke_command("show mqtt");
+        ok = true;
+    }
+
+    if (command == "mqtt_dispatch") {
+        shell.printfln("Benchmarking the dispatch of incoming MQTT messages to the subscribed topics");
+
+        // subscriptions with a callback, the message goes to the last one registered
+        static uint32_t received   = 0;
+        const uint16_t  num_topics = 100;
+        char            topic[Mqtt::MQTT_TOPIC_MAX_SIZE];
+        for (uint16_t i = 0; i < num_topics; i++) {
+            snprintf(topic, sizeof(topic), "bench/topic%d", i);
+            Mqtt::subscribe(EMSdevice::DeviceType::SYSTEM, topic, [](const char * message) {
+                received++;
+                return true;
+            });
+        }
+        snprintf(topic, sizeof(topic), "%s/bench/topic%d", Mqtt::base().c_str(), num_topics - 1);
+
+        const uint32_t num_messages = 10000;
+        auto           log_level    = shell.log_level();
+        shell.log_level(uuid::log::Level::WARNING); // don't log every message
+        Benchmark bench;
+        bench.run(num_messages, [&] { EMSESP::mqtt_.incoming(topic, "{\"value\":1}"); });
+        shell.printfln("%d subscriptions", num_topics);
+        bench.show(shell, "dispatch", "message");
+        shell.printfln("%lu of %lu messages received %s", received, num_messages, received == num_messages ? "[OK]" : "[FAIL]");
+
+        // a large retained payload
+        std::string large(64 * 1024, 'x');
+        EMSESP::mqtt_.incoming(topic, large.c_str());
+        shell.log_level(log_level);
+        shell.printfln("payload of %d bytes received: %s", large.size(), received == num_messages + 1 ? "yes [OK]" : "no [FAIL]");
+        ok = true;
+    }
+
+    if (command == "mqtt_packet") {
+        shell.printfln("Benchmarking the MQTT publish of a json payload, via a string and straight into the packet");
+
+        test("memory"); // boiler and 2 thermostats with all entities active
+
+        JsonDocument doc;
+        JsonObject   json = doc.to<JsonObject>();
+        for (const auto & emsdevice : EMSESP::emsdevices) {
+            if (emsdevice->device_type() == EMSdevice::DeviceType::BOILER) {
+                emsdevice->generate_values(json, DeviceValueTAG::TAG_NONE, true, EMSdevice::OUTPUT_TARGET::MQTT);
+            }
+        }
+        JsonObjectConst payload = json;
+        const char *    topic   = "ems-esp/boiler_data";
+
+        // build the packet of a publish, the bytes on the heap meanwhile and optionally a copy of the packet
+        espMqttClientTypes::Error error(espMqttClientTypes::Error::SUCCESS);
+        size_t                    heap[2]{};
+        auto                      publish = [&](const bool via_string, std::string * copy) {
+            if (via_string) {
+                // as queue_publish_retain() did, the string is alive while the packet copies it
+                std::string payload_text;
+                payload_text.reserve(measureJson(payload) + 1);
+                serializeJson(payload, payload_text);
+                espMqttClientInternals::Packet packet(error, 1, topic, (const uint8_t *)payload_text.c_str(), payload_text.length(), 0, false);
+                heap[via_string] = payload_text.capacity() + packet.size();
+                if (copy) {
+                    copy->assign((const char *)packet.data(0), packet.size());
+                }
+            } else {
+                espMqttClientInternals::Packet packet(
+                    error, 1, topic, [payload](uint8_t * data, size_t length) { serializeJson(payload, data, length); }, measureJson(payload), 0, false);
+                heap[via_string] = packet.size();
+                if (copy) {
+                    copy->assign((const char *)packet.data(0), packet.size());
+                }
+            }
+        };
+
+        const uint32_t num_publishes = 1000;
+        std::string    packet_data[2];
+        for (const bool via_string : {true, false}) {
+            publish(via_string, &packet_data[via_string]);
+            Benchmark bench;
+            bench.run(num_publishes, [&] { publish(via_string, nullptr); });
+            bench.show(shell, via_string ? "via string" : "into packet", "publish");
+        }
+        shell.printfln("packet of %d bytes, the same either way: %s", packet_data[0].size(), packet_data[0] == packet_data[1] ? "yes [OK]" : "no [FAIL]");
+        shell.printfln("%d bytes on the heap via a string, %d straight into the packet: %s", heap[1], heap[0], heap[0] < heap[1] ? "less [OK]" : "not less [FAIL]");
+        ok = true;
+    }
+
+    if (command == "mqtt_queue") {
+        shell.printfln("Testing the byte limit of the MQTT queue");
+
+        // the client also queues when not connected, fill it with large and small payloads until it refuses
+        auto client = Mqtt::client();
+        client->clearQueue(true);
+        std::string large(1000, 'x');
+        std::string small(100, 'y');
+        uint16_t    queued = 0;
+        while (client->publish((queued % 2) ? "ems-esp/thermostat_data" : "ems-esp/boiler_data", 0, false, (queued % 2) ? small.c_str() : large.c_str())) {
+            queued++;
+        }
+        shell.printfln("%d messages queued, %d of %d bytes %s",
+                       queued,
+                       client->queueBytes(),
+                       client->queueLimit(),
+                       queued && client->queueBytes() <= client->queueLimit() ? "[OK]" : "[FAIL]");
+
+        shell.invoke_command("show mqtt");
+
+        client->clearQueue(true);
+        shell.printfln("after clearing: %d messages, %d bytes %s",
+                       client->queueSize(),
+                       client->queueBytes(),
+                       !client->queueSize() && !client->queueBytes() ? "[OK]" : "[FAIL]");
+        ok = true;
+    }
+
     if (command == "temperature") {
         shell.printfln("Testing adding Temperature sensor");
         shell.invoke_command("show commands");
@@ -1586,6 +2361,340 @@ void Test::run_test(uuid::console::Shell & shell, const std::string & cmd, const
         ok = true;
     }
 
+    if (command == "rx_buffer") {
+        shell.printfln("Stress testing the Rx frame buffer with a producer and a consumer thread...");
+
+        auto     buffer     = std::unique_ptr<RxFrameBuffer>(new RxFrameBuffer());
+        uint32_t num_frames = 1000000;
+        uint32_t received   = 0;
+        uint32_t errors     = 0;
+
+        // producer, like the UART task. Retry when the buffer is full
+        std::thread producer([&]() {
+            uint8_t data[EMS_MAXBUFFERSIZE];
+            for (uint32_t i = 0; i < num_frames; i++) {
+                uint8_t length = 2 + (i % (EMS_MAXBUFFERSIZE - 1));
+                for (uint8_t j = 0; j < length; j++) {
+                    data[j] = (uint8_t)(i + j);
+                }
+                while (!buffer->push(data, length, i & 1)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+
+        // consumer, like the main loop. Check every frame arrives complete and in order
+        while (received < num_frames) {
+            auto frame = buffer->front();
+            if (frame == nullptr) {
+                std::this_thread::yield();
+                continue;
+            }
+            bool valid = (frame->empty == (received & 1)) && (frame->length == 2 + (received % (EMS_MAXBUFFERSIZE - 1)));
+            for (uint8_t j = 0; valid && j < frame->length; j++) {
+                valid = (frame->data[j] == (uint8_t)(received + j));
+            }
+            errors += !valid;
+            buffer->pop();
+            received++;
+        }
+        producer.join();
+
+        shell.printfln("frames received: %d, corrupt or out of order: %d %s, producer retries on full buffer: %d",
+                       received,
+                       errors,
+                       errors ? "[FAIL]" : "[OK]",
+                       buffer->dropped());
+
+        // all storage is allocated up front
+        Benchmark bench;
+        uint8_t   data[EMS_MAXBUFFERSIZE] = {0};
+        bench.run(num_frames, [&] {
+            buffer->push(data, sizeof(data), false);
+            buffer->pop();
+        });
+        bench.show(shell, "push and pop", "frame");
+        shell.printfln("no allocations: %s", bench.allocs_check());
+        ok = true;
+    }
+
+    if (command == "telegram_pool") {
+        shell.printfln("Pushing synthetic frames through the Rx and Tx queues using the Telegram pool...");
+
+        std::deque<RxService::QueuedRxTelegram> rx_queue;
+        std::deque<TxService::QueuedTxTelegram> tx_queue;
+        uint32_t                                num_frames  = 1000000;
+        uint32_t                                pool_allocs = TelegramPool::pool_allocs();
+        uint32_t                                heap_allocs = TelegramPool::heap_allocs();
+        uint16_t                                in_use      = TelegramPool::in_use();
+        uint8_t                                 message_data[EMS_MAX_TELEGRAM_MESSAGE_LENGTH];
+
+        Benchmark bench;
+        uint32_t  i = 0;
+        bench.run(num_frames, [&] {
+            uint8_t length = 1 + (i % EMS_MAX_TELEGRAM_MESSAGE_LENGTH);
+            for (uint8_t j = 0; j < length; j++) {
+                message_data[j] = (uint8_t)(i + j);
+            }
+
+            // same as RxService::add(), with a burst that fills the Rx queue every now and then
+            if (rx_queue.size() >= MAX_RX_TELEGRAMS) {
+                rx_queue.pop_front();
+            }
+            rx_queue.emplace_back((uint16_t)i, make_telegram(Telegram::Operation::RX, 0x08, 0x0B, 0x18, 0, message_data, length));
+            if ((i % (MAX_RX_TELEGRAMS * 2)) == 0) {
+                rx_queue.clear(); // processed by the main loop
+            }
+
+            // and a Tx queue that is kept full
+            if (tx_queue.size() >= MAX_TX_TELEGRAMS) {
+                tx_queue.pop_front();
+            }
+            tx_queue.emplace_back((uint16_t)i, make_telegram(Telegram::Operation::TX_WRITE, 0x0B, 0x08, 0x33, 0, message_data, length), false, 0, TxService::CONTROL);
+            i++;
+        });
+        rx_queue.clear();
+        tx_queue.clear();
+
+        pool_allocs = TelegramPool::pool_allocs() - pool_allocs;
+        heap_allocs = TelegramPool::heap_allocs() - heap_allocs;
+        bench.show(shell, "Rx and Tx telegram", "frame");
+        shell.printfln("telegrams from pool: %d, from heap: %d %s", pool_allocs, heap_allocs, pool_allocs == 2 * num_frames && !heap_allocs ? "[OK]" : "[FAIL]");
+        shell.printfln("pool slots: %d of %d bytes, high water: %d, all returned: %s",
+                       TelegramPool::NUM_SLOTS,
+                       TelegramPool::SLOT_SIZE,
+                       TelegramPool::high_water(),
+                       TelegramPool::in_use() == in_use ? "yes [OK]" : "no [FAIL]");
+        ok = true;
+    }
+
+    if (command == "telegram_log") {
+        shell.printfln("Benchmarking the processing of recorded telegrams with logging at INFO");
+
+        test("general"); // boiler and thermostat
+
+        // recorded telegrams: UBAMonitorFast(0x18), UBAParameterWW(0x33) and RCPLUSStatusMessage_HC1(0x01A5)
+        const uint8_t uba_monitor_fast[] = {0x00, 0x02, 0x5A, 0x73, 0x3D, 0x0A, 0x10, 0x65, 0x40, 0x02, 0x1A, 0x80, 0x00,
+                                            0x01, 0xE1, 0x01, 0x76, 0x0E, 0x3D, 0x48, 0x00, 0xC9, 0x44, 0x02, 0x00};
+        const uint8_t uba_parameter_ww[] = {0x08, 0xFF, 0x34, 0xFB, 0x00, 0x28, 0x00, 0x00, 0x46, 0x00, 0xFF, 0xFF, 0x00};
+        const uint8_t rcplus_status[]    = {0x00, 0xCF, 0x21, 0x2E, 0x00, 0x00, 0x2E, 0x24, 0x03, 0x25, 0x03,
+                                            0x03, 0x01, 0x03, 0x25, 0x00, 0xC8, 0x00, 0x00, 0x11, 0x01, 0x03};
+        std::vector<std::shared_ptr<const Telegram>> telegrams;
+        telegrams.push_back(make_telegram(Telegram::Operation::RX, 0x08, 0x00, 0x18, 0, uba_monitor_fast, sizeof(uba_monitor_fast)));
+        telegrams.push_back(make_telegram(Telegram::Operation::RX, 0x08, 0x0B, 0x33, 0, uba_parameter_ww, sizeof(uba_parameter_ww)));
+        telegrams.push_back(make_telegram(Telegram::Operation::RX, 0x18, 0x00, 0x01A5, 0, rcplus_status, sizeof(rcplus_status)));
+
+        EMSESP::watch(EMSESP::Watch::WATCH_OFF); // not watching, as when running normally
+        auto log_level = shell.log_level();
+        shell.log_level(uuid::log::Level::INFO);
+        shell.printfln("log level of all handlers: %s", uuid::log::format_level_uppercase(uuid::log::Logger::global_level()));
+
+        // once before timing, as the first telegram changes the values
+        for (const auto & telegram : telegrams) {
+            EMSESP::process_telegram(telegram);
+        }
+        const uint32_t rounds = 10000;
+        Benchmark      bench;
+        for (const auto & telegram : telegrams) {
+            bench.run(rounds, [&] { EMSESP::process_telegram(telegram); });
+        }
+        bench.show(shell, "process", "telegram");
+        shell.printfln("no allocations: %s", bench.allocs_check());
+
+        // the arguments of a message are only evaluated when a handler takes its level
+        uuid::log::Logger logger_{"test", uuid::log::Facility::CONSOLE}; // used by LOG_TRACE
+        uint8_t           evaluated = 0;
+        LOG_TRACE("%d", ++evaluated);
+        bool skipped = !evaluated;
+        shell.log_level(uuid::log::Level::TRACE);
+        LOG_TRACE("%d", ++evaluated);
+        shell.log_level(log_level);
+        shell.printfln("trace arguments skipped at INFO: %s, evaluated at TRACE: %s", skipped ? "yes [OK]" : "no [FAIL]", evaluated == 1 ? "yes [OK]" : "no [FAIL]");
+        ok = true;
+    }
+
+    if (command == "log_ring") {
+        shell.printfln("Benchmarking logging messages and reading them back in a log handler");
+
+        // log handler that reads all messages, counting the lines instead of printing them
+        class NullPrint : public Print {
+          public:
+            size_t write(uint8_t c) override {
+                lines += (c == '\n');
+                return 1;
+            }
+            size_t write(const uint8_t * buffer, size_t size) override {
+                lines += std::count(buffer, buffer + size, '\n');
+                return size;
+            }
+            uint32_t lines = 0;
+        } null_print;
+        uuid::log::PrintHandler handler{null_print};
+        uuid::log::Logger::register_handler(&handler, uuid::log::Level::INFO);
+
+        uuid::log::Logger logger_{"test", uuid::log::Facility::CONSOLE}; // used by LOG_INFO
+
+        auto log_level = shell.log_level();
+        shell.log_level(uuid::log::Level::NOTICE); // keep the console quiet
+
+        // logging only, the handler reads nothing
+        const uint32_t rounds = 10000;
+        uint32_t       r      = 0;
+        Benchmark      logging;
+        logging.run(rounds, [&] {
+            LOG_INFO("Benchmark %d: Boiler(0x08) -> All(0x00), UBAMonitorFast(0x18), data: 00 02 5A 73 3D 0A 10 65 40 02 1A 80 00 01 E1 01 76 0E 3D", r++);
+        });
+        handler.loop();
+
+        // logging and printing every message in the handler
+        null_print.lines = 0;
+        Benchmark output;
+        output.run(rounds, [&] {
+            LOG_INFO("Benchmark %d: Boiler(0x08) -> All(0x00), UBAMonitorFast(0x18), data: 00 02 5A 73 3D 0A 10 65 40 02 1A 80 00 01 E1 01 76 0E 3D", r++);
+            handler.loop();
+        });
+        uuid::log::Logger::unregister_handler(&handler);
+        shell.log_level(log_level);
+
+        logging.show(shell, "logging", "message");
+        output.show(shell, "logging and output", "message");
+        shell.printfln("no allocations logging: %s", logging.allocs_check()); // the PrintHandler formats its own timestamp
+        shell.printfln("%d of %d messages read by the handler %s", null_print.lines, rounds, null_print.lines == rounds ? "[OK]" : "[FAIL]");
+        ok = true;
+    }
+
+    if (command == "weblog") {
+        shell.printfln("Benchmarking sending log messages to the web log clients");
+
+        uuid::log::Logger logger_{"test", uuid::log::Facility::CONSOLE}; // used by LOG_INFO
+
+        auto log_level = shell.log_level();
+        shell.log_level(uuid::log::Level::NOTICE); // keep the console quiet
+
+        // send what is already pending
+        for (uint8_t i = 0; i < 100; i++) {
+            EMSESP::webLogService.loop();
+        }
+
+        auto &   log_client = EMSESP::webLogService.log_clients_.front(); // the one client of the standalone AsyncEventSource
+        uint32_t sent       = log_client.sent;
+
+        // log a burst of messages, then run the web log loop once per message
+        const uint32_t rounds   = 500;
+        const uint32_t messages = 20;
+        Benchmark      bench;
+        for (uint32_t r = 0; r < rounds; r++) {
+            for (uint32_t m = 0; m < messages; m++) {
+                LOG_INFO("Benchmark %d: \"Boiler(0x08)\" -> All(0x00), UBAMonitorFast(0x18), data: 00 02 5A 73 3D 0A 10 65 40 02 1A 80 00 01 E1 01 76 0E 3D", m);
+            }
+            bench.run(messages, [] { EMSESP::webLogService.loop(); });
+        }
+        shell.log_level(log_level);
+
+        sent = log_client.sent - sent;
+        bench.show(shell, "web log", "message");
+        shell.printfln("%d of %d messages sent, %d dropped %s", sent, rounds * messages, log_client.dropped, sent == rounds * messages && !log_client.dropped ? "[OK]" : "[FAIL]");
+        EMSESP::webLogService.show(shell);
+
+        // control characters are escaped, so the frame is valid json, 0x7F is sent as it is
+        auto & weblog       = EMSESP::webLogService;
+        auto   frame_length = weblog.frame_length_;
+
+        weblog.frame_length_ = 0;
+        bool        escaped  = weblog.append_escaped("a\"\n\x01\x1b\x7f");
+        std::string result(weblog.frame_.data(), weblog.frame_length_);
+        weblog.frame_length_ = frame_length;
+        shell.printfln("escaped: %s %s", result.c_str(), escaped && result == "a\\\"\\n\\u0001\\u001b\x7f" ? "[OK]" : "[FAIL]");
+        ok = true;
+    }
+
+    if (command == "api_stream") {
+        shell.printfln("Testing the streamed API responses against the json documents");
+
+        test("general");
+        test("2thermostats");
+        EMSESP::temperaturesensor_.test();
+        EMSESP::webCustomizationService.test(); // load the analog sensors
+
+        auto check = [&](const char * name, const std::string & streamed, JsonDocument & doc) {
+            std::string expected;
+            serializeJson(doc, expected);
+            if (streamed == expected) {
+                shell.printfln("%s: %d bytes streamed, same as the json document [OK]", name, streamed.size());
+            } else {
+                shell.printfln("%s: streamed output differs [FAIL]", name);
+                shell.printfln("  json:     %s", expected.c_str());
+                shell.printfln("  streamed: %s", streamed.c_str());
+            }
+        };
+
+        AsyncWebServerRequest request;
+        request.method(HTTP_GET);
+        for (const char * url : {"/api/boiler", "/api/boiler/values", "/api/thermostat", "/api/Thermostat/Values"}) {
+            JsonDocument input_doc;
+            JsonDocument doc;
+            Command::process(url, true, input_doc.to<JsonObject>(), doc.to<JsonObject>());
+            request.url(url);
+            EMSESP::webAPIService.webAPIService(&request);
+            check(url, request.chunkedContent(), doc);
+        }
+
+        // allvalues as it was built before it was streamed
+        JsonDocument doc;
+        JsonObject   output = doc.to<JsonObject>();
+        auto         value  = F_(values);
+        for (const auto & emsdevice : EMSESP::emsdevices) {
+            std::string title = emsdevice->device_type_2_device_name_translated() + std::string(" ") + emsdevice->to_string();
+            emsdevice->get_value_info(output[title].to<JsonObject>(), value, DeviceValueTAG::TAG_NONE);
+        }
+        EMSESP::webCustomEntityService.get_value_info(output["Custom Entities"].to<JsonObject>(), value);
+        EMSESP::webSchedulerService.get_value_info(output["Scheduler"].to<JsonObject>(), value);
+        EMSESP::analogsensor_.get_value_info(output["Analog Sensors"].to<JsonObject>(), value);
+        EMSESP::temperaturesensor_.get_value_info(output["Temperature Sensors"].to<JsonObject>(), value);
+
+        JsonDocument action;
+        action["action"] = "export";
+        action["param"]  = "allvalues";
+        request.method(HTTP_POST);
+        request.url("/rest/action");
+        EMSESP::webStatusService.action(&request, action.as<JsonVariant>());
+        check("allvalues", request.chunkedContent(), doc);
+
+        ok = true;
+    }
+
+    if (command == "jwtcache") {
+        shell.printfln("Testing the verified-JWT cache");
+
+        std::vector<User> users{User("admin", "admin", true), User("guest", "guest", false)};
+        JWTCache          cache;
+        String            jwt  = "eyJhbGciOiJIUzI1NiJ9.eyJ1c2VybmFtZSI6Imd1ZXN0IiwiYWRtaW4iOmZhbHNlfQ.signature";
+        uint32_t          hash = Helpers::hash32(jwt.c_str(), jwt.length());
+        size_t            user;
+        uint32_t          generation;
+
+        bool miss = !cache.find(hash, jwt, users, user, generation);
+        cache.add(hash, jwt, 1, users[1].username, generation);
+        bool hit = cache.find(hash, jwt, users, user, generation) && user == 1;
+        shell.printfln("verified token: %s", miss && hit ? "cached [OK]" : "not cached [FAIL]");
+
+        // the secret or users change while a token is being verified, the stale result is not stored
+        String   jwt2  = "eyJhbGciOiJIUzI1NiJ9.eyJ1c2VybmFtZSI6ImFkbWluIiwiYWRtaW4iOnRydWV9.signature";
+        uint32_t hash2 = Helpers::hash32(jwt2.c_str(), jwt2.length());
+        cache.find(hash2, jwt2, users, user, generation);
+        cache.clear();
+        cache.add(hash2, jwt2, 0, users[0].username, generation);
+        shell.printfln("verified before a clear: %s", cache.find(hash2, jwt2, users, user, generation) ? "cached [FAIL]" : "not cached [OK]");
+
+        // the cached index now points to another user
+        cache.add(hash2, jwt2, 0, users[0].username, generation);
+        users.erase(users.begin());
+        shell.printfln("index of another user: %s", cache.find(hash2, jwt2, users, user, generation) ? "hit [FAIL]" : "miss [OK]");
+
+        shell.printfln("hits %d, misses %d", cache.hits(), cache.misses());
+        ok = true;
+    }
+
     if (command == "rx2") {
         shell.printfln("Testing Rx2...");
         for (uint8_t i = 0; i < 30; i++) {
@@ -1683,6 +2792,10 @@ void Test::run_test(uuid::console::Shell & shell, const std::string & cmd, const
 
         EMSESP::show_ems(shell);
 
+        // let the writes pass the merge window, standalone delay() moves the timer in us
+        delay(TxService::WRITE_MERGE_TIME * 1000);
+        uuid::set_uptime();
+
         // process whole Tx queue
         for (uint8_t i = 0; i < 10; i++) {
             EMSESP::txservice_.send(); // send it to UART
@@ -1691,6 +2804,163 @@ void Test::run_test(uuid::console::Shell & shell, const std::string & cmd, const
         ok = true;
     }
 
+    if (command == "txmerge") {
+        shell.printfln("Testing merging of Tx read requests...");
+
+        test("general"); // boiler and thermostat
+
+        // the scheduled fetch, plus an api and a mqtt fetch of all devices
+        size_t   queued  = EMSESP::txservice_.queue().size();
+        uint32_t merged  = EMSESP::txservice_.telegram_read_merged_count();
+        uint16_t fetches = 0;
+        for (uint8_t i = 0; i < 3; i++) {
+            for (const auto & emsdevice : EMSESP::emsdevices) {
+                for (uint16_t tf = 0; tf < emsdevice->num_telegram_functions(); tf++) {
+                    fetches += emsdevice->is_fetch(emsdevice->telegram_function_type_id(tf)) ? 1 : 0;
+                }
+                emsdevice->fetch_values();
+            }
+        }
+        queued = EMSESP::txservice_.queue().size() - queued;
+        merged = EMSESP::txservice_.telegram_read_merged_count() - merged;
+        shell.printfln("%d fetch requests, %d queued, %d merged %s", fetches, static_cast<int>(queued), merged, !queued && merged == fetches ? "[OK]" : "[FAIL]");
+
+        // the queued telegrams of this type to the boiler
+        auto queued_to_boiler = [](const uint8_t operation, const uint16_t type_id) {
+            std::vector<std::shared_ptr<const Telegram>> telegrams;
+            for (const auto & tx : EMSESP::txservice_.queue()) {
+                if (tx.telegram_->operation == operation && tx.telegram_->dest == 0x08 && tx.telegram_->type_id == type_id) {
+                    telegrams.push_back(tx.telegram_);
+                }
+            }
+            return telegrams;
+        };
+
+        // overlapping offsets are read in one go, 0x18 offset 0 length 18
+        EMSESP::txservice_.read_request(0x18, 0x08, 0, 10);
+        EMSESP::txservice_.read_request(0x18, 0x08, 8, 10);
+        EMSESP::txservice_.read_request(0x18, 0x08, 4, 2);
+
+        // a read after a write is kept, to read back the written value
+        uint8_t t1[] = {0x01};
+        EMSESP::send_write_request(0x1A, 0x08, 0x00, t1, sizeof(t1), 0x00);
+        EMSESP::txservice_.read_request(0x1A, 0x08);
+
+        // writes to adjacent offsets of UBAParameterWW(0x33) are sent as one, with one validation read
+        for (uint8_t offset : {2, 3, 1, 4, 5, 6}) {
+            EMSESP::send_write_request(0x33, 0x08, offset, offset * 0x10, 0x33);
+        }
+        // not adjacent, stays a separate write
+        EMSESP::send_write_request(0x33, 0x08, 0x0A, 0xAA, 0x33);
+
+        EMSESP::show_ems(shell);
+
+        auto reads = queued_to_boiler(Telegram::Operation::TX_READ, 0x18);
+        shell.printfln("overlapping reads merged: %s", reads.size() == 1 && reads[0]->offset == 0 && reads[0]->message_data[0] == 18 ? "yes [OK]" : "no [FAIL]");
+        reads = queued_to_boiler(Telegram::Operation::TX_READ, 0x1A);
+        shell.printfln("read after a write kept: %s", reads.size() == 1 && queued_to_boiler(Telegram::Operation::TX_WRITE, 0x1A).size() == 1 ? "yes [OK]" : "no [FAIL]");
+        auto writes = queued_to_boiler(Telegram::Operation::TX_WRITE, 0x33);
+        if (writes.size() == 2 && writes[0]->offset > writes[1]->offset) {
+            std::swap(writes[0], writes[1]);
+        }
+        shell.printfln("adjacent writes merged: %s",
+                       writes.size() == 2 && writes[0]->offset == 1 && writes[0]->message_length == 6 && writes[1]->offset == 0x0A ? "yes [OK]" : "no [FAIL]");
+        ok = true;
+    }
+
+    if (command == "txprio") {
+        shell.printfln("Testing Tx priority classes...");
+
+        test("general"); // boiler and thermostat
+
+        // empty the queue
+        while (!EMSESP::txservice_.tx_queue_empty()) {
+            EMSESP::txservice_.send();
+        }
+
+        // standalone, delay() moves the timer in us
+        auto wait = [](const uint32_t ms) {
+            delay(ms * 1000);
+            uuid::set_uptime();
+        };
+
+        // a new write is held for merging, a read queued behind it goes out meanwhile
+        EMSESP::send_write_request(0x33, 0x08, 0x01, 0x10, 0);
+        EMSESP::send_read_request(0x1C, 0x08, 0, 0, true);
+        EMSESP::txservice_.send();
+        bool held = EMSESP::txservice_.queue().size() == 1 && EMSESP::txservice_.queue().front().telegram_->operation == Telegram::Operation::TX_WRITE;
+        wait(TxService::WRITE_MERGE_TIME);
+        EMSESP::txservice_.send();
+        shell.printfln("read sent while a write is held: %s", held && EMSESP::txservice_.tx_queue_empty() ? "yes [OK]" : "no [FAIL]");
+
+        // a fetch cycle, past the deadline, followed by a burst of writes and a console read
+        for (uint16_t type_id : {0x10, 0x11, 0x14, 0x15, 0x16, 0x18}) {
+            EMSESP::send_read_request(type_id, 0x08);
+        }
+        wait(TxService::BACKGROUND_DEADLINE);
+        for (uint8_t offset = 0; offset < 12; offset += 2) {
+            EMSESP::send_write_request(0x33, 0x08, offset, offset, 0);
+        }
+        EMSESP::send_read_request(0x1C, 0x08, 0, 0, true);
+
+        // writes go first, the expired fetch gets every 5th slot
+        wait(TxService::WRITE_MERGE_TIME);
+        std::string sent; // the class of each telegram sent, in order
+        for (uint8_t i = 0; i < 20 && !EMSESP::txservice_.tx_queue_empty(); i++) {
+            std::vector<std::pair<uint16_t, uint8_t>> before;
+            for (const auto & tx : EMSESP::txservice_.queue()) {
+                before.emplace_back(tx.id_, tx.priority_);
+            }
+            EMSESP::txservice_.send();
+            for (const auto & tx : before) {
+                if (std::none_of(EMSESP::txservice_.queue().begin(), EMSESP::txservice_.queue().end(), [&](const auto & q) { return q.id_ == tx.first; })) {
+                    sent += tx.second == TxService::CONTROL ? 'C' : tx.second == TxService::INTERACTIVE ? 'I' : 'B';
+                }
+            }
+            wait(200);
+        }
+
+        EMSESP::show_ems(shell);
+        shell.printfln("sent in order: %s", sent.c_str()); // C control, I interactive, B background
+        // 6 writes, the console read and 6 fetches
+        shell.printfln("writes first: %s, fetch not starved: %s, all sent: %s",
+                       sent.rfind("CCCC", 0) == 0 ? "yes [OK]" : "no [FAIL]",
+                       sent.find('B') == 4 ? "yes [OK]" : "no [FAIL]",
+                       sent.length() == 13 && EMSESP::txservice_.tx_queue_empty() ? "yes [OK]" : "no [FAIL]");
+        ok = true;
+    }
+
+    if (command == "fetch") {
+        shell.printfln("Testing adaptive fetch intervals...");
+
+        test("general"); // boiler and thermostat
+
+        // simulate the automatic fetch over the next 15 minutes, without replies so the intervals back off
+        // from 60 seconds, doubling up to the maximum of 480, all telegrams are read again after 61, 181, 421 and 901 seconds
+        auto     now       = uuid::get_uptime_sec();
+        uint16_t first     = 0;
+        bool     backs_off = true;
+        for (const uint32_t elapsed : {30, 61, 62, 181, 182, 421, 901}) {
+            uint16_t count = 0;
+            for (const auto & emsdevice : EMSESP::emsdevices) {
+                count += emsdevice->fetch_due(now + elapsed, 255);
+            }
+            bool due = elapsed == 61 || elapsed == 181 || elapsed == 421 || elapsed == 901;
+            if (elapsed == 61) {
+                first = count;
+            }
+            backs_off &= due ? (count && count == first) : !count;
+            shell.printfln("after %d seconds: %d read requests", elapsed, count);
+        }
+        shell.printfln("intervals back off: %s", backs_off ? "yes [OK]" : "no [FAIL]");
+
+        char result[500];
+        for (const auto & emsdevice : EMSESP::emsdevices) {
+            shell.printfln("%s: %s", emsdevice->device_type_name(), emsdevice->show_fetch_intervals(result, sizeof(result)));
+        }
+        ok = true;
+    }
+
     if (command == "poll") {
         shell.printfln("Testing Poll...");
 
@@ -2072,6 +3342,57 @@ void Test::run_test(uuid::console::Shell & shell, const std::string & cmd, const
             }
         }
 
+        // handleRead for a register range, must match reading the registers one at a time
+        {
+            shell.println();
+            shell.printfln("Testing modbus->handleRead() for a register range:");
+
+            uint16_t reg       = Modbus::REGISTER_BLOCK_SIZE * DeviceValueTAG::TAG_DEVICE_DATA;
+            uint8_t  num_words = Modbus::MAX_READ_REGISTERS;
+
+            auto read = [&](uint16_t start, uint8_t count) {
+                ModbusMessage request({boiler_dev->device_type(),
+                                       0x03,
+                                       static_cast<unsigned char>(start >> 8),
+                                       static_cast<unsigned char>(start & 0xff),
+                                       0,
+                                       static_cast<unsigned char>(count)});
+                return EMSESP::modbus_->handleRead(request);
+            };
+
+            auto response = read(reg, num_words);
+            if (response.getError() != SUCCESS || response._data.size() != 3 + num_words * 2) {
+                shell.printf("range [MODBUS ERROR %d]\n", response.getError());
+            } else {
+                uint8_t filled     = 0;
+                uint8_t mismatches = 0;
+                for (uint8_t i = 0; i < num_words; i++) {
+                    uint16_t range_word = (response._data[3 + i * 2] << 8) | response._data[4 + i * 2];
+                    auto     single     = read(reg + i, 1);
+                    uint16_t word       = 0;
+                    if (single.getError() == SUCCESS) {
+                        word = (single._data[3] << 8) | single._data[4];
+                    } else {
+                        filled++;
+                    }
+                    if (word != range_word) {
+                        mismatches++;
+                    }
+                }
+                shell.printfln("range of %d registers: %d zero-filled, %d mismatches %s", num_words, filled, mismatches, mismatches ? "[ERROR]" : "[OK]");
+            }
+
+            Modbus::strict_ = true;
+            response        = read(reg, num_words);
+            shell.printfln("strict range: error %d %s", response.getError(), response.getError() != SUCCESS ? "[OK]" : "[ERROR]");
+            response = read(reg + 214, 1); // mintempsilent
+            shell.printfln("strict mintempsilent: error %d %s", response.getError(), response.getError() == SUCCESS ? "[OK]" : "[ERROR]");
+            Modbus::strict_ = false;
+
+            response = read(reg + 999, 2);
+            shell.printfln("range past register block: error %d %s", response.getError(), response.getError() == ILLEGAL_DATA_ADDRESS ? "[OK]" : "[ERROR]");
+        }
+
         // handleWrite boiler
         {
             shell.println();
@@ -44,6 +44,29 @@ namespace emsesp {
 // #define EMSESP_DEBUG_DEFAULT "api3"
 // #define EMSESP_DEBUG_DEFAULT "crash"
 // #define EMSESP_DEBUG_DEFAULT "dv"
+// the benchmarks below also count heap allocations when built with: make ARGS=-DEMSESP_BENCHMARK
+// #define EMSESP_DEBUG_DEFAULT "dv_index"
+// #define EMSESP_DEBUG_DEFAULT "publish_values"
+// #define EMSESP_DEBUG_DEFAULT "publish_changes"
+// #define EMSESP_DEBUG_DEFAULT "command_find"
+// #define EMSESP_DEBUG_DEFAULT "condition"
+// #define EMSESP_DEBUG_DEFAULT "onchange"
+// #define EMSESP_DEBUG_DEFAULT "txmerge"
+// #define EMSESP_DEBUG_DEFAULT "fetch"
+// #define EMSESP_DEBUG_DEFAULT "txprio"
+// #define EMSESP_DEBUG_DEFAULT "customize"
+// #define EMSESP_DEBUG_DEFAULT "topics"
+// #define EMSESP_DEBUG_DEFAULT "hadiscovery"
+// #define EMSESP_DEBUG_DEFAULT "mqtt_dispatch"
+// #define EMSESP_DEBUG_DEFAULT "mqtt_packet"
+// #define EMSESP_DEBUG_DEFAULT "mqtt_queue"
+// #define EMSESP_DEBUG_DEFAULT "telegram_log"
+// #define EMSESP_DEBUG_DEFAULT "log_ring"
+// #define EMSESP_DEBUG_DEFAULT "weblog"
+// #define EMSESP_DEBUG_DEFAULT "api_stream"
+// #define EMSESP_DEBUG_DEFAULT "jwtcache"
+// #define EMSESP_DEBUG_DEFAULT "rx_buffer"
+// #define EMSESP_DEBUG_DEFAULT "telegram_pool"
 // #define EMSESP_DEBUG_DEFAULT "lastcode"
 // #define EMSESP_DEBUG_DEFAULT "2thermostats"
 // #define EMSESP_DEBUG_DEFAULT "temperature"
@@ -93,6 +93,21 @@ void WebAPIService::parse(AsyncWebServerRequest * request, JsonObject input) {
     // capture current heap memory before allocating the large return buffer
     emsesp::EMSESP::system_.refreshHeapMem();
 
+    // the values of an EMS device are streamed, without a large return buffer
+    if (stream_values(request, input)) {
+#if defined(EMSESP_UNITY)
+        // store the result so we can test with Unity later
+        storeResponse(request->chunkedContent());
+#endif
+#if defined(EMSESP_STANDALONE) && !defined(EMSESP_UNITY)
+        Serial.printf("%sweb output: %s[%s] %s(200)%s ", COLOR_WHITE, COLOR_BRIGHT_CYAN, request->url().c_str(), COLOR_BRIGHT_GREEN, COLOR_YELLOW);
+        Serial.print(request->chunkedContent().c_str());
+        Serial.println(COLOR_RESET);
+#endif
+        api_count_++;
+        return;
+    }
+
     // output json buffer
     auto response = new AsyncJsonResponse(false);
 
@@ -155,16 +170,67 @@ void WebAPIService::parse(AsyncWebServerRequest * request, JsonObject input) {
 #endif
 }
 
+// GET /{device} and /{device}/values of an EMS device are sent as a chunked response, one tag at a time
+// the output is the same as from Command::process(), which handles everything else including the errors
+bool WebAPIService::stream_values(AsyncWebServerRequest * request, JsonObject input) {
+    if (input.size()) {
+        return false;
+    }
+
+    SUrlParser p;
+    p.parse(request->url().c_str());
+    auto & paths = p.paths();
+    if (paths.size() < 2 || paths.size() > 3 || paths[0] != "api" || (paths.size() == 3 && Helpers::toLower(paths[2]) != F_(values))) {
+        return false;
+    }
+
+    uint8_t device_type = EMSdevice::device_name_2_device_type(paths[1].c_str());
+    if (!Command::device_has_commands(device_type)) {
+        return false;
+    }
+
+    // without values Command::process() returns an error
+    bool has_values = false;
+    for (const auto & emsdevice : EMSESP::emsdevices) {
+        if (emsdevice->device_type() == device_type && emsdevice->has_export_values()) {
+            has_values = true;
+            break;
+        }
+    }
+    if (!has_values) {
+        return false;
+    }
+
+    WebStreamResponse::send(request, DeviceValueTAG::TAG_HS16 + 1, [device_type](size_t tag, JsonObject output) {
+        EMSdevice::export_values_tag(device_type, output, tag, EMSdevice::OUTPUT_TARGET::API_SHORTNAMES);
+        return std::string();
+    });
+    return true;
+}
+
 #if defined(EMSESP_UNITY)
 // store the result so we can test with Unity later
 static JsonDocument storeResponseDoc_;
+static std::string  storeResponseStream_;
 
 void WebAPIService::storeResponse(JsonObject response) {
     storeResponseDoc_.clear();       // clear it, so can only recall once
     storeResponseDoc_.add(response); // add the object to our doc
+    storeResponseStream_.clear();
+}
+
+// a streamed response is stored as sent, in an array like the json responses
+void WebAPIService::storeResponse(const std::string & response) {
+    storeResponseDoc_.clear();
+    storeResponseStream_ = "[" + response + "]";
 }
+
 const char * WebAPIService::getResponse() {
     static std::string buffer;
+    if (!storeResponseStream_.empty()) {
+        buffer = storeResponseStream_;
+        return buffer.c_str();
+    }
     serializeJson(storeResponseDoc_, buffer);
     return buffer.c_str();
 }
@@ -33,6 +33,7 @@ class WebAPIService {
     // for test.cpp and running unit tests
     void         webAPIService(AsyncWebServerRequest * request);
     void         storeResponse(JsonObject response);
+    void         storeResponse(const std::string & response);
     const char * getResponse();
 #endif
 
@@ -51,6 +52,7 @@ class WebAPIService {
     static uint16_t api_fails_;
 
     void parse(AsyncWebServerRequest * request, JsonObject input);
+    bool stream_values(AsyncWebServerRequest * request, JsonObject input);
 };
 
 } // namespace emsesp
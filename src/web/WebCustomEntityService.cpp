@@ -318,6 +318,56 @@ bool WebCustomEntityService::get_value_info(JsonObject output, const char * cmd)
     return false; // not found
 }
 
+// the value of an entity as get_value_info() returns <name>/value, without building the json
+// index is where it was found the last time and is updated, nullptr if it's not found or has no value
+const char * WebCustomEntityService::get_value_string(const char * name, int16_t & index, char * result, const size_t len) const {
+    auto match  = [name](const CustomEntityItem & entity) { return !strcasecmp(entity.name.c_str(), name); };
+    auto entity = customEntityItems_->begin();
+    if (index >= 0 && index < (int16_t)customEntityItems_->size()) {
+        std::advance(entity, index);
+    }
+    if (index < 0 || index >= (int16_t)customEntityItems_->size() || !match(*entity)) {
+        entity = std::find_if(customEntityItems_->begin(), customEntityItems_->end(), match);
+        if (entity == customEntityItems_->end()) {
+            index = -1;
+            return nullptr;
+        }
+        index = std::distance(customEntityItems_->begin(), entity);
+    }
+
+    if (len < 12) {
+        return nullptr;
+    }
+    switch (entity->value_type) {
+    case DeviceValueType::BOOL:
+        if ((uint8_t)entity->value == EMS_VALUE_BOOL_NOTSET) {
+            return nullptr;
+        }
+        if (EMSESP::system_.bool_format() == BOOL_FORMAT_TRUEFALSE) {
+            return (uint8_t)entity->value ? "true" : "false";
+        }
+        if (EMSESP::system_.bool_format() == BOOL_FORMAT_10) {
+            return (uint8_t)entity->value ? "1" : "0";
+        }
+        return Helpers::render_boolean(result, (uint8_t)entity->value);
+    case DeviceValueType::INT8:
+        return (int8_t)entity->value == EMS_VALUE_INT8_NOTSET ? nullptr : Helpers::render_value(result, entity->factor * (int8_t)entity->value, 2);
+    case DeviceValueType::UINT8:
+        return (uint8_t)entity->value == EMS_VALUE_UINT8_NOTSET ? nullptr : Helpers::render_value(result, entity->factor * (uint8_t)entity->value, 2);
+    case DeviceValueType::INT16:
+        return (int16_t)entity->value == EMS_VALUE_INT16_NOTSET ? nullptr : Helpers::render_value(result, entity->factor * (int16_t)entity->value, 2);
+    case DeviceValueType::UINT16:
+        return (uint16_t)entity->value == EMS_VALUE_UINT16_NOTSET ? nullptr : Helpers::render_value(result, entity->factor * (uint16_t)entity->value, 2);
+    case DeviceValueType::UINT24:
+    case DeviceValueType::TIME:
+    case DeviceValueType::UINT32:
+        return entity->value == EMS_VALUE_UINT24_NOTSET ? nullptr : Helpers::render_value(result, entity->factor * entity->value, 2);
+    // case DeviceValueType::STRING:
+    default:
+        return entity->data.empty() ? nullptr : entity->data.c_str();
+    }
+}
+
 // build the json for specific entity
 void WebCustomEntityService::get_value_json(JsonObject output, CustomEntityItem & entity) {
     output["name"]     = entity.name;
@@ -564,8 +614,10 @@ void WebCustomEntityService::generate_value_web(JsonObject output, const bool is
 }
 
 // fetch telegram, called from emsesp::fetch
-void WebCustomEntityService::fetch() {
+// returns the number of read requests sent
+uint8_t WebCustomEntityService::fetch() {
     const uint8_t len[] = {1, 1, 1, 2, 2, 3, 3, 4};
+    uint8_t       count = 0;
 
     for (auto const & entity : *customEntityItems_) {
         if (entity.device_id > 0 && entity.type_id > 0) { // this excludes also RAM type
@@ -586,9 +638,11 @@ void WebCustomEntityService::fetch() {
                                           entity.device_id,
                                           entity.offset,
                                           entity.value_type == DeviceValueType::STRING ? (uint8_t)entity.factor : len[entity.value_type]);
+                count++;
             }
         }
     }
+    return count;
 }
 
 // called on process telegram, read from telegram
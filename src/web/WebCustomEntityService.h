@@ -54,17 +54,18 @@ class WebCustomEntityService : public StatefulService<WebCustomEntity> {
   public:
     WebCustomEntityService(AsyncWebServer * server, FS * fs, SecurityManager * securityManager);
 
-    void begin();
-    void publish_single(CustomEntityItem & entity);
-    void publish(const bool force = false);
-    bool command_setvalue(const char * value, const int8_t id, const char * name);
-    bool get_value_info(JsonObject output, const char * cmd);
-    void get_value_json(JsonObject output, CustomEntityItem & entity);
-    bool get_value(std::shared_ptr<const Telegram> telegram);
-    void fetch();
-    void render_value(JsonObject output, CustomEntityItem & entity, const bool useVal = false, const bool web = false, const bool add_uom = false);
-    void show_values(JsonObject output);
-    void generate_value_web(JsonObject output, const bool is_dashboard = false);
+    void    begin();
+    void    publish_single(CustomEntityItem & entity);
+    void    publish(const bool force = false);
+    bool    command_setvalue(const char * value, const int8_t id, const char * name);
+    bool         get_value_info(JsonObject output, const char * cmd);
+    const char * get_value_string(const char * name, int16_t & index, char * result, const size_t len) const;
+    void         get_value_json(JsonObject output, CustomEntityItem & entity);
+    bool    get_value(std::shared_ptr<const Telegram> telegram);
+    uint8_t fetch();
+    void    render_value(JsonObject output, CustomEntityItem & entity, const bool useVal = false, const bool web = false, const bool add_uom = false);
+    void    show_values(JsonObject output);
+    void    generate_value_web(JsonObject output, const bool is_dashboard = false);
 
     uint8_t count_entities();
     void    ha_reset() {
@@ -22,6 +22,8 @@ namespace emsesp {
 
 bool WebCustomization::_start = true;
 
+uint32_t WebCustomizationService::version_ = 1;
+
 WebCustomizationService::WebCustomizationService(AsyncWebServer * server, FS * fs, SecurityManager * securityManager)
     : _fsPersistence(WebCustomization::read, WebCustomization::update, this, fs, EMSESP_CUSTOMIZATION_FILE) {
     // GET
@@ -39,6 +41,8 @@ WebCustomizationService::WebCustomizationService(AsyncWebServer * server, FS * f
     server->on(EMSESP_CUSTOMIZATION_ENTITIES_PATH,
                securityManager->wrapCallback([this](AsyncWebServerRequest * request, JsonVariant json) { customization_entities(request, json); },
                                              AuthenticationPredicates::IS_AUTHENTICATED));
+
+    addUpdateHandler([] { version_++; }, false);
 }
 
 // this creates the customization file, saving it to the FS
@@ -273,10 +277,14 @@ void WebCustomizationService::customization_entities(AsyncWebServerRequest * req
                     uint8_t device_id  = emsdevice->device_id();
 
                     // and set the mask and custom names immediately for any listed entities
+                    // each one is found by tag and shortname, and the names are kept sorted for the deleted entities below
                     JsonArray                entity_ids_json = json["entity_ids"];
                     std::vector<std::string> entity_ids;
+                    std::vector<std::string> names;
+                    names.reserve(entity_ids_json.size());
                     for (const JsonVariant id : entity_ids_json) {
                         std::string id_s = id.as<std::string>();
+                        names.push_back(DeviceValue::get_name(id_s));
                         if (id_s[0] == '8') {
                             entity_ids.push_back(id_s);
                             need_reboot = true;
@@ -284,25 +292,18 @@ void WebCustomizationService::customization_entities(AsyncWebServerRequest * req
                             emsdevice->setCustomizationEntity(id_s);
                         }
                     }
+                    std::sort(names.begin(), names.end());
 
                     // add deleted entities from file
                     read([&](WebCustomization & settings) {
-                        for (EntityCustomization entityCustomization : settings.entityCustomizations) {
+                        for (const EntityCustomization & entityCustomization : settings.entityCustomizations) {
                             if (entityCustomization.device_id == device_id) {
                                 for (const std::string & entity_id : entityCustomization.entity_ids) {
-                                    uint8_t     mask = Helpers::hextoint(entity_id.substr(0, 2).c_str());
-                                    std::string name = DeviceValue::get_name(entity_id);
+                                    uint8_t mask = Helpers::hextoint(entity_id.substr(0, 2).c_str());
                                     if (mask & 0x80) {
-                                        bool is_set = false;
-                                        for (const JsonVariant id : entity_ids_json) {
-                                            std::string id_s = id.as<std::string>();
-                                            if (name == DeviceValue::get_name(id_s)) {
-                                                is_set      = true;
-                                                need_reboot = true;
-                                                break;
-                                            }
-                                        }
-                                        if (!is_set) {
+                                        if (std::binary_search(names.begin(), names.end(), DeviceValue::get_name(entity_id))) {
+                                            need_reboot = true;
+                                        } else {
                                             entity_ids.push_back(entity_id);
                                         }
                                     }
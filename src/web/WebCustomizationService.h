@@ -84,6 +84,11 @@ class WebCustomizationService : public StatefulService<WebCustomization> {
 
     void begin();
 
+    // changes on every update, so devices know when to re-read their entity customizations
+    static uint32_t version() {
+        return version_;
+    }
+
 #if defined(EMSESP_TEST)
     void test();
 #endif
@@ -95,6 +100,8 @@ class WebCustomizationService : public StatefulService<WebCustomization> {
 
     FSPersistence<WebCustomization> _fsPersistence;
 
+    static uint32_t version_;
+
     // GET
     void device_entities(AsyncWebServerRequest * request);
 
@@ -40,12 +40,8 @@ void WebLogService::begin() {
 void WebLogService::start() {
     EMSESP::webSettingsService.read([&](WebSettings & settings) {
         maximum_log_messages_ = settings.weblog_buffer;
-        limit_log_messages_   = maximum_log_messages_;
         compact_              = settings.weblog_compact;
         uuid::log::Logger::register_handler(this, (uuid::log::Level)settings.weblog_level);
-        if ((uuid::log::Level)settings.weblog_level == uuid::log::Level::OFF) {
-            log_messages_.clear();
-        }
     });
 }
 
@@ -59,13 +55,11 @@ void WebLogService::log_level(uuid::log::Level level) {
         return StateUpdateResult::CHANGED;
     });
     uuid::log::Logger::register_handler(this, level);
-    if (level == uuid::log::Level::OFF) {
-        log_messages_.clear();
-    }
 }
 
+// number of recent messages that are still in the log ring
 size_t WebLogService::num_log_messages() const {
-    return log_messages_.size();
+    return backlog(maximum_log_messages_);
 }
 
 size_t WebLogService::maximum_log_messages() const {
@@ -75,14 +69,6 @@ size_t WebLogService::maximum_log_messages() const {
 void WebLogService::maximum_log_messages(size_t count) {
     maximum_log_messages_ = std::max((size_t)1, count);
 
-    if (limit_log_messages_ > maximum_log_messages_) {
-        limit_log_messages_ = maximum_log_messages_;
-    }
-
-    while (log_messages_.size() > maximum_log_messages_) {
-        log_messages_.pop_front();
-    }
-
     EMSESP::webSettingsService.update([&](WebSettings & settings) {
         settings.weblog_buffer = count;
         return StateUpdateResult::CHANGED;
@@ -101,26 +87,8 @@ void WebLogService::compact(bool compact) {
     });
 }
 
-WebLogService::QueuedLogMessage::QueuedLogMessage(unsigned long id, std::shared_ptr<uuid::log::Message> && content)
-    : id_(id)
-    , content_(std::move(content)) {
-}
-
-void WebLogService::operator<<(std::shared_ptr<uuid::log::Message> message) {
-#ifndef EMSESP_STANDALONE
-    size_t maxAlloc = ESP.getMaxAllocHeap();
-    if (limit_log_messages_ > 5 && maxAlloc < 46080) {
-        --limit_log_messages_;
-    } else if (limit_log_messages_ < maximum_log_messages_ && maxAlloc > 51200) {
-        ++limit_log_messages_;
-    }
-#endif
-    while (log_messages_.size() >= limit_log_messages_) {
-        log_messages_.pop_front();
-    }
-
-    log_messages_.emplace_back(++log_message_id_, std::move(message));
-
+// align the uptime of log messages with the NTP time
+void WebLogService::update_time_offset() {
     EMSESP::esp8266React.getNTPSettingsService()->read([&](NTPSettings & settings) {
         if (!settings.enabled || (time(nullptr) < 1500000000L)) {
             time_offset_ = 0;
@@ -134,9 +102,9 @@ void WebLogService::operator<<(std::shared_ptr<uuid::log::Message> message) {
     });
 }
 
-// dumps out the contents of log buffer to shell console
+// dumps out the recent messages in the log ring to shell console
 void WebLogService::show(Shell & shell) {
-    if (log_messages_.empty()) {
+    if (backlog(maximum_log_messages_) == 0) {
         return;
     }
 
@@ -144,39 +112,55 @@ void WebLogService::show(Shell & shell) {
     shell.printfln("Recent Log (level %s, max %d messages):", format_level_uppercase(log_level()), maximum_log_messages());
     shell.println();
 
-    for (const auto & message : log_messages_) {
-        log_message_id_tail_ = message.id_;
-
-        shell.print(uuid::log::format_timestamp_ms(message.content_->uptime_ms, 3));
-        shell.printf(" %c %lu: [%s] ", uuid::log::format_level_char(message.content_->level), message.id_, message.content_->name);
+    rewind(maximum_log_messages_);
+    while (fetch(log_message_)) {
+        shell.print(uuid::log::format_timestamp_ms(log_message_.uptime_ms, 3));
+        shell.printf(" %c %lu: [%s] ", uuid::log::format_level_char(log_message_.level), log_message_.id, log_message_.name);
 
-        if ((message.content_->level == uuid::log::Level::ERR) || (message.content_->level == uuid::log::Level::WARNING)) {
+        if ((log_message_.level == uuid::log::Level::ERR) || (log_message_.level == uuid::log::Level::WARNING)) {
             shell.print(COLOR_RED);
-            shell.println(message.content_->text);
+            shell.println(log_message_.text);
             shell.print(COLOR_RESET);
-        } else if (message.content_->level == uuid::log::Level::INFO) {
+        } else if (log_message_.level == uuid::log::Level::INFO) {
             shell.print(COLOR_YELLOW);
-            shell.println(message.content_->text);
+            shell.println(log_message_.text);
             shell.print(COLOR_RESET);
-        } else if (message.content_->level == uuid::log::Level::DEBUG) {
+        } else if (log_message_.level == uuid::log::Level::DEBUG) {
             shell.print(COLOR_CYAN);
-            shell.println(message.content_->text);
+            shell.println(log_message_.text);
             shell.print(COLOR_RESET);
         } else {
-            shell.println(message.content_->text);
+            shell.println(log_message_.text);
         }
     }
 
     shell.println();
+
+    size_t n = 0;
+    for (const auto & log_client : log_clients_) {
+        shell.printfln("Web log client %u: %lu messages sent, %lu dropped, lag %u frames (max %u)",
+                       (unsigned int)++n,
+                       (unsigned long)log_client.sent,
+                       (unsigned long)log_client.dropped,
+                       (unsigned int)log_client.lag,
+                       (unsigned int)log_client.max_lag);
+    }
+    if (n) {
+        shell.println();
+    }
 }
 
+// sends all pending log messages to the web clients, batched in frames of up to MAX_FRAME_SIZE
 void WebLogService::loop() {
-    if (!events_.count() || log_messages_.empty()) {
+    if (!events_.count()) {
+        if (!frame_.empty()) {
+            std::vector<char>().swap(frame_); // release the frame buffer
+            log_clients_.clear();
+        }
         return;
     }
 
-    // see if we've advanced
-    if (log_messages_.back().id_ <= log_message_id_tail_) {
+    if (!log_message_pending_ && !unread()) {
         return;
     }
 
@@ -188,14 +172,23 @@ void WebLogService::loop() {
     last_transmit_ = uuid::get_uptime_ms();
     */
 
-    // flush
-    for (const auto & message : log_messages_) {
-        if (message.id_ > log_message_id_tail_) {
-            log_message_id_tail_ = message.id_;
-            transmit(message);
-            return;
+    if (frame_.empty()) {
+        frame_.resize(MAX_FRAME_SIZE);
+    }
+    frame_length_ = 0;
+    update_time_offset();
+
+    // a message that doesn't fit stays pending for the next frame
+    size_t messages = 0;
+    while (log_message_pending_ || fetch(log_message_)) {
+        log_message_pending_ = !append_message(log_message_);
+        if (log_message_pending_) {
+            break;
         }
+        messages++;
     }
+
+    transmit(messages);
 }
 
 // convert time to real offset
@@ -211,26 +204,134 @@ char * WebLogService::messagetime(char * out, const uint64_t t, const size_t buf
     return out;
 }
 
-// send to web eventsource
-void WebLogService::transmit(const QueuedLogMessage & message) {
-    JsonDocument jsonDocument;
+// adds a log message as SSE event to the frame, in the same format as events_.send() with serializeJson()
+// returns false if it doesn't fit
+static_assert(WebLogService::MAX_FRAME_SIZE > 2 * uuid::log::Message::MAX_TEXT_LENGTH + 128, "a log message must fit in an empty frame");
+
+bool WebLogService::append_message(const uuid::log::Message & message) {
+    size_t start = frame_length_;
+    char   time_string[25];
+
+    int len = snprintf(&frame_[frame_length_],
+                       MAX_FRAME_SIZE - frame_length_,
+                       "id: %lu\r\nevent: message\r\ndata: {\"t\":\"%s\",\"l\":%d,\"i\":%lu,\"n\":\"",
+                       message.id,
+                       messagetime(time_string, message.uptime_ms, sizeof(time_string)),
+                       (int)message.level,
+                       message.id);
+    if (len > 0 && (size_t)len < MAX_FRAME_SIZE - frame_length_) {
+        frame_length_ += len;
+        if (append_escaped(message.name) && append_text("\",\"m\":\"") && append_escaped(message.text) && append_text("\"}\r\n\r\n")) {
+            return true;
+        }
+    }
+
+    frame_length_ = start;
+    return false;
+}
+
+bool WebLogService::append_text(const char * text) {
+    size_t len = strlen(text);
+    if (len > MAX_FRAME_SIZE - frame_length_) {
+        return false;
+    }
+    memcpy(&frame_[frame_length_], text, len);
+    frame_length_ += len;
+    return true;
+}
 
-    JsonObject logEvent = jsonDocument.to<JsonObject>();
-    char       time_string[25];
+// adds a json string, escaped like ArduinoJson does, and the control characters without a short escape as \u00XX
+bool WebLogService::append_escaped(const char * text) {
+    for (const char * c = text; *c; c++) {
+        char escaped = 0;
+        switch (*c) {
+        case '"':
+        case '\\':
+            escaped = *c;
+            break;
+        case '\b':
+            escaped = 'b';
+            break;
+        case '\f':
+            escaped = 'f';
+            break;
+        case '\n':
+            escaped = 'n';
+            break;
+        case '\r':
+            escaped = 'r';
+            break;
+        case '\t':
+            escaped = 't';
+            break;
+        default:
+            if ((uint8_t)*c < 0x20) {
+                escaped = 'u';
+            }
+            break;
+        }
+        if (frame_length_ + (escaped == 'u' ? 6 : escaped ? 2 : 1) > MAX_FRAME_SIZE) {
+            return false;
+        }
+        if (escaped == 'u') {
+            static constexpr char hex[] = "0123456789abcdef";
+            memcpy(&frame_[frame_length_], "\\u00", 4);
+            frame_[frame_length_ + 4] = hex[*c >> 4];
+            frame_[frame_length_ + 5] = hex[*c & 0x0F];
+            frame_length_ += 6;
+        } else if (escaped) {
+            frame_[frame_length_++] = '\\';
+            frame_[frame_length_++] = escaped;
+        } else {
+            frame_[frame_length_++] = *c;
+        }
+    }
+    return true;
+}
 
-    logEvent["t"] = messagetime(time_string, message.content_->uptime_ms, sizeof(time_string));
-    logEvent["l"] = message.content_->level;
-    logEvent["i"] = message.id_;
-    logEvent["n"] = message.content_->name;
-    logEvent["m"] = message.content_->text;
+// send the frame to all web eventsource clients
+// a client that still has MAX_CLIENT_FRAMES queued is skipped, so a slow client can't hold up the others
+void WebLogService::transmit(size_t messages) {
+    update_clients();
+    if (!frame_length_) {
+        return;
+    }
+
+    for (auto & log_client : log_clients_) {
+        auto * client = log_client.client;
+        if (!client->connected()) {
+            continue;
+        }
+        log_client.lag     = client->packetsWaiting();
+        log_client.max_lag = std::max(log_client.max_lag, log_client.lag);
+        if (log_client.lag >= MAX_CLIENT_FRAMES) {
+            log_client.dropped += messages;
+        } else {
+            client->write(frame_.data(), frame_length_);
+            log_client.sent += messages;
+        }
+    }
+}
 
-    size_t len    = measureJson(jsonDocument);
-    char * buffer = new char[len + 1];
-    if (buffer) {
-        serializeJson(jsonDocument, buffer, len + 1);
-        events_.send(buffer, "message", message.id_);
+// match the statistics with the connected clients
+void WebLogService::update_clients() {
+    log_clients_.erase(std::remove_if(log_clients_.begin(),
+                                      log_clients_.end(),
+                                      [&](const LogClient & log_client) {
+                                          for (auto * client : events_.clients()) {
+                                              if (client == log_client.client) {
+                                                  return false;
+                                              }
+                                          }
+                                          return true;
+                                      }),
+                       log_clients_.end());
+
+    for (auto * client : events_.clients()) {
+        if (std::none_of(log_clients_.begin(), log_clients_.end(), [&](const LogClient & log_client) { return log_client.client == client; })) {
+            log_clients_.push_back({client, 0, 0, 0, 0});
+        }
     }
-    delete[] buffer;
 }
 
 // sets the values after a POST
@@ -247,8 +348,9 @@ void WebLogService::getSetValues(AsyncWebServerRequest * request, JsonVariant js
         response->setLength();
         request->send(response);
 
-        // reset the tail pointer so complete log is sent
-        log_message_id_tail_ = 0;
+        // go back so the recent log is sent again
+        rewind(maximum_log_messages_);
+        log_message_pending_ = false;
 
         return;
     }
@@ -28,7 +28,9 @@ namespace emsesp {
 
 class WebLogService : public uuid::log::Handler {
   public:
-    static constexpr size_t MAX_LOG_MESSAGES = 25;
+    static constexpr size_t MAX_LOG_MESSAGES  = 25;
+    static constexpr size_t MAX_FRAME_SIZE    = 2048; // max. bytes of log events sent to the clients in one write
+    static constexpr size_t MAX_CLIENT_FRAMES = 16;   // frames queued on a client before it is skipped
     // static constexpr size_t REFRESH_SYNC     = 30;
 
     WebLogService(AsyncWebServer * server, SecurityManager * securityManager);
@@ -45,33 +47,40 @@ class WebLogService : public uuid::log::Handler {
     void             loop();
     void             show(Shell & shell);
 
-    virtual void operator<<(std::shared_ptr<uuid::log::Message> message);
-
+// make all functions public so we can test in the debug and standalone mode
+#ifndef EMSESP_STANDALONE
   private:
-    AsyncEventSource events_;
-
-    class QueuedLogMessage {
-      public:
-        QueuedLogMessage(unsigned long id, std::shared_ptr<uuid::log::Message> && content);
-        ~QueuedLogMessage() = default;
-
-        unsigned long                                   id_;      // Sequential identifier for this log message
-        struct timeval                                  time_;    // Time message was received
-        const std::shared_ptr<const uuid::log::Message> content_; // Log message content
+#endif
+    // statistics of a connected web log client
+    struct LogClient {
+        AsyncEventSourceClient * client;
+        size_t                   lag;     // frames waiting in the client queue
+        size_t                   max_lag; // highest lag seen
+        uint32_t                 sent;    // messages queued to the client
+        uint32_t                 dropped; // messages skipped because the client was too slow
     };
 
-    void transmit(const QueuedLogMessage & message);
+    AsyncEventSource events_;
+
+    bool append_message(const uuid::log::Message & message);
+    bool append_text(const char * text);
+    bool append_escaped(const char * text);
+    void transmit(size_t messages);
+    void update_clients();
     void getSetValues(AsyncWebServerRequest * request, JsonVariant json);
 
     char * messagetime(char * out, const uint64_t t, const size_t bufsize);
 
-    size_t                       maximum_log_messages_ = MAX_LOG_MESSAGES; // Maximum number of log messages to buffer before they are output
-    size_t                       limit_log_messages_   = 1;                // dynamic limit
-    unsigned long                log_message_id_       = 0;                // The next identifier to use for queued log messages
-    unsigned long                log_message_id_tail_  = 0;                // last event shown on the screen after fetch
-    std::deque<QueuedLogMessage> log_messages_;                            // Queued log messages, in the order they were received
-    time_t                       time_offset_ = 0;
-    bool                         compact_     = true;
+    void update_time_offset();
+
+    size_t                 maximum_log_messages_ = MAX_LOG_MESSAGES; // Number of recent log messages to send when the log is opened
+    uuid::log::Message     log_message_;                             // Log message read from the log ring
+    bool                   log_message_pending_ = false;             // log_message_ did not fit in the last frame
+    std::vector<char>      frame_;                                   // SSE events sent to the clients in one write
+    size_t                 frame_length_ = 0;
+    std::vector<LogClient> log_clients_;
+    time_t                 time_offset_ = 0;
+    bool                   compact_     = true;
 };
 
 } // namespace emsesp
@@ -86,19 +86,24 @@ StateUpdateResult WebScheduler::update(JsonObject root, WebScheduler & webSchedu
         si.elapsed_min = Helpers::string2minutes(si.time);
         si.retry_cnt   = 0xFF; // no startup retries
 
-        webScheduler.scheduleItems.push_back(si); // add to list
+        // compile the condition once, it's evaluated on changes of its entities or every 10 seconds
+        if (si.flags == SCHEDULEFLAG_SCHEDULE_CONDITION) {
+            si.condition.compile(si.time);
+        }
+
+        webScheduler.scheduleItems.push_back(std::move(si)); // add to list
         if (!webScheduler.scheduleItems.back().name.empty()) {
+            const auto & name = webScheduler.scheduleItems.back().name;
             Command::add(
                 EMSdevice::DeviceType::SCHEDULER,
-                webScheduler.scheduleItems.back().name.c_str(),
-                [webScheduler](const char * value, const int8_t id) {
-                    return EMSESP::webSchedulerService.command_setvalue(value, id, webScheduler.scheduleItems.back().name.c_str());
-                },
+                name.c_str(),
+                [name](const char * value, const int8_t id) { return EMSESP::webSchedulerService.command_setvalue(value, id, name.c_str()); },
                 FL_(schedule_cmd),
                 CommandFlag::ADMIN_ONLY);
         }
     }
 
+    EMSESP::webSchedulerService.dependencies_rebuild(webScheduler.scheduleItems);
     EMSESP::webSchedulerService.publish(true);
 
     return StateUpdateResult::CHANGED;
@@ -117,7 +122,8 @@ bool WebSchedulerService::command_setvalue(const char * value, const int8_t id,
                 return true;
             }
 
-            scheduleItem.active = v;
+            scheduleItem.active  = v;
+            scheduleItem.pending = v;
             publish_single(name, v);
 
             if (EMSESP::mqtt_.get_publish_onchange(0)) {
@@ -407,35 +413,109 @@ bool WebSchedulerService::command(const char * name, const std::string & command
     return false;
 }
 
-// called from emsesp.cpp on every entity-change
-// queue schedules to be handled executed in scheduler-loop
-bool WebSchedulerService::onChange(const char * cmd) {
-    for (ScheduleItem & scheduleItem : *scheduleItems_) {
-        if (scheduleItem.active && scheduleItem.flags == SCHEDULEFLAG_SCHEDULE_ONCHANGE
-            && Helpers::toLower(scheduleItem.time).find(Helpers::toLower(cmd)) != std::string::npos) {
-            cmd_changed_.push_back(&scheduleItem);
-            return true;
+// index the entities the onChange and condition schedules depend on, called when the schedules are loaded
+// onChange schedules list one or more entity paths, separated by spaces, commas or semicolons
+// conditions that read entities not reporting changes, or that can't be compiled, are left to the 10 second check
+void WebSchedulerService::dependencies_rebuild(std::list<ScheduleItem> & scheduleItems) {
+    cmd_changed_.clear(); // the queued schedules are gone
+    dependencies_.clear();
+
+    std::vector<std::string> paths;
+    for (ScheduleItem & scheduleItem : scheduleItems) {
+        paths.clear();
+        if (scheduleItem.flags == SCHEDULEFLAG_SCHEDULE_ONCHANGE) {
+            size_t start = 0;
+            while (start < scheduleItem.time.length()) {
+                auto end = scheduleItem.time.find_first_of(" ,;", start);
+                if (end == std::string::npos) {
+                    end = scheduleItem.time.length();
+                }
+                auto path = scheduleItem.time.substr(start, end - start);
+                if (!strncasecmp(path.c_str(), "api/", 4)) {
+                    path.erase(0, 4);
+                }
+                if (path.length() > 6 && !strcasecmp(path.c_str() + path.length() - 6, "/value")) {
+                    path.erase(path.length() - 6);
+                }
+                if (!path.empty() && std::find(paths.begin(), paths.end(), path) == paths.end()) {
+                    paths.push_back(std::move(path));
+                }
+                start = end + 1;
+            }
+        } else if (scheduleItem.flags == SCHEDULEFLAG_SCHEDULE_CONDITION) {
+            scheduleItem.reactive = scheduleItem.condition.dependencies(paths);
+            scheduleItem.pending  = true; // evaluate once at start
+            if (!scheduleItem.reactive) {
+                continue;
+            }
+        }
+        for (auto & path : paths) {
+            auto name = strrchr(path.c_str(), '/');
+            auto hash = Command::cmd_hash(0, name ? name + 1 : path.c_str());
+            dependencies_.push_back({&scheduleItem, std::move(path), hash});
         }
     }
-    return false;
+
+    dependency_index_.clear();
+    if (!dependencies_.empty()) {
+        dependency_index_.rebuild(dependencies_.size(), [&](uint16_t i) { return dependencies_[i].hash; });
+    }
 }
 
-// handle condition schedules, parse string stored in schedule.time field
-void WebSchedulerService::condition() {
-    for (ScheduleItem & scheduleItem : *scheduleItems_) {
-        if (scheduleItem.active && scheduleItem.flags == SCHEDULEFLAG_SCHEDULE_CONDITION) {
-            auto match = compute(scheduleItem.time);
-#ifdef EMESESP_DEBUG
-            // emsesp::EMSESP::logger().debug("condition match: %s", match.c_str());
-#endif
-            if (match.length() == 1 && match[0] == '1' && scheduleItem.retry_cnt == 0xFF) {
-                scheduleItem.retry_cnt = command(scheduleItem.name.c_str(), scheduleItem.cmd, compute(scheduleItem.value)) ? 1 : 0xFF;
-            } else if (match.length() == 1 && match[0] == '0' && scheduleItem.retry_cnt == 1) {
-                scheduleItem.retry_cnt = 0xFF;
-            } else if (match.length() != 1) { // the match is not boolean
-                emsesp::EMSESP::logger().debug("condition result: %s", match.c_str());
+// called from emsesp.cpp on every entity-change, cmd is <device>/[<hc>/]<entity>
+// queue the onChange schedules on this entity to be executed, and mark the conditions using it to be evaluated in the scheduler-loop
+bool WebSchedulerService::onChange(const char * cmd) {
+    if (dependency_index_.empty()) {
+        return false;
+    }
+
+    auto name  = strrchr(cmd, '/');
+    name       = name ? name + 1 : cmd;
+    auto hash  = Command::cmd_hash(0, name);
+    bool found = false;
+    dependency_index_.find(hash, [&](uint16_t i) {
+        const auto & dependency = dependencies_[i];
+        if (dependency.hash != hash || !dependency.item->active) {
+            return false;
+        }
+        if (dependency.item->flags == SCHEDULEFLAG_SCHEDULE_ONCHANGE) {
+            if (!strcasecmp(dependency.path.c_str(), cmd)) {
+                cmd_changed_.push_back(dependency.item);
+                found = true;
+            }
+        } else {
+            // a condition entity may leave out the hc, so only match the device and entity name
+            auto device = dependency.path.find('/') + 1;
+            auto entity = dependency.path.rfind('/') + 1;
+            if (!strncasecmp(dependency.path.c_str(), cmd, device) && !strcasecmp(dependency.path.c_str() + entity, name)) {
+                dependency.item->pending = true;
+                found                    = true;
             }
         }
+        return false; // all schedules on this entity
+    });
+    return found;
+}
+
+// handle a condition schedule, using the compiled condition or else parsing the string stored in schedule.time field
+void WebSchedulerService::condition(ScheduleItem & scheduleItem) {
+    int8_t match = -1;
+    if (scheduleItem.condition.compiled()) {
+        match = scheduleItem.condition.evaluate();
+    } else {
+        auto result = compute(scheduleItem.time);
+        if (result.length() == 1 && (result[0] == '0' || result[0] == '1')) {
+            match = result[0] - '0';
+        }
+    }
+    scheduleItem.failed = false;
+    if (match == 1 && scheduleItem.retry_cnt == 0xFF) {
+        scheduleItem.retry_cnt = command(scheduleItem.name.c_str(), scheduleItem.cmd, compute(scheduleItem.value)) ? 1 : 0xFF;
+        scheduleItem.failed    = (scheduleItem.retry_cnt == 0xFF);
+    } else if (match == 0 && scheduleItem.retry_cnt == 1) {
+        scheduleItem.retry_cnt = 0xFF;
+    } else if (match < 0) { // the match is not boolean
+        UUID_LOG_LAZY(EMSESP::logger(), Level::DEBUG, debug, "condition result: %s", compute(scheduleItem.time).c_str());
     }
 }
 
@@ -453,7 +533,7 @@ void WebSchedulerService::loop() {
 
     // check if we have onChange events
     while (!cmd_changed_.empty()) {
-        ScheduleItem si = *cmd_changed_.front();
+        const ScheduleItem & si = *cmd_changed_.front();
         command(si.name.c_str(), si.cmd, compute(si.value));
         cmd_changed_.pop_front();
     }
@@ -465,10 +545,17 @@ void WebSchedulerService::loop() {
         }
     }
 
-    // check conditions every 10 seconds, start after one minute
+    // check conditions when their entities change or else every 10 seconds, start after one minute
+    // a reactive condition whose command failed is also checked every 10 seconds, to retry the command
     uint32_t uptime_sec = uuid::get_uptime_sec() / 10;
-    if (last_uptime_sec != uptime_sec && uptime_sec > 5) {
-        condition();
+    if (uptime_sec > 5) {
+        for (ScheduleItem & scheduleItem : *scheduleItems_) {
+            if (scheduleItem.active && scheduleItem.flags == SCHEDULEFLAG_SCHEDULE_CONDITION
+                && ((scheduleItem.reactive && scheduleItem.pending) || ((!scheduleItem.reactive || scheduleItem.failed) && last_uptime_sec != uptime_sec))) {
+                scheduleItem.pending = false;
+                condition(scheduleItem);
+            }
+        }
         last_uptime_sec = uptime_sec;
     }
 
@@ -531,8 +618,354 @@ void WebSchedulerService::scheduler_task(void * pvParameters) {
 #endif
 }
 
+// compile a condition to RPN with entities bound, like calculate() without substituting the values
+// expressions with ternaries or url requests, or that can't be compiled, are left to compute()
+bool ScheduleCondition::compile(const std::string & expr) {
+    ops_.clear();
+    literals_.clear();
+    entities_.clear();
+
+    if (!parse(expr)) {
+        ops_.clear();
+        literals_.clear();
+        entities_.clear();
+        return false;
+    }
+    return true;
+}
+
+bool ScheduleCondition::parse(const std::string & expr) {
+    auto expr_new = emsesp::Helpers::toLower(expr);
+    if (expr_new.find_first_of("?{") != std::string::npos) {
+        return false;
+    }
+
+    // replace the entities, found in the same way as in commands(), with a placeholder
+    for (uint8_t device = 0; device < emsesp::EMSdevice::DeviceType::UNKNOWN; device++) {
+        const char * d = emsesp::EMSdevice::device_type_2_device_name(device);
+        auto         f = expr_new.find(d);
+        while (f != std::string::npos) {
+            auto e = expr_new.find_first_not_of("/._abcdefghijklmnopqrstuvwxyz0123456789", f);
+            if (e == std::string::npos) {
+                e = expr_new.length();
+            }
+            while (e > 0 && expr_new[e - 1] == ' ') {
+                e--;
+            }
+            if (e - f >= COMMAND_MAX_LENGTH - 1 || entities_.size() >= 0xFE) {
+                return false;
+            }
+
+            Entity entity;
+            entity.path = "api/" + expr_new.substr(f, e - f);
+            if (entity.path.find("/value") == std::string::npos) {
+                entity.path += "/value";
+            }
+            entity.bindable  = false;
+            entity.unique_id = 0;
+            entity.index     = -1;
+            entity.id        = -1;
+
+            // EMS device entities <device>/[<hc>/]<entity>/value are read directly
+            auto slash         = entity.path.find('/', 4);
+            entity.device_type = emsesp::EMSdevice::device_name_2_device_type(entity.path.substr(4, slash - 4).c_str());
+            if (entity.device_type >= emsesp::EMSdevice::DeviceType::BOILER && entity.device_type < emsesp::EMSdevice::DeviceType::UNKNOWN) {
+                const char * name = emsesp::Command::parse_command_string(entity.path.c_str() + slash + 1, entity.id);
+                const char * attr = name ? strchr(name, '/') : nullptr;
+                if (attr && !strcmp(attr, "/value")) {
+                    entity.name.assign(name, attr - name);
+                    entity.bindable = true;
+                }
+            } else if (entity.device_type == emsesp::EMSdevice::DeviceType::CUSTOM || entity.device_type == emsesp::EMSdevice::DeviceType::TEMPERATURESENSOR
+                       || entity.device_type == emsesp::EMSdevice::DeviceType::ANALOGSENSOR) {
+                // custom entities and sensors <device>/<name>/value
+                auto attr = entity.path.find('/', slash + 1);
+                if (attr != std::string::npos && !entity.path.compare(attr, std::string::npos, "/value")) {
+                    entity.name     = entity.path.substr(slash + 1, attr - slash - 1);
+                    entity.bindable = true;
+                }
+            }
+
+            entities_.push_back(std::move(entity));
+            expr_new.replace(f, e - f, std::string{'\x01', (char)entities_.size()});
+            f = expr_new.find(d, f + 2);
+        }
+    }
+
+    const auto tokens = exprToTokens(expr_new);
+    if (tokens.empty()) {
+        return false;
+    }
+    auto queue = shuntingYard(tokens);
+    if (queue.empty()) {
+        return false;
+    }
+
+    // convert to ops, and check the stack depth
+    uint8_t depth = 0;
+    for (const auto & token : queue) {
+        switch (token.type) {
+        case Token::Type::Number:
+        case Token::Type::String:
+            if (token.str.find('\x01') != std::string::npos || literals_.size() >= 0xFF) {
+                return false; // entity inside a quoted string
+            }
+            literals_.push_back({token.str, isnum(token.str)});
+            ops_.push_back({OpType::Literal, 0, (uint8_t)(literals_.size() - 1)});
+            depth++;
+            break;
+        case Token::Type::Entity:
+            ops_.push_back({OpType::Entity, 0, (uint8_t)(token.str[0] - 1)});
+            depth++;
+            break;
+        case Token::Type::Unary:
+            if (depth < 1) {
+                return false;
+            }
+            ops_.push_back({OpType::Unary, token.str[0], 0});
+            break;
+        case Token::Type::Compare:
+        case Token::Type::Logic:
+        case Token::Type::Operator:
+            if (depth < 2) {
+                return false;
+            }
+            ops_.push_back({token.type == Token::Type::Compare ? OpType::Compare : token.type == Token::Type::Logic ? OpType::Logic : OpType::Operator,
+                            token.str[0],
+                            0});
+            depth--;
+            break;
+        case Token::Type::LeftParen:
+        case Token::Type::RightParen:
+        case Token::Type::Unknown:
+        default:
+            return false;
+        }
+        if (depth > MAX_DEPTH) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// the entities the condition reads, as <device>/<entity> in the way onChange() reports a changed value
+// returns false if one of them doesn't report changes, like system values or attributes other than the value
+bool ScheduleCondition::dependencies(std::vector<std::string> & paths) const {
+    for (const auto & entity : entities_) {
+        if (!entity.bindable) {
+            return false;
+        }
+        paths.push_back(std::string(emsesp::EMSdevice::device_type_2_device_name(entity.device_type)) + "/" + entity.name);
+    }
+    return compiled();
+}
+
+// current value of an entity, reading bound EMS device values, custom entities and sensors directly
+const char * ScheduleCondition::entity_value(Entity & entity) {
+    if (entity.bindable) {
+        switch (entity.device_type) {
+        case emsesp::EMSdevice::DeviceType::CUSTOM:
+            return emsesp::EMSESP::webCustomEntityService.get_value_string(entity.name.c_str(), entity.index, entity.buf, sizeof(entity.buf));
+        case emsesp::EMSdevice::DeviceType::TEMPERATURESENSOR:
+            return emsesp::EMSESP::temperaturesensor_.get_value_string(entity.name.c_str(), entity.index, entity.buf, sizeof(entity.buf));
+        case emsesp::EMSdevice::DeviceType::ANALOGSENSOR:
+            return emsesp::EMSESP::analogsensor_.get_value_string(entity.name.c_str(), entity.index, entity.buf, sizeof(entity.buf));
+        default:
+            break;
+        }
+        for (const auto & emsdevice : emsesp::EMSESP::emsdevices) {
+            if (emsdevice->unique_id() == entity.unique_id) {
+                return emsdevice->get_value_string(entity.index, entity.buf, sizeof(entity.buf));
+            }
+        }
+        // not bound yet, or the device is gone
+        for (const auto & emsdevice : emsesp::EMSESP::emsdevices) {
+            if (emsdevice->device_type() == entity.device_type) {
+                auto index = emsdevice->find_device_value(entity.name.c_str(), entity.id);
+                if (index >= 0) {
+                    entity.unique_id = emsdevice->unique_id();
+                    entity.index     = index;
+                    return emsdevice->get_value_string(entity.index, entity.buf, sizeof(entity.buf));
+                }
+            }
+        }
+        return nullptr;
+    }
+
+    JsonDocument doc_out;
+    JsonDocument doc_in;
+    JsonObject   output = doc_out.to<JsonObject>();
+    JsonObject   input  = doc_in.to<JsonObject>();
+    emsesp::Command::process(entity.path.c_str(), true, input, output);
+    if (!output["api_data"].is<std::string>()) {
+        return nullptr;
+    }
+    entity.value = output["api_data"].as<std::string>();
+    return entity.value.c_str();
+}
+
+// evaluate the compiled condition, same results as calculate() on the expression
+int8_t ScheduleCondition::evaluate() {
+    struct Value {
+        const char * str;
+        char         buf[32];
+    };
+    Value   stack[MAX_DEPTH];
+    uint8_t n = 0;
+
+    // store a calculated number as its string, like to_string()
+    auto set_number = [](Value & v, double d) {
+        snprintf(v.buf, sizeof(v.buf), "%f", d);
+        auto l = strlen(v.buf);
+        while (l && v.buf[l - 1] == '0') {
+            v.buf[--l] = '\0';
+        }
+        if (l && v.buf[l - 1] == '.') {
+            v.buf[--l] = '\0';
+        }
+        v.str = v.buf;
+    };
+
+    for (const auto & op : ops_) {
+        switch (op.type) {
+        case OpType::Literal:
+            stack[n++].str = literals_[op.arg].str.c_str();
+            break;
+
+        case OpType::Entity:
+            stack[n].str = entity_value(entities_[op.arg]);
+            if (stack[n++].str == nullptr) {
+                return -1;
+            }
+            break;
+
+        case OpType::Unary: {
+            auto & rhs = stack[n - 1];
+            if (op.op == 'm') {
+                if (!isnum(rhs.str)) {
+                    return -1;
+                }
+                set_number(rhs, -1 * strtod(rhs.str, nullptr));
+            } else if (op.op == '!') {
+                auto l = to_logic(rhs.str);
+                if (l < 0) {
+                    return -1;
+                }
+                rhs.str = l == 0 ? "1" : "0";
+            } else {
+                return -1;
+            }
+        } break;
+
+        case OpType::Compare: {
+            auto & rhs = stack[--n];
+            auto & lhs = stack[n - 1];
+            int    cmp;
+            if (isnum(rhs.str) && isnum(lhs.str)) {
+                auto l = strtod(lhs.str, nullptr);
+                auto r = strtod(rhs.str, nullptr);
+                cmp    = (l < r) ? -1 : (l > r) ? 1 : 0;
+            } else {
+                cmp = strcmp(lhs.str, rhs.str);
+            }
+            bool result;
+            switch (op.op) {
+            case '<':
+                result = cmp < 0;
+                break;
+            case '{':
+                result = cmp <= 0;
+                break;
+            case '>':
+                result = cmp > 0;
+                break;
+            case '}':
+                result = cmp >= 0;
+                break;
+            case '=':
+                result = cmp == 0;
+                break;
+            case '!':
+                result = cmp != 0;
+                break;
+            default:
+                return -1;
+            }
+            lhs.str = result ? "1" : "0";
+        } break;
+
+        case OpType::Logic: {
+            auto rhs = to_logic(stack[--n].str);
+            auto lhs = to_logic(stack[n - 1].str);
+            if (rhs < 0 || lhs < 0) {
+                return -1;
+            }
+            if (op.op == '&') {
+                stack[n - 1].str = (lhs && rhs) ? "1" : "0";
+            } else if (op.op == '|') {
+                stack[n - 1].str = (lhs || rhs) ? "1" : "0";
+            } else {
+                return -1;
+            }
+        } break;
+
+        case OpType::Operator: {
+            if (!isnum(stack[n - 1].str) || !isnum(stack[n - 2].str)) {
+                return -1;
+            }
+            auto rhs = strtod(stack[--n].str, nullptr);
+            auto lhs = strtod(stack[n - 1].str, nullptr);
+            switch (op.op) {
+            case '^':
+                set_number(stack[n - 1], pow(lhs, rhs));
+                break;
+            case '*':
+                set_number(stack[n - 1], lhs * rhs);
+                break;
+            case '/':
+                set_number(stack[n - 1], lhs / rhs);
+                break;
+            case '%':
+                if (static_cast<int>(rhs) == 0) {
+                    return -1;
+                }
+                snprintf(stack[n - 1].buf, sizeof(stack[n - 1].buf), "%d", static_cast<int>(lhs) % static_cast<int>(rhs));
+                stack[n - 1].str = stack[n - 1].buf;
+                break;
+            case '+':
+                set_number(stack[n - 1], lhs + rhs);
+                break;
+            case '-':
+                set_number(stack[n - 1], lhs - rhs);
+                break;
+            default:
+                return -1;
+            }
+        } break;
+        }
+    }
+
+    // the values on the stack are concatenated, the result must be a single '0' or '1'
+    char result = '\0';
+    for (uint8_t i = 0; i < n; i++) {
+        for (const char * c = stack[i].str; *c; c++) {
+            if (result) {
+                return -1;
+            }
+            result = *c;
+        }
+    }
+    return (result == '1') ? 1 : (result == '0') ? 0 : -1;
+}
+
 // hard coded tests
 #if defined(EMSESP_TEST)
+// evaluate an expression without compiling, to compare with ScheduleCondition
+std::string WebSchedulerService::test_compute(const std::string & expr) {
+    return compute(expr);
+}
+
 void WebSchedulerService::test() {
     static bool already_added = false;
     if (!already_added) {
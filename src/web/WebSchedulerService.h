@@ -19,6 +19,8 @@
 #ifndef WebSchedulerService_h
 #define WebSchedulerService_h
 
+#include "../helpers.h"
+
 #define EMSESP_SCHEDULER_FILE "/config/emsespScheduler.json"
 #define EMSESP_SCHEDULER_SERVICE_PATH "/rest/schedule" // GET and POST
 
@@ -37,6 +39,56 @@
 
 namespace emsesp {
 
+// a condition expression compiled to RPN when the schedule is loaded, with the same operators as shuntingYard.hpp
+// entity references are bound to the device, custom entity or sensor value, so evaluating it doesn't parse or allocate
+// only system values are still read through the api
+class ScheduleCondition {
+  public:
+    static constexpr uint8_t MAX_DEPTH = 10; // max. values on the evaluation stack
+
+    bool   compile(const std::string & expr);
+    int8_t evaluate(); // 1 true, 0 false, -1 if the result is not a boolean or an entity has no value
+
+    bool compiled() const {
+        return !ops_.empty();
+    }
+
+    bool dependencies(std::vector<std::string> & paths) const;
+
+  private:
+    enum class OpType : uint8_t { Literal, Entity, Unary, Compare, Logic, Operator };
+
+    struct Op {
+        OpType  type;
+        char    op;  // operator character, as in the shunting yard tokens
+        uint8_t arg; // position in literals_ or entities_
+    };
+
+    struct Literal {
+        std::string str;
+        bool        num;
+    };
+
+    struct Entity {
+        uint8_t     device_type;
+        int8_t      id;        // hc/dhw/..., -1 for any
+        std::string name;      // lowercase entity name without attribute, for the bindable ones
+        std::string path;      // full api path, for anything that can't be bound
+        bool        bindable;  // an EMS device entity, custom entity or sensor we can read directly
+        uint8_t     unique_id; // bound EMS device, 0 if not yet bound
+        int16_t     index;     // bound position in the device's values, the custom entities or the sensors
+        std::string value;     // last value read through the api path
+        char        buf[32];   // fits an analog sensor's double
+    };
+
+    bool         parse(const std::string & expr);
+    const char * entity_value(Entity & entity);
+
+    std::vector<Op>      ops_;
+    std::vector<Literal> literals_;
+    std::vector<Entity>  entities_;
+};
+
 class ScheduleItem {
   public:
     boolean     active;
@@ -47,6 +99,11 @@ class ScheduleItem {
     std::string value;
     std::string name;
     uint8_t     retry_cnt;
+
+    ScheduleCondition condition;        // compiled from time for condition schedules
+    bool              reactive = false; // condition is evaluated when one of its entities changes, instead of every 10 seconds
+    bool              pending  = false; // reactive condition to be evaluated in the next loop
+    bool              failed   = false; // the condition's command failed, retried every 10 seconds until it succeeds or the condition is false
 };
 
 class WebScheduler {
@@ -73,9 +130,11 @@ class WebSchedulerService : public StatefulService<WebScheduler> {
     }
     uint8_t count_entities(bool cmd_only = false);
     bool    onChange(const char * cmd);
+    void    dependencies_rebuild(std::list<ScheduleItem> & scheduleItems);
 
 #if defined(EMSESP_TEST)
-    void test();
+    void        test();
+    std::string test_compute(const std::string & expr);
 #endif
 
 // make all functions public so we can test in the debug and standalone mode
@@ -85,7 +144,14 @@ class WebSchedulerService : public StatefulService<WebScheduler> {
     static void scheduler_task(void * pvParameters);
 
     bool command(const char * name, const std::string & cmd, const std::string & data);
-    void condition();
+    void condition(ScheduleItem & scheduleItem);
+
+    // an entity path (<device>/[<hc>/]<entity>) an onChange or condition schedule depends on
+    struct Dependency {
+        ScheduleItem * item;
+        std::string    path;
+        uint32_t       hash; // of the last part of the path, see Command::cmd_hash()
+    };
 
     HttpEndpoint<WebScheduler>  _httpEndpoint;
     FSPersistence<WebScheduler> _fsPersistence;
@@ -93,6 +159,10 @@ class WebSchedulerService : public StatefulService<WebScheduler> {
     std::list<ScheduleItem> *  scheduleItems_; // pointer to the list of schedule events
     bool                       ha_registered_ = false;
     std::deque<ScheduleItem *> cmd_changed_;
+
+    // hashed on the entity name, built when the schedules are loaded
+    std::vector<Dependency> dependencies_;
+    HashIndex               dependency_index_;
 };
 
 } // namespace emsesp
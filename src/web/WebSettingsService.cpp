@@ -38,6 +38,7 @@ void WebSettings::read(WebSettings & settings, JsonObject root) {
     root["locale"]                = settings.locale;
     root["tx_mode"]               = settings.tx_mode;
     root["ems_bus_id"]            = settings.ems_bus_id;
+    root["fetch_budget"]          = settings.fetch_budget;
     root["syslog_enabled"]        = settings.syslog_enabled;
     root["syslog_level"]          = settings.syslog_level;
     root["trace_raw"]             = settings.trace_raw;
@@ -80,6 +81,7 @@ void WebSettings::read(WebSettings & settings, JsonObject root) {
     root["modbus_port"]           = settings.modbus_port;
     root["modbus_max_clients"]    = settings.modbus_max_clients;
     root["modbus_timeout"]        = settings.modbus_timeout;
+    root["modbus_strict"]         = settings.modbus_strict;
 }
 
 // call on initialization and also when settings are updated via web or console
@@ -298,6 +300,10 @@ StateUpdateResult WebSettings::update(JsonObject root, WebSettings & settings) {
     settings.ems_bus_id = root["ems_bus_id"] | EMSESP_DEFAULT_EMS_BUS_ID;
     check_flag(prev, settings.ems_bus_id, ChangeFlags::RESTART);
 
+    prev                  = settings.fetch_budget;
+    settings.fetch_budget = root["fetch_budget"] | EMSESP_DEFAULT_FETCH_BUDGET;
+    check_flag(prev, settings.fetch_budget, ChangeFlags::UART);
+
     prev               = settings.low_clock;
     settings.low_clock = root["low_clock"];
     check_flag(prev, settings.low_clock, ChangeFlags::RESTART);
@@ -318,6 +324,10 @@ StateUpdateResult WebSettings::update(JsonObject root, WebSettings & settings) {
     settings.modbus_timeout = root["modbus_timeout"] | EMSESP_DEFAULT_MODBUS_TIMEOUT;
     check_flag(prev, settings.modbus_timeout, ChangeFlags::RESTART);
 
+    prev                   = settings.modbus_strict;
+    settings.modbus_strict = root["modbus_strict"] | EMSESP_DEFAULT_MODBUS_STRICT;
+    check_flag(prev, settings.modbus_strict, ChangeFlags::RESTART);
+
     //
     // these may need mqtt restart to rebuild HA discovery topics
     //
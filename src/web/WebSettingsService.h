@@ -34,6 +34,7 @@ class WebSettings {
     String   locale;
     uint8_t  tx_mode;
     uint8_t  ems_bus_id;
+    uint8_t  fetch_budget;
     bool     boiler_heatingoff;
     uint8_t  remote_timeout;
     bool     remote_timeout_enabled;
@@ -73,6 +74,7 @@ class WebSettings {
     uint16_t modbus_port;
     uint8_t  modbus_max_clients;
     uint32_t modbus_timeout;
+    bool     modbus_strict;
 
     uint8_t phy_type;
     int8_t  eth_power; // -1 means disabled
@@ -151,13 +151,19 @@ void WebStatusService::systemStatus(AsyncWebServerRequest * request) {
 
 // generic action handler - as a POST
 void WebStatusService::action(AsyncWebServerRequest * request, JsonVariant json) {
-    auto *     response = new AsyncJsonResponse();
-    JsonObject root     = response->getRoot();
-
     // get action and any optional param
     std::string action = json["action"];
     std::string param  = json["param"]; // is optional
 
+    // all values are streamed, without a large return buffer
+    if (action == "export" && param == "allvalues") {
+        allvalues(request);
+        return;
+    }
+
+    auto *     response = new AsyncJsonResponse();
+    JsonObject root     = response->getRoot();
+
     // check if we're authenticated for admin tasks, some actions are only for admins
     Authentication authentication = _securityManager->authenticateRequest(request);
     bool           is_admin       = AuthenticationPredicates::IS_ADMIN(authentication);
@@ -173,10 +179,6 @@ void WebStatusService::action(AsyncWebServerRequest * request, JsonVariant json)
         ok = uploadURL(param.c_str());
     }
 
-#if defined(EMSESP_UNITY)
-    // store the result so we can test with Unity later
-    storeResponse(output);
-#endif
 #if defined(EMSESP_STANDALONE) && !defined(EMSESP_UNITY)
     Serial.printf("%sweb output: %s[%s]", COLOR_WHITE, COLOR_BRIGHT_CYAN, request->url().c_str());
     Serial.printf(" %s(%d)%s ", ok ? COLOR_BRIGHT_GREEN : COLOR_BRIGHT_RED, ok ? 200 : 400, COLOR_YELLOW);
@@ -209,32 +211,48 @@ bool WebStatusService::checkUpgrade(JsonObject root, std::string & latest_versio
     return true;
 }
 
-// action = allvalues
-// output all the devices and the values
-void WebStatusService::allvalues(JsonObject output) {
-    JsonObject device_output;
-    auto       value = F_(values);
+// action = export, param = allvalues
+// output all the devices and the values, as a chunked response with a part for each tag of a device
+void WebStatusService::allvalues(AsyncWebServerRequest * request) {
+    constexpr size_t tags = DeviceValueTAG::TAG_HS16 + 1;
 
-    // EMS-Device Entities
+    // the titles are taken now, the values when the part is sent
+    std::vector<std::pair<std::string, uint8_t>> devices;
     for (const auto & emsdevice : EMSESP::emsdevices) {
-        std::string title = emsdevice->device_type_2_device_name_translated() + std::string(" ") + emsdevice->to_string();
-        device_output     = output[title].to<JsonObject>();
-        emsdevice->get_value_info(device_output, value, DeviceValueTAG::TAG_NONE);
+        devices.emplace_back(emsdevice->device_type_2_device_name_translated() + std::string(" ") + emsdevice->to_string(), emsdevice->device_type());
     }
 
-    // Custom Entities
-    device_output = output["Custom Entities"].to<JsonObject>();
-    EMSESP::webCustomEntityService.get_value_info(device_output, value);
+    WebStreamResponse::send(request, devices.size() * tags + 4, [devices, tags](size_t part, JsonObject output) -> std::string {
+        auto value = F_(values);
+
+        // EMS-Device Entities, same as get_value_info() with all tags
+        if (part < devices.size() * tags) {
+            const auto & device = devices[part / tags];
+            EMSdevice::export_values_tag(device.second, output, part % tags, EMSdevice::OUTPUT_TARGET::API_SHORTNAMES);
+            return device.first;
+        }
 
-    // Scheduler
-    device_output = output["Scheduler"].to<JsonObject>();
-    EMSESP::webSchedulerService.get_value_info(device_output, value);
+        switch (part - devices.size() * tags) {
+        case 0:
+            EMSESP::webCustomEntityService.get_value_info(output, value);
+            return "Custom Entities";
+        case 1:
+            EMSESP::webSchedulerService.get_value_info(output, value);
+            return "Scheduler";
+        case 2:
+            EMSESP::analogsensor_.get_value_info(output, value);
+            return "Analog Sensors";
+        default:
+            EMSESP::temperaturesensor_.get_value_info(output, value);
+            return "Temperature Sensors";
+        }
+    });
 
-    // Sensors
-    device_output = output["Analog Sensors"].to<JsonObject>();
-    EMSESP::analogsensor_.get_value_info(device_output, value);
-    device_output = output["Temperature Sensors"].to<JsonObject>();
-    EMSESP::temperaturesensor_.get_value_info(device_output, value);
+#if defined(EMSESP_STANDALONE) && !defined(EMSESP_UNITY)
+    Serial.printf("%sweb output: %s[%s] %s(200)%s ", COLOR_WHITE, COLOR_BRIGHT_CYAN, request->url().c_str(), COLOR_BRIGHT_GREEN, COLOR_YELLOW);
+    Serial.print(request->chunkedContent().c_str());
+    Serial.println(COLOR_RESET);
+#endif
 }
 
 // action = export
@@ -257,9 +275,6 @@ bool WebStatusService::exportData(JsonObject root, std::string & type) {
         System::extractSettings(EMSESP_CUSTOMIZATION_FILE, "Customizations", root);
     } else if (type == "entities") {
         System::extractSettings(EMSESP_CUSTOMENTITY_FILE, "Entities", root);
-    } else if (type == "allvalues") {
-        root.clear(); // don't need the "type" key added to the output
-        allvalues(root);
     } else {
         return false;
     }
@@ -28,7 +28,7 @@ class WebStatusService {
     bool customSupport(JsonObject root);
     bool uploadURL(const char * url);
 
-    void allvalues(JsonObject output);
+    void allvalues(AsyncWebServerRequest * request);
 };
 
 } // namespace emsesp
@@ -0,0 +1,140 @@
+/*
+ * EMS-ESP - https://github.com/emsesp/EMS-ESP
+ * Copyright 2020-2024  emsesp.org - proddy, MichaelDvP
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "emsesp.h"
+
+namespace emsesp {
+
+// ArduinoJson writer which only keeps the bytes from position skip on that fit in the buffer
+class WindowWriter {
+  public:
+    WindowWriter(uint8_t * buffer, size_t skip, size_t size)
+        : buffer_(buffer)
+        , skip_(skip)
+        , size_(size) {
+    }
+
+    size_t write(uint8_t c) {
+        if (pos_ >= skip_ && pos_ - skip_ < size_) {
+            buffer_[pos_ - skip_] = c;
+        }
+        pos_++;
+        return 1;
+    }
+
+    size_t write(const uint8_t * s, size_t n) {
+        for (size_t i = 0; i < n; i++) {
+            write(s[i]);
+        }
+        return n;
+    }
+
+  private:
+    uint8_t * buffer_;
+    size_t    skip_;
+    size_t    size_;
+    size_t    pos_ = 0;
+};
+
+WebStreamResponse::WebStreamResponse(size_t parts, PartFunction part_function)
+    : part_function_(std::move(part_function))
+    , parts_(parts) {
+}
+
+// the async server calls this from its own task until it returns 0
+// the response keeps a shared pointer, so the stream lives until the last byte is sent or the client is gone
+void WebStreamResponse::send(AsyncWebServerRequest * request, size_t parts, PartFunction part_function) {
+    auto stream = std::make_shared<WebStreamResponse>(parts, std::move(part_function));
+    request->sendChunked("application/json; charset=utf-8",
+                         [stream](uint8_t * buffer, size_t max_len, size_t index) { return stream->fill(buffer, max_len); });
+}
+
+size_t WebStreamResponse::fill(uint8_t * buffer, size_t max_len) {
+    size_t len = 0;
+    while (len < max_len) {
+        if (pending_sent_ < pending_.size()) {
+            size_t n = std::min(pending_.size() - pending_sent_, max_len - len);
+            memcpy(buffer + len, pending_.data() + pending_sent_, n);
+            pending_sent_ += n;
+            len += n;
+        } else if (doc_sent_ < doc_length_) {
+            // serialize the part again and keep the next piece, skipping the opening brace
+            size_t       n = std::min(doc_length_ - doc_sent_, max_len - len);
+            WindowWriter writer(buffer + len, doc_sent_ + 1, n);
+            serializeJson(doc_, writer);
+            doc_sent_ += n;
+            len += n;
+        } else if (!next_part()) {
+            break;
+        }
+    }
+    return len;
+}
+
+// generates the next part, or closes the object after the last one. Returns false when all is done
+bool WebStreamResponse::next_part() {
+    if (done_) {
+        return false;
+    }
+
+    pending_.clear();
+    pending_sent_ = 0;
+    doc_length_   = 0;
+    doc_sent_     = 0;
+    doc_.clear();
+
+    if (part_ == parts_) {
+        pending_ = key_.empty() ? "}" : "}}";
+        done_    = true;
+        return true;
+    }
+
+    std::string key = part_function_(part_++, doc_.to<JsonObject>());
+    if (key != key_) {
+        if (!key_.empty()) {
+            pending_ += '}';
+        }
+        key_ = key;
+        if (!key_.empty()) {
+            if (members_) {
+                pending_ += ',';
+            }
+            members_ = true;
+            JsonDocument key_doc; // for escaping the key
+            std::string  escaped_key;
+            key_doc.set(key_);
+            serializeJson(key_doc, escaped_key);
+            pending_ += escaped_key + ":{";
+            nested_members_ = false;
+        }
+    }
+
+    size_t length = measureJson(doc_);
+    if (length > 2) {
+        bool & members = key_.empty() ? members_ : nested_members_;
+        if (members) {
+            pending_ += ',';
+        }
+        members     = true;
+        doc_length_ = length - 2;
+    }
+
+    return true;
+}
+
+} // namespace emsesp
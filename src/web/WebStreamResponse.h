@@ -0,0 +1,60 @@
+/*
+ * EMS-ESP - https://github.com/emsesp/EMS-ESP
+ * Copyright 2020-2024  emsesp.org - proddy, MichaelDvP
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef WebStreamResponse_h
+#define WebStreamResponse_h
+
+namespace emsesp {
+
+// Sends a json object as chunked response, generated part by part.
+// Each part adds some members of the object to its own small JsonDocument, which is serialized straight into the
+// buffer of the response. So only one part is in memory, regardless of how large the whole object is.
+// When the parts add different keys the output is the same as serializeJson() of one document with all the parts.
+class WebStreamResponse {
+  public:
+    // adds the members of the part to output and returns the key of the nested object they go in, "" for the top level
+    // consecutive parts with the same key go into the same nested object, which is created even if they are empty
+    using PartFunction = std::function<std::string(size_t part, JsonObject output)>;
+
+    WebStreamResponse(size_t parts, PartFunction part_function);
+
+    // fills the buffer with the next bytes of the json, returns 0 when all is sent
+    size_t fill(uint8_t * buffer, size_t max_len);
+
+    static void send(AsyncWebServerRequest * request, size_t parts, PartFunction part_function);
+
+  private:
+    bool next_part();
+
+    PartFunction part_function_;
+    size_t       parts_;
+    size_t       part_ = 0;            // next part to generate
+    JsonDocument doc_;                 // the part being sent
+    size_t       doc_length_     = 0;  // length of the members in doc_, without the braces
+    size_t       doc_sent_       = 0;  // bytes of the members already sent
+    std::string  pending_        = "{"; // braces, commas and keys to send before the members
+    size_t       pending_sent_   = 0;
+    std::string  key_;                 // key of the nested object we're in, "" for the top level
+    bool         members_        = false; // the top level object has members
+    bool         nested_members_ = false; // the nested object has members
+    bool         done_           = false;
+};
+
+} // namespace emsesp
+
+#endif
@@ -275,6 +275,37 @@ void run_manual_tests() {
     RUN_TEST(manual_test4);
 }
 
+// the streamed values of a device must be the same as the json document Command::process() builds
+void stream_test(const char * url) {
+    JsonDocument input_doc;
+    JsonDocument output_doc;
+    Command::process(url, true, input_doc.to<JsonObject>(), output_doc.to<JsonObject>());
+
+    std::string expected_response;
+    serializeJson(output_doc, expected_response);
+    expected_response = "[" + expected_response + "]";
+
+    TEST_ASSERT_EQUAL_STRING(expected_response.c_str(), call_url(url));
+}
+
+void stream_test1() {
+    stream_test("/api/boiler");
+}
+
+void stream_test2() {
+    stream_test("/api/boiler/values");
+}
+
+void stream_test3() {
+    stream_test("/api/thermostat");
+}
+
+void run_stream_tests() {
+    RUN_TEST(stream_test1);
+    RUN_TEST(stream_test2);
+    RUN_TEST(stream_test3);
+}
+
 const char * run_console_command(const char * command) {
     output_buffer[0] = '\0'; // empty the temp buffer
     shell->invoke_command(command);
@@ -436,6 +467,7 @@ int main() {
     run_tests();         // execute the generated tests
     run_manual_tests();  // execute some other manual tests from this file
     run_console_tests(); // execute some console tests
+    run_stream_tests();  // compare the streamed responses
 
     return UNITY_END();
 }